@@ -59,8 +59,18 @@ typedef struct {
   double theta;
 }ncBrainWaveLevels;
 
+/**
+ * The movement of the subject during a staging element, i.e. since
+ * the previous element.
+ */
 typedef struct {
-  // TODO
+  // the RMS of the acceleration without gravity, in g
+  double activity;
+  // the number of changes of the head position
+  int posture_changes;
+  // 1 if the movement was gross enough for the EEG to be skipped
+  // (the stage is then estimated as for a bad signal), 0 otherwise
+  int gross_movement;
 }ncMovementDescription;
 
 /**
@@ -86,4 +96,38 @@ typedef struct {
   char minute;
 }ncDayTimeInstant;
 
+// -------------------- Performance counters. ---------------------------------
+
+/**
+ * The stages of the processing whose execution times are measured.
+ * The spectrogram, the features, the MLP and the Viterbi search are parts
+ * of the algorithm steps, the sinks include the callbacks they call.
+ */
+typedef enum {
+  NC_PERF_FRAME_DECODE = 0,
+  NC_PERF_SIGNAL_APPEND = 1,
+  NC_PERF_SPECTROGRAM = 2,
+  NC_PERF_FEATURES = 3,
+  NC_PERF_MLP = 4,
+  NC_PERF_VITERBI = 5,
+  NC_PERF_SINKS = 6,
+  NC_PERF_CALLBACKS = 7,
+  NC_PERF_STAGES_COUNT = 8
+}ncPerformanceStage;
+
+/**
+ * The execution times of a stage since the start or the last reset.
+ * The percentiles are estimated from a histogram with the relative
+ * precision of 1/8, and rounded up.
+ */
+typedef struct {
+  ncPerformanceStage stage;
+  unsigned long long calls;
+  double total_ms;
+  double max_ms;
+  double p50_ms;
+  double p90_ms;
+  double p99_ms;
+}ncPerformanceStats;
+
 #endif
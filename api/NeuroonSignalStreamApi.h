@@ -51,6 +51,25 @@ typedef struct NeuroonSignalProcessingState ncNeuroonSignalProcessingState;
 typedef void (*ncStagingCallback)(const ncStagingElement *stagingData,
                                    int stagingDataSize);
 
+/**
+ * The type of the callback receiving only the changes of the sleep staging,
+ * an alternative to ncStagingCallback, see ncSetStagingDeltaCallback.
+ *
+ * The elements of the staging before firstIndex are the same as in the previous
+ * call, the array contains the elements from firstIndex to totalSize - 1, i.e. the
+ * newly appended ones and the ones revised by the smoothing of the staging.
+ * The first committedSize elements of the staging won't be revised anymore.
+ *
+ * @param stagingData : the changed elements of the staging
+ * @param stagingDataSize : the size of stagingData, equal to totalSize - firstIndex
+ * @param firstIndex : the index of stagingData[0] in the whole staging
+ * @param totalSize : the size of the whole staging
+ * @param committedSize : the number of elements which are final
+ */
+typedef void (*ncStagingDeltaCallback)(const ncStagingElement *stagingData,
+                                        int stagingDataSize, int firstIndex,
+                                        int totalSize, int committedSize);
+
 /**
  * Type of callback for receiving online data about brain waves and heart rate.
  * It's called only if presentation mode is activated, but when active it is
@@ -195,6 +214,20 @@ bool ncStopSignalQualityMeasurement(ncNeuroonSignalProcessingState *data);
  */
 bool ncStartPresentation(ncNeuroonSignalProcessingState *data);
 
+/**
+ * Limits the number of calls of the presentation callback per second
+ * (of the signal time, as given by the timestamps of the frames).
+ * The updates which come in between are merged into the next call.
+ * The default is 30 calls per second.
+ *
+ * @param data : pointer to the private data of the library
+ * @param callsPerSecond : the maximal rate, 0 to call back after every update
+ *
+ * @return false if the rate is negative
+ */
+bool ncSetPresentationMaxRate(ncNeuroonSignalProcessingState *data,
+                              double callsPerSecond);
+
 /**
   * Stop computing the data for real-time presentation of brain waves and heart
  * rate
@@ -244,6 +277,59 @@ bool ncFeedDataStream1(ncNeuroonSignalProcessingState *data, char *bytes,
 bool ncFeedDataStream2(ncNeuroonSignalProcessingState *data, char *bytes,
                        int size);
 
+/**
+ * Switches the delivery of the sleep staging to the delta mode.
+ *
+ * After calling this function the callback is called instead of the
+ * ncStagingCallback passed to ncInitializeNeuroonAlgCore, receiving only
+ * the elements of the staging that changed since the previous call.
+ * Passing NULL switches back to receiving the whole staging.
+ *
+ * @param data : pointer to the private data of the library
+ * @param callback : the callback receiving the changes of the staging
+ */
+bool ncSetStagingDeltaCallback(ncNeuroonSignalProcessingState *data,
+                               ncStagingDeltaCallback callback);
+
+/**
+ * Copies the latest sleep staging to the buffer.
+ *
+ * Unlike the callbacks, this function can be called from any thread at any
+ * time, e.g. from the UI thread. It reads an immutable snapshot published
+ * by the processing, so it never blocks feeding the data and always gives
+ * a consistent staging.
+ *
+ * @param data : pointer to the private data of the library
+ * @param buffer : the buffer for the staging elements
+ * @param bufferSize : the capacity of the buffer, at most that many elements
+ * from the beginning of the staging are copied
+ * @param committedSize : if not NULL, receives the number of elements
+ * which won't change anymore
+ * @return the size of the whole staging, it can be greater than bufferSize
+ */
+int ncGetLatestStaging(ncNeuroonSignalProcessingState *data,
+                       ncStagingElement *buffer, int bufferSize,
+                       int *committedSize);
+
+/**
+ * Copies the latest data of the presentation mode, see ncStartPresentation.
+ * Like ncGetLatestStaging, can be called from any thread.
+ *
+ * @param data : pointer to the private data of the library
+ * @param bwBuffer : the buffer for the brain wave levels
+ * @param bwSize : the capacity of bwBuffer on input, the number of the most
+ * recent brain wave levels copied on output
+ * @param heartRate : receives the heart rate
+ * @param pulseBuffer : the buffer for the pulsoximetry data
+ * @param pulseSize : the capacity of pulseBuffer on input, the number
+ * of the most recent values copied on output
+ * @return false if there's no presentation data yet
+ */
+bool ncGetLatestPresentation(ncNeuroonSignalProcessingState *data,
+                             ncBrainWaveLevels *bwBuffer, int *bwSize,
+                             double *heartRate, double *pulseBuffer,
+                             int *pulseSize);
+
 /**
  * Installs a log callback to the library
  *
@@ -253,12 +339,87 @@ bool ncFeedDataStream2(ncNeuroonSignalProcessingState *data, char *bytes,
  * from the library and act accordingly. For example the caller may want to
  * use iOS API to save the messages to a file on a device's SD card.
  *
+ * The messages are captured when they are logged and passed to the callback
+ * later, every 100 ms, on a background thread owned by the library, or on
+ * the calling thread of ncFlushLogs. A callback which has to run on a known
+ * thread (e.g. a JNI callback without AttachCurrentThread) should use
+ * ncInstallSynchronousLogCallback instead. Not every message reaches
+ * the callback:
+ * - the messages are rate limited to 20 per second from each source file,
+ *   the number of the suppressed ones is reported with the next message,
+ * - the messages logged when 512 of them are already waiting are dropped,
+ * - the text of each message is truncated to 511 bytes, not counting the
+ *   time, level and location prefix.
+ *
  * @param callback : pointer to a void function taking C-style string (const
- * char*),
- * this function will be called every time a log message is generated.
+ * char*), called once for each message passed, never concurrently.
  *
  */
 bool ncInstallLogCallback(ncNeuroonSignalProcessingState *data,
                           ncLoggerCallback callback);
 
+/**
+ * Installs a log callback called on the thread which logs the message,
+ * every time a message is generated, without the rate limiting, dropping and
+ * truncation of ncInstallLogCallback. The formatting and the callback then
+ * slow down the algorithms, and the callback can be called from several
+ * threads of the library, one at a time.
+ *
+ * @param callback : pointer to a void function taking C-style string (const
+ * char*)
+ */
+bool ncInstallSynchronousLogCallback(ncNeuroonSignalProcessingState *data,
+                                     ncLoggerCallback callback);
+
+/**
+ * Passes the pending log messages to the log callback
+ *
+ * The messages are only captured when they are logged. A background thread
+ * of the library passes them to the callback every 100 ms, rate limited to
+ * 20 messages per second from each source file. This function passes the
+ * messages captured so far immediately, on the calling thread, e.g. before
+ * the application is suspended.
+ *
+ * The text of each message is truncated to 511 bytes, not counting the
+ * time, level and location prefix.
+ */
+bool ncFlushLogs(ncNeuroonSignalProcessingState *data);
+
+/**
+ * Turns the diagnostics of the algorithms on or off
+ *
+ * The diagnostics count the notable events inside the algorithms (e.g. the
+ * windows without a valid signal) and trace the intermediate values. They are
+ * passed to the log callback: the traces as they happen, sampled so that each
+ * one is logged only on every sampleEvery-th call, and the counts when the
+ * diagnostics are turned off. They are only available if the library was
+ * compiled with NC_DIAGNOSTICS, otherwise this function returns false.
+ *
+ * @param enabled : turning the diagnostics on resets the counts
+ * @param sampleEvery : every how many calls each trace is logged
+ */
+bool ncEnableDiagnostics(ncNeuroonSignalProcessingState *data, bool enabled,
+                         unsigned int sampleEvery);
+
+/**
+ * Copies the execution times of the stages of the processing to the buffer.
+ *
+ * The times are measured all the time, on all the threads of the library,
+ * since the initialization or the last ncResetPerformanceStats. Like
+ * ncGetLatestStaging, this function can be called from any thread.
+ *
+ * @param data : pointer to the private data of the library
+ * @param buffer : the buffer for the statistics, indexed by ncPerformanceStage
+ * @param bufferSize : the capacity of the buffer, at most that many stages
+ * are copied
+ * @return the number of the stages, NC_PERF_STAGES_COUNT
+ */
+int ncGetPerformanceStats(ncNeuroonSignalProcessingState *data,
+                          ncPerformanceStats *buffer, int bufferSize);
+
+/**
+ * Zeroes the execution times returned by ncGetPerformanceStats
+ */
+bool ncResetPerformanceStats(ncNeuroonSignalProcessingState *data);
+
 #endif
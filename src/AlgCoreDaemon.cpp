@@ -1,4 +1,5 @@
 #include "AlgCoreDaemon.h"
+#include "PerformanceCounters.h"
 #include "logger.h"
 
 
@@ -40,12 +41,20 @@ void AlgCoreDaemon::consume(std::shared_ptr<NeuroonFrameBytes> frame_stream) {
   }
   switch(frame_stream->source_stream){
   case NeuroonFrameBytes::SourceStream::EEG:{
-    auto f = std::make_shared<EegFrame>(EegFrame::from_bytes_array(frame_stream->bytes, frame_stream->size));
+    std::shared_ptr<EegFrame> f;
+    {
+      ScopedPerformanceTimer timer(NC_PERF_FRAME_DECODE);
+      f = std::make_shared<EegFrame>(EegFrame::from_bytes_array(frame_stream->bytes, frame_stream->size));
+    }
     consume(f);
     break;
   }
   case NeuroonFrameBytes::SourceStream::ALT:{
-    auto f = std::make_shared<PatFrame>(PatFrame::from_bytes_array(frame_stream->bytes, frame_stream->size));
+    std::shared_ptr<PatFrame> f;
+    {
+      ScopedPerformanceTimer timer(NC_PERF_FRAME_DECODE);
+      f = std::make_shared<PatFrame>(PatFrame::from_bytes_array(frame_stream->bytes, frame_stream->size));
+    }
     consume(f);
     break;
   }
@@ -60,6 +69,7 @@ void AlgCoreDaemon::consume (std::shared_ptr<PatFrame> frame) {
     LOG(WARNING) << "Unintended behaviour: Consuming data when processing flag turned off.";
   }
   // pass aggregating staff to the neuroonsignals instance
+  ScopedPerformanceTimer timer(NC_PERF_SIGNAL_APPEND);
   _neuroon_signals.consume(frame);
 }
 
@@ -68,6 +78,7 @@ void AlgCoreDaemon::consume (std::shared_ptr<EegFrame> frame) {
     LOG(WARNING) << "Unintended behaviour: Consuming data when processing flag turned off.";
   }
   // pass aggregating staff to the neuroonsignals instance
+  ScopedPerformanceTimer timer(NC_PERF_SIGNAL_APPEND);
   _neuroon_signals.consume(frame);
 }
 
@@ -76,6 +87,9 @@ void AlgCoreDaemon::_add_streaming_algorithms(std::unique_ptr<IStreamingAlgorith
   if (!suppress_warning && _processing_in_progress) {
     LOG(WARNING) << "Algorithm added when processing in progress flag is set!";
   }
+  for (int factor : saup->eeg_decimations()) {
+    _neuroon_signals.add_decimated_eeg(factor);
+  }
   _stream_algorithms.push_back(std::move(saup));
 }
 
@@ -2,10 +2,10 @@
 #define __ASYNC_DATA_SOURCE__
 
 #include <atomic>
-#include <iostream>
 #include <thread>
 
 #include "DataSource.h"
+#include "Diagnostics.h"
 
 template <class T>
 class AsyncDataSource
@@ -27,8 +27,7 @@ private:
         }
         // stopping mechanism
         if (this->_reader_should_stop) {
-          std::cerr << "stopping.";
-          std::fflush(stdout);
+          DIAG_COUNT("async_data_source.stopped");
           break;
         }
         // get the value from async
@@ -0,0 +1,129 @@
+/*
+ * AsyncLogger.cpp
+ */
+
+#include "AsyncLogger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+namespace {
+
+void copy_truncated(char* destination, std::size_t capacity, const char* source, std::size_t length) {
+	length = std::min(length, capacity - 1);
+	std::memcpy(destination, source, length);
+	destination[length] = '\0';
+}
+
+void copy_truncated(char* destination, std::size_t capacity, const char* source) {
+	copy_truncated(destination, capacity, source, std::strlen(source));
+}
+
+}
+
+const std::size_t AsyncLogger::DEFAULT_CAPACITY;
+const std::size_t AsyncLogger::DEFAULT_MAX_RECORDS_PER_SECOND;
+const int AsyncLogger::FLUSH_INTERVAL_MS;
+
+AsyncLogger::AsyncLogger(sink_t sink, bool background, std::size_t capacity,
+						 std::size_t max_records_per_second)
+: m_ring(capacity)
+, m_rate_limiter(max_records_per_second)
+, m_sink(sink)
+, m_stopping(false)
+{
+	if (background) {
+		m_worker = std::thread(&AsyncLogger::run, this);
+	}
+}
+
+AsyncLogger::~AsyncLogger() {
+	if (m_worker.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(m_wake_mutex);
+			m_stopping = true;
+		}
+		m_wake.notify_all();
+		m_worker.join();
+	}
+	flush();
+}
+
+bool AsyncLogger::capture(int level, const char* level_name, const char* logger,
+						  const char* file, unsigned long line, const std::string& message) {
+	const char* base_name = std::strrchr(file, '/');
+	base_name = base_name != nullptr ? base_name + 1 : file;
+
+	unsigned long long timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::system_clock::now().time_since_epoch()).count();
+
+	std::size_t suppressed = 0;
+	if (!m_rate_limiter.admit(base_name, timestamp, &suppressed)) {
+		return false;
+	}
+
+	LogRecord record;
+	record.level = level;
+	record.level_name = level_name;
+	record.timestamp = timestamp;
+	record.line = line;
+	record.suppressed = suppressed;
+	copy_truncated(record.logger, LogRecord::LOGGER_CAPACITY, logger);
+	copy_truncated(record.file, LogRecord::FILE_CAPACITY, base_name);
+	copy_truncated(record.message, LogRecord::MESSAGE_CAPACITY, message.c_str(), message.size());
+
+	return m_ring.try_push(record);
+}
+
+std::size_t AsyncLogger::flush() {
+	std::lock_guard<std::mutex> lock(m_flush_mutex);
+
+	std::size_t dispatched = 0;
+	LogRecord record;
+	while (m_ring.try_pop(record)) {
+		if (m_sink) {
+			m_sink(record.level, format(record));
+		}
+		++dispatched;
+	}
+	return dispatched;
+}
+
+void AsyncLogger::set_sink(sink_t sink) {
+	std::lock_guard<std::mutex> lock(m_flush_mutex);
+	m_sink = sink;
+}
+
+std::string AsyncLogger::format(const LogRecord& record) {
+	std::time_t seconds = static_cast<std::time_t>(record.timestamp / 1000);
+	std::tm local;
+	localtime_r(&seconds, &local);
+
+	char prefix[32];
+	std::snprintf(prefix, sizeof(prefix), "%02d/%02d %02d:%02d:%02d,%03d ",
+				  local.tm_mday, local.tm_mon + 1, local.tm_hour, local.tm_min, local.tm_sec,
+				  static_cast<int>(record.timestamp % 1000));
+
+	std::string line(prefix);
+	line.append(record.level_name).append(" [").append(record.logger).append("] ");
+	line.append(record.file).append(":").append(std::to_string(record.line)).append(": ");
+	if (record.suppressed != 0) {
+		line.append("(").append(std::to_string(record.suppressed)).append(" earlier messages suppressed) ");
+	}
+	line.append(record.message);
+	return line;
+}
+
+void AsyncLogger::run() {
+	std::unique_lock<std::mutex> lock(m_wake_mutex);
+	while (!m_stopping) {
+		m_wake.wait_for(lock, std::chrono::milliseconds(FLUSH_INTERVAL_MS));
+
+		// the producers never take this lock, but flush() may take a while
+		lock.unlock();
+		flush();
+		lock.lock();
+	}
+}
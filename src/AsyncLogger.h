@@ -0,0 +1,113 @@
+/*
+ * AsyncLogger.h
+ *
+ * The asynchronous backend of the logger: the log records are captured raw
+ * on the logging thread and formatted and dispatched later.
+ */
+
+#ifndef SRC_ASYNCLOGGER_H_
+#define SRC_ASYNCLOGGER_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "LogRateLimiter.h"
+#include "LogRecordRing.h"
+
+/**
+ * Captures log records into a LogRecordRing and passes them, formatted,
+ * to a sink on a background thread, or on the calling thread with flush().
+ *
+ * Capturing a record only copies the strings into a cell of the ring,
+ * without locking or allocating. The records of each module are rate limited,
+ * and the number of the suppressed ones is reported with the next record
+ * of the module.
+ *
+ * Two limits apply to the records logged through easylogging:
+ * - the message itself is still composed by the operator<< of LOG() on
+ *   the logging thread, which allocates; only the prefix (time, level,
+ *   location) is formatted and the sink called on the consumer thread,
+ * - messages longer than LogRecord::MESSAGE_CAPACITY - 1 bytes are silently
+ *   truncated, and so are the logger ids and the file names.
+ */
+class AsyncLogger {
+public:
+	/**
+	 * Receives the el::Level of a record and its formatted line
+	 */
+	typedef std::function<void(int level, const std::string& line)> sink_t;
+
+	static const std::size_t DEFAULT_CAPACITY = 512;
+	static const std::size_t DEFAULT_MAX_RECORDS_PER_SECOND = 20;
+	static const int FLUSH_INTERVAL_MS = 100;
+
+	/**
+	 * @param background : if true, the pending records are flushed
+	 * every FLUSH_INTERVAL_MS by a background thread, otherwise only by flush()
+	 */
+	AsyncLogger(sink_t sink, bool background = true, std::size_t capacity = DEFAULT_CAPACITY,
+				std::size_t max_records_per_second = DEFAULT_MAX_RECORDS_PER_SECOND);
+
+	/**
+	 * Stops the background thread and flushes the pending records
+	 */
+	~AsyncLogger();
+
+	AsyncLogger(const AsyncLogger&) = delete;
+	AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+	/**
+	 * Captures a record; safe to call from any thread.
+	 *
+	 * @param level_name : has to be a string literal, it's not copied
+	 * @param file : the path of the source file, only the base name is kept
+	 * @param message : truncated to LogRecord::MESSAGE_CAPACITY - 1 bytes
+	 * @return false if the record was rate limited or the ring was full
+	 */
+	bool capture(int level, const char* level_name, const char* logger,
+				 const char* file, unsigned long line, const std::string& message);
+
+	/**
+	 * Formats and dispatches the pending records on the calling thread.
+	 * @return the number of the records dispatched
+	 */
+	std::size_t flush();
+
+	void set_sink(sink_t sink);
+
+	void set_max_records_per_second(std::size_t max_records_per_second) {
+		m_rate_limiter.set_max_per_second(max_records_per_second);
+	}
+
+	/**
+	 * @return the number of records dropped because the ring was full
+	 */
+	std::size_t dropped() const {
+		return m_ring.dropped();
+	}
+
+	/**
+	 * Formats a record as "dd/MM hh:mm:ss,mmm LEVEL [logger] file:line: message"
+	 */
+	static std::string format(const LogRecord& record);
+
+private:
+	void run();
+
+	LogRecordRing m_ring;
+	LogRateLimiter m_rate_limiter;
+
+	// serializes the consumers, i.e. flush() and the background thread
+	std::mutex m_flush_mutex;
+	sink_t m_sink;
+
+	std::mutex m_wake_mutex;
+	std::condition_variable m_wake;
+	bool m_stopping;
+	std::thread m_worker;
+};
+
+#endif /* SRC_ASYNCLOGGER_H_ */
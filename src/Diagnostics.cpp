@@ -0,0 +1,51 @@
+/*
+ * Diagnostics.cpp
+ */
+
+#include "Diagnostics.h"
+#include <algorithm>
+#include <map>
+#include "logger.h"
+
+const unsigned long Diagnostics::DEFAULT_SAMPLE_EVERY;
+
+std::atomic<bool> Diagnostics::s_enabled(false);
+std::atomic<unsigned long> Diagnostics::s_sample_every(Diagnostics::DEFAULT_SAMPLE_EVERY);
+std::atomic<Diagnostics::Site*> Diagnostics::s_sites(nullptr);
+
+Diagnostics::Site::Site(const char* name)
+: name(name)
+, count(0)
+, next(s_sites.load(std::memory_order_relaxed))
+{
+	while (!s_sites.compare_exchange_weak(next, this, std::memory_order_release, std::memory_order_relaxed)) {}
+}
+
+void Diagnostics::set_sample_every(unsigned long sample_every) {
+	s_sample_every.store(std::max(1ul, sample_every), std::memory_order_relaxed);
+}
+
+std::vector<std::pair<std::string, unsigned long>> Diagnostics::counters() {
+	std::map<std::string, unsigned long> sums;
+	for (Site* site = s_sites.load(std::memory_order_acquire); site != nullptr; site = site->next) {
+		sums[site->name] += site->count.load(std::memory_order_relaxed);
+	}
+	return std::vector<std::pair<std::string, unsigned long>>(sums.begin(), sums.end());
+}
+
+void Diagnostics::reset() {
+	for (Site* site = s_sites.load(std::memory_order_acquire); site != nullptr; site = site->next) {
+		site->count.store(0, std::memory_order_relaxed);
+	}
+}
+
+void Diagnostics::report() {
+	for (const auto& counter : counters()) {
+		LOG(INFO) << "diagnostics: " << counter.first << " = " << counter.second;
+	}
+}
+
+DiagnosticsTrace::~DiagnosticsTrace() {
+	LOG(INFO) << "[" << m_site->name << " #" << m_site->count.load(std::memory_order_relaxed) << "] "
+			  << m_stream.str();
+}
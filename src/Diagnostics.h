@@ -0,0 +1,157 @@
+/*
+ * Diagnostics.h
+ *
+ * Counters and sampled traces of the internals of the algorithms,
+ * routed to the logger instead of the standard output.
+ */
+
+#ifndef SRC_DIAGNOSTICS_H_
+#define SRC_DIAGNOSTICS_H_
+
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * The diagnostics of the library: the numbers of times the instrumented
+ * places were reached, and traces of the values computed there, sampled so
+ * that a hot path is traced only on every sample_every()-th call.
+ *
+ * The code is instrumented with the DIAG_COUNT and DIAG_TRACE macros, which
+ * are removed by the preprocessor unless NC_DIAGNOSTICS is defined. When
+ * compiled in, they do nothing until enabled with set_enabled(), and then
+ * cost an atomic increment, except for the sampled traces, which are
+ * formatted and logged with LOG(INFO), i.e. passed to the log callback.
+ */
+class Diagnostics {
+public:
+	static const unsigned long DEFAULT_SAMPLE_EVERY = 100;
+
+	/**
+	 * An instrumented place in the code. The sites are static objects,
+	 * registered in a global list when they are reached for the first time.
+	 */
+	struct Site {
+		explicit Site(const char* name);
+
+		const char* const name;
+		std::atomic<unsigned long> count;
+		Site* next;
+	};
+
+	static bool enabled() {
+		return s_enabled.load(std::memory_order_relaxed);
+	}
+
+	static void set_enabled(bool enabled) {
+		s_enabled.store(enabled, std::memory_order_relaxed);
+	}
+
+	static unsigned long sample_every() {
+		return s_sample_every.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * @param sample_every : every how many calls a site is traced, 1 traces all the calls
+	 */
+	static void set_sample_every(unsigned long sample_every);
+
+	/**
+	 * Counts a call at the site, if enabled
+	 */
+	static void count(Site& site) {
+		if (enabled()) {
+			site.count.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	/**
+	 * Counts a call at the site, if enabled
+	 * @return the site if the call should be traced, nullptr otherwise
+	 */
+	static Site* sample(Site& site) {
+		if (!enabled()) {
+			return nullptr;
+		}
+		unsigned long previous = site.count.fetch_add(1, std::memory_order_relaxed);
+		return previous % sample_every() == 0 ? &site : nullptr;
+	}
+
+	/**
+	 * @return the counts of the sites summed by name, sorted by name
+	 */
+	static std::vector<std::pair<std::string, unsigned long>> counters();
+
+	/**
+	 * Zeroes the counts of all the sites
+	 */
+	static void reset();
+
+	/**
+	 * Logs the counts of all the sites
+	 */
+	static void report();
+
+private:
+	static std::atomic<bool> s_enabled;
+	static std::atomic<unsigned long> s_sample_every;
+	static std::atomic<Site*> s_sites;
+};
+
+/**
+ * Collects the values of a sampled trace and logs them when destroyed
+ */
+class DiagnosticsTrace {
+public:
+	explicit DiagnosticsTrace(const Diagnostics::Site* site)
+	: m_site(site) {}
+
+	~DiagnosticsTrace();
+
+	template <typename T>
+	DiagnosticsTrace& operator<<(const T& value) {
+		m_stream << value;
+		return *this;
+	}
+
+private:
+	const Diagnostics::Site* m_site;
+	std::ostringstream m_stream;
+};
+
+/**
+ * Swallows the values of a trace which isn't compiled in
+ */
+struct DiagnosticsNullTrace {
+	template <typename T>
+	DiagnosticsNullTrace& operator<<(const T&) {
+		return *this;
+	}
+};
+
+// a static site for every place the macro is expanded in
+#define DIAG_SITE_(name) ([]() -> Diagnostics::Site& { static Diagnostics::Site site(name); return site; }())
+
+#ifdef NC_DIAGNOSTICS
+	/**
+	 * Counts the calls, e.g. DIAG_COUNT("rolling_mean.nan");
+	 */
+	#define DIAG_COUNT(name) Diagnostics::count(DIAG_SITE_(name))
+
+	/**
+	 * Counts the calls and traces the sampled ones, e.g.
+	 * DIAG_TRACE("features.standardize") << "mean: " << mean;
+	 * The values are only evaluated for the sampled calls.
+	 */
+	#define DIAG_TRACE(name) \
+		for (Diagnostics::Site* diag_site_ = Diagnostics::sample(DIAG_SITE_(name)); \
+			 diag_site_ != nullptr; diag_site_ = nullptr) \
+			DiagnosticsTrace(diag_site_)
+#else
+	#define DIAG_COUNT(name) do {} while (false)
+	#define DIAG_TRACE(name) while (false) DiagnosticsNullTrace()
+#endif
+
+#endif /* SRC_DIAGNOSTICS_H_ */
@@ -1,11 +1,9 @@
 #ifdef DESKTOP_BUILD
 
-#include <random>
+#include <algorithm>
 #include "EegQualityStream.h"
 
 void EegQualityStream::process_input(const INeuroonSignals & ns){
-  // TODO: now is dummy implementation
-
   // number of windows for computing signal quality value
   auto windows_count = (ns.total_signal_samples(SignalOrigin::EEG) - _last_counter) / (_window_size - _overlap);
 
@@ -20,12 +18,35 @@ void EegQualityStream::process_input(const INeuroonSignals & ns){
 
 }
 
-EegQuality EegQualityStream::_compute_quality(VectorView<double>){
-  // TODO
-  return (EegQuality)(std::rand() % 4);
+// the quality at the end of the window, the samples overlapping
+// with the previous window were already fed to the estimator
+EegQuality EegQualityStream::_compute_quality(VectorView<double> eeg_signal){
+  std::size_t new_samples = std::min<std::size_t>(_window_size - _overlap, eeg_signal.size());
+  if (_estimated_counter == 0) {
+    new_samples = eeg_signal.size();
+  }
+  for (auto it = eeg_signal.begin() + (eeg_signal.size() - new_samples); it != eeg_signal.end(); ++it) {
+    _estimator.consume(*it);
+  }
+  _estimated_counter += new_samples;
+
+  // the grades of ncSignalQuality: 0 no signal, 1 very bad ... 4 very good
+  switch (_estimator.quality()) {
+  case 0:
+    return EegQuality::NO_SIGNAL;
+  case 1:
+  case 2:
+    return EegQuality::BAD;
+  case 3:
+    return EegQuality::AVERAGE;
+  default:
+    return EegQuality::GOOD;
+  }
 }
 
 void EegQualityStream::reset_state(){
   _last_counter = 0;
+  _estimated_counter = 0;
+  _estimator.reset();
 }
 #endif
@@ -5,6 +5,7 @@
 
 #include "VectorView.h"
 #include "StreamingAlgorithm.h"
+#include "StreamingEegQuality.h"
 
 enum class EegQuality{NO_SIGNAL, BAD, AVERAGE, GOOD};
 
@@ -15,6 +16,8 @@ private:
   int _window_size;
   int _overlap;
   std::size_t _last_counter;
+  std::size_t _estimated_counter;
+  StreamingEegQuality _estimator;
 
   EegQuality _compute_quality(VectorView<double> eeg_signal);
 public:
@@ -25,7 +28,8 @@ public:
    *  @param sinks The result from each window window will be send to each data sink.
    */
   EegQualityStream(int window_size, int overlap=0, const std::vector<IDataSink<EegQuality>*> & sinks={}) :
-    SinkStreamingAlgorithm(sinks),_window_size(window_size), _overlap(overlap) {}
+    SinkStreamingAlgorithm(sinks),_window_size(window_size), _overlap(overlap),
+    _last_counter(0), _estimated_counter(0), _estimator(125) {}
 
 
   virtual void reset_state() override;
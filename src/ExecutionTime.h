@@ -1,6 +1,32 @@
-#include <iostream>
+#ifndef SRC_EXECUTIONTIME_H_
+#define SRC_EXECUTIONTIME_H_
+
 #include <chrono>
+#include <string>
+#include "logger.h"
+
+/**
+ * Measures the time elapsed since its construction
+ */
+class ExecutionTimer {
+	std::chrono::time_point<std::chrono::steady_clock> m_start;
+
+public:
+	ExecutionTimer()
+	: m_start(std::chrono::steady_clock::now())
+	{}
 
+	double elapsed_ms() const {
+		auto diff = std::chrono::steady_clock::now() - m_start;
+		return std::chrono::duration<double, std::milli>(diff).count();
+	}
+};
+
+/**
+ * Logs the time elapsed between its construction and destruction.
+ * For measuring the stages of the processing in the library
+ * see ScopedPerformanceTimer.
+ */
 class ExecutionTime {
 	std::chrono::time_point<std::chrono::steady_clock> m_start;
 	std::string m_message;
@@ -16,7 +42,9 @@ public:
 	~ExecutionTime() {
 		auto end = std::chrono::steady_clock::now();
 		auto diff = end - m_start;
-		std::cout << m_message << ": " << std::chrono::duration<double, std::milli>(diff).count() << " ms" << std::endl;
+		LOG(INFO) << m_message << ": " << std::chrono::duration<double, std::milli>(diff).count() << " ms";
 	}
 
 };
+
+#endif /* SRC_EXECUTIONTIME_H_ */
@@ -0,0 +1,51 @@
+/*
+ * LogRateLimiter.cpp
+ */
+
+#include "LogRateLimiter.h"
+
+namespace {
+
+// FNV-1a
+std::size_t module_hash(const char* module) {
+	std::size_t hash = 2166136261u;
+	for (const char* c = module; *c != '\0'; ++c) {
+		hash = (hash ^ static_cast<unsigned char>(*c)) * 16777619u;
+	}
+	return hash;
+}
+
+}
+
+const std::size_t LogRateLimiter::SLOTS;
+
+LogRateLimiter::LogRateLimiter(std::size_t max_per_second)
+: m_max_per_second(max_per_second)
+{
+	for (Slot& slot : m_slots) {
+		slot.second.store(0, std::memory_order_relaxed);
+		slot.admitted.store(0, std::memory_order_relaxed);
+		slot.suppressed.store(0, std::memory_order_relaxed);
+	}
+}
+
+bool LogRateLimiter::admit(const char* module, unsigned long long timestamp, std::size_t* suppressed) {
+	std::size_t max_per_second = m_max_per_second.load(std::memory_order_relaxed);
+	Slot& slot = m_slots[module_hash(module) % SLOTS];
+
+	// the first record of a new second starts the count over; the races
+	// between the threads can only let a few extra records through
+	unsigned long long second = timestamp / 1000;
+	unsigned long long counted = slot.second.load(std::memory_order_relaxed);
+	if (counted != second && slot.second.compare_exchange_strong(counted, second, std::memory_order_relaxed)) {
+		slot.admitted.store(0, std::memory_order_relaxed);
+	}
+
+	if (max_per_second != 0 && slot.admitted.fetch_add(1, std::memory_order_relaxed) >= max_per_second) {
+		slot.suppressed.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	*suppressed = slot.suppressed.exchange(0, std::memory_order_relaxed);
+	return true;
+}
@@ -0,0 +1,56 @@
+/*
+ * LogRateLimiter.h
+ */
+
+#ifndef SRC_LOGRATELIMITER_H_
+#define SRC_LOGRATELIMITER_H_
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * Limits the number of log records per module (source file) and second,
+ * so that a hot loop logging on every call can't flood the log ring.
+ *
+ * The modules are hashed into a fixed table of counters, so admitting
+ * a record is lock-free and never allocates. Modules whose names collide
+ * share the limit.
+ */
+class LogRateLimiter {
+public:
+	static const std::size_t SLOTS = 64;
+
+	/**
+	 * @param max_per_second : the records admitted per module and second,
+	 * 0 admits everything
+	 */
+	explicit LogRateLimiter(std::size_t max_per_second);
+
+	LogRateLimiter(const LogRateLimiter&) = delete;
+	LogRateLimiter& operator=(const LogRateLimiter&) = delete;
+
+	/**
+	 * @param module : the name of the module, e.g. the base name of the source file
+	 * @param timestamp : the time of the record in milliseconds
+	 * @param suppressed : set to the number of the records of the module
+	 * rejected since the last admitted one, if the record is admitted
+	 * @return true if the record should be logged
+	 */
+	bool admit(const char* module, unsigned long long timestamp, std::size_t* suppressed);
+
+	void set_max_per_second(std::size_t max_per_second) {
+		m_max_per_second.store(max_per_second, std::memory_order_relaxed);
+	}
+
+private:
+	struct Slot {
+		std::atomic<unsigned long long> second;
+		std::atomic<std::size_t> admitted;
+		std::atomic<std::size_t> suppressed;
+	};
+
+	std::atomic<std::size_t> m_max_per_second;
+	Slot m_slots[SLOTS];
+};
+
+#endif /* SRC_LOGRATELIMITER_H_ */
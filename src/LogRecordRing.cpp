@@ -0,0 +1,78 @@
+/*
+ * LogRecordRing.cpp
+ */
+
+#include "LogRecordRing.h"
+#include <stdexcept>
+
+const std::size_t LogRecord::LOGGER_CAPACITY;
+const std::size_t LogRecord::FILE_CAPACITY;
+const std::size_t LogRecord::MESSAGE_CAPACITY;
+
+LogRecordRing::LogRecordRing(std::size_t capacity)
+: m_enqueue_position(0)
+, m_dequeue_position(0)
+, m_dropped(0)
+{
+	if (capacity == 0) {
+		throw std::logic_error("LogRecordRing: the capacity has to be positive");
+	}
+	std::size_t rounded = 1;
+	while (rounded < capacity) {
+		rounded *= 2;
+	}
+	m_mask = rounded - 1;
+
+	m_cells.reset(new Cell[rounded]);
+	for (std::size_t i = 0; i != rounded; ++i) {
+		m_cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+}
+
+bool LogRecordRing::try_push(const LogRecord& record) {
+	std::size_t position = m_enqueue_position.load(std::memory_order_relaxed);
+	Cell* cell;
+	while (true) {
+		cell = &m_cells[position & m_mask];
+		std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+		std::ptrdiff_t lap = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+		if (lap == 0) {
+			if (m_enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+				break;
+			}
+		} else if (lap < 0) {
+			// the consumer hasn't freed the cell yet
+			m_dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		} else {
+			position = m_enqueue_position.load(std::memory_order_relaxed);
+		}
+	}
+
+	cell->record = record;
+	cell->sequence.store(position + 1, std::memory_order_release);
+	return true;
+}
+
+bool LogRecordRing::try_pop(LogRecord& record) {
+	std::size_t position = m_dequeue_position.load(std::memory_order_relaxed);
+	Cell* cell;
+	while (true) {
+		cell = &m_cells[position & m_mask];
+		std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+		std::ptrdiff_t lap = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+		if (lap == 0) {
+			if (m_dequeue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+				break;
+			}
+		} else if (lap < 0) {
+			return false;
+		} else {
+			position = m_dequeue_position.load(std::memory_order_relaxed);
+		}
+	}
+
+	record = cell->record;
+	cell->sequence.store(position + m_mask + 1, std::memory_order_release);
+	return true;
+}
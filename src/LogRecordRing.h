@@ -0,0 +1,100 @@
+/*
+ * LogRecordRing.h
+ *
+ * A bounded lock-free queue of raw log records.
+ */
+
+#ifndef SRC_LOGRECORDRING_H_
+#define SRC_LOGRECORDRING_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/**
+ * A log record as captured on the logging thread, before any formatting.
+ * The strings are truncated to fit, so capturing a record never allocates;
+ * e.g. a message keeps at most MESSAGE_CAPACITY - 1 bytes.
+ */
+struct LogRecord {
+	static const std::size_t LOGGER_CAPACITY = 16;
+	static const std::size_t FILE_CAPACITY = 48;
+	static const std::size_t MESSAGE_CAPACITY = 512;
+
+	// the el::Level of the record and its name, which has to be a string literal
+	int level;
+	const char* level_name;
+
+	// milliseconds since the epoch
+	unsigned long long timestamp;
+	unsigned long line;
+
+	// the number of records of the same module dropped by the rate limit
+	// since the previous record of the module
+	std::size_t suppressed;
+
+	char logger[LOGGER_CAPACITY];
+	char file[FILE_CAPACITY];
+	char message[MESSAGE_CAPACITY];
+};
+
+/**
+ * A bounded multi-producer queue of LogRecords, lock-free on both ends.
+ *
+ * Each cell has a sequence number telling which lap of the ring it's ready
+ * for, so the producers claim the cells with a single compare-and-swap
+ * of the enqueue position and never wait for each other or for the consumer.
+ * When the ring is full the record is dropped rather than blocking the
+ * logging thread.
+ */
+class LogRecordRing {
+public:
+	/**
+	 * @param capacity : the maximum number of pending records, rounded up
+	 * to a power of 2
+	 */
+	explicit LogRecordRing(std::size_t capacity);
+
+	LogRecordRing(const LogRecordRing&) = delete;
+	LogRecordRing& operator=(const LogRecordRing&) = delete;
+
+	/**
+	 * @return false if the ring is full and the record was dropped
+	 */
+	bool try_push(const LogRecord& record);
+
+	/**
+	 * Moves the oldest record to 'record'.
+	 * @return false if the ring is empty
+	 */
+	bool try_pop(LogRecord& record);
+
+	std::size_t capacity() const {
+		return m_mask + 1;
+	}
+
+	/**
+	 * @return the number of records dropped because the ring was full
+	 */
+	std::size_t dropped() const {
+		return m_dropped.load(std::memory_order_relaxed);
+	}
+
+private:
+	struct Cell {
+		std::atomic<std::size_t> sequence;
+		LogRecord record;
+	};
+
+	std::size_t m_mask;
+	std::unique_ptr<Cell[]> m_cells;
+
+	// the padding keeps the positions of the producers and of the consumer
+	// in different cache lines
+	std::atomic<std::size_t> m_enqueue_position;
+	char m_padding[64];
+	std::atomic<std::size_t> m_dequeue_position;
+	std::atomic<std::size_t> m_dropped;
+};
+
+#endif /* SRC_LOGRECORDRING_H_ */
@@ -0,0 +1,65 @@
+#ifndef __MIRRORED_RING__
+#define __MIRRORED_RING__
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/**
+ * A ring buffer holding the last capacity() pushed elements, which are always
+ * available as one contiguous array, oldest first, without copying.
+ *
+ * Every element is stored twice, at position i and i + capacity() of a buffer
+ * twice as long, so the last capacity() elements always end just before
+ * the current position plus capacity(). A push is O(1), i.e. two writes.
+ */
+template <typename T>
+class MirroredRing {
+  std::vector<T> _buffer;
+  std::size_t _capacity;
+  std::size_t _next;
+  std::size_t _size;
+
+public:
+  /**
+   * @param capacity : the number of elements kept
+   */
+  explicit MirroredRing(std::size_t capacity)
+    : _buffer(2 * capacity), _capacity(capacity), _next(0), _size(0) {}
+
+  void push(const T& value) {
+    _buffer[_next] = value;
+    _buffer[_next + _capacity] = value;
+    _next = _next + 1 == _capacity ? 0 : _next + 1;
+    _size = std::min(_size + 1, _capacity);
+  }
+
+  /**
+   * @return the last size() elements, oldest first; the pointer is valid
+   * until the next push
+   */
+  const T* data() const { return _buffer.data() + _next + _capacity - _size; }
+
+  /**
+   * @return the number of elements held, at most capacity()
+   */
+  std::size_t size() const { return _size; }
+
+  std::size_t capacity() const { return _capacity; }
+
+  void clear() {
+    _next = 0;
+    _size = 0;
+  }
+
+  /**
+   * Makes the ring full of copies of the value
+   */
+  void fill(const T& value) {
+    std::fill(_buffer.begin(), _buffer.end(), value);
+    _next = 0;
+    _size = _capacity;
+  }
+};
+
+#endif
@@ -9,22 +9,23 @@
  * @date October 2016
  */
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
 #include <sstream>
+#include <vector>
 
 #include "AlgCoreDaemon.h"
+#include "Diagnostics.h"
 #include "NeuroonSignalStreamApi.h"
 #include "OnlinePresentationAlgorithm.h"
-#include "OnlineSignalQualityAlgorithmMock.h"
+#include "OnlineSignalQualityAlgorithm.h"
 #include "OnlineStagingAlgorithm.h"
+#include "PerformanceCounters.h"
+#include "Snapshot.h"
+#include "StagingSnapshot.h"
 #include "logger.h"
 
-struct NeuroonSignalProcessingState {
-  AlgCoreDaemon _daemon;
-  OnlinePresentationAlgorithm *_online_presentation;
-  OnlineSignalQualityAlgorithmMock *_online_signal_quality;
-};
-
 struct LoggingSink : public OnlineStagingAlgorithm::sink_t {
   std::shared_ptr<SleepStagingResult> m_last_staging;
 
@@ -40,21 +41,89 @@ struct LoggingSink : public OnlineStagingAlgorithm::sink_t {
     for (int i = 0; i != res->m_stages.size(); ++i) {
       ss << res->m_stages[i].stage << " ";
     }
-    LOG(INFO) << "online staging: " << ss.str();
+    LOG(INFO) << "online staging from " << res->m_first_index << " of "
+              << res->m_total_size << ": " << ss.str();
   }
 };
 
+/**
+ * Passes the staging to the client, either as the deltas or, when no delta
+ * callback is installed, as the whole staging kept up to date with the deltas.
+ */
 struct CallbackStagingSink : public OnlineStagingAlgorithm::sink_t {
   virtual ~CallbackStagingSink() {}
 
   ncStagingCallback _callback;
-  CallbackStagingSink(ncStagingCallback callback) { _callback = callback; }
+  std::atomic<ncStagingDeltaCallback> _delta_callback;
+  std::vector<ncStagingElement> _staging;
+
+  CallbackStagingSink(ncStagingCallback callback) : _delta_callback(nullptr) {
+    _callback = callback;
+  }
 
   void setDataSourceDelegate(SinkSetDelegateKey,
                              std::weak_ptr<IDataSourceDelegate>) override {}
 
   void consume(std::shared_ptr<SleepStagingResult> res) {
-    (*_callback)(res->m_stages.data(), res->m_stages.size());
+    res->apply_to(_staging);
+
+    ncStagingDeltaCallback delta_callback = _delta_callback.load();
+    ScopedPerformanceTimer timer(NC_PERF_CALLBACKS);
+    if (delta_callback) {
+      (*delta_callback)(res->m_stages.data(), res->m_stages.size(),
+                        res->m_first_index, res->m_total_size,
+                        res->m_committed);
+    } else {
+      (*_callback)(_staging.data(), _staging.size());
+    }
+  }
+};
+
+/**
+ * Publishes the whole staging for ncGetLatestStaging, each snapshot built
+ * from the previous one and the delta
+ */
+struct SnapshotStagingSink : public OnlineStagingAlgorithm::sink_t {
+  virtual ~SnapshotStagingSink() {}
+
+  Snapshot<StagingSnapshot> _snapshot;
+
+  void setDataSourceDelegate(SinkSetDelegateKey,
+                             std::weak_ptr<IDataSourceDelegate>) override {}
+
+  void consume(std::shared_ptr<SleepStagingResult> res) {
+    // only this thread publishes
+    std::shared_ptr<const StagingSnapshot> previous = _snapshot.latest();
+    _snapshot.publish(StagingSnapshot::apply(previous.get(), *res));
+  }
+};
+
+struct PresentationSnapshot {
+  std::vector<ncBrainWaveLevels> brain_waves;
+  double heart_rate;
+  std::vector<double> pulse_data;
+};
+
+/**
+ * Publishes a copy of the presentation data for ncGetLatestPresentation,
+ * the result itself points to the buffers of the algorithm
+ */
+struct SnapshotPresentationSink : public OnlinePresentationAlgorithm::sink_t {
+  virtual ~SnapshotPresentationSink() {}
+
+  Snapshot<PresentationSnapshot> _snapshot;
+
+  void setDataSourceDelegate(SinkSetDelegateKey,
+                             std::weak_ptr<IDataSourceDelegate>) override {}
+
+  void consume(std::shared_ptr<OnlinePresentationResult> res) {
+    auto snapshot = std::make_shared<PresentationSnapshot>();
+    snapshot->brain_waves.assign(res->brain_waves,
+                                 res->brain_waves + res->bw_size);
+    snapshot->heart_rate = res->heart_rate;
+    snapshot->pulse_data.assign(res->pulse_data,
+                                res->pulse_data + res->pd_size);
+    _snapshot.publish(snapshot);
   }
 };
 
@@ -70,17 +139,18 @@ struct CallbackPresentationSink : public OnlinePresentationAlgorithm::sink_t {
                              std::weak_ptr<IDataSourceDelegate>) override {}
 
   void consume(std::shared_ptr<OnlinePresentationResult> res) {
+    ScopedPerformanceTimer timer(NC_PERF_CALLBACKS);
     (*_callback)(res->brain_waves, res->bw_size, res->heart_rate,
                  res->pulse_data, res->pd_size);
   }
 };
 
-struct CallbackSignalQualityMockSink
-    : public OnlineSignalQualityAlgorithmMock::sink_t {
-  virtual ~CallbackSignalQualityMockSink() {}
+struct CallbackSignalQualitySink
+    : public OnlineSignalQualityAlgorithm::sink_t {
+  virtual ~CallbackSignalQualitySink() {}
 
   ncSignalQualityCallback _callback;
-  CallbackSignalQualityMockSink(ncSignalQualityCallback callback) {
+  CallbackSignalQualitySink(ncSignalQualityCallback callback) {
     _callback = callback;
   }
 
@@ -88,10 +158,20 @@ struct CallbackSignalQualityMockSink
                              std::weak_ptr<IDataSourceDelegate>) override {}
 
   void consume(std::shared_ptr<OnlineSignalQualityResult> res) {
+    ScopedPerformanceTimer timer(NC_PERF_CALLBACKS);
     (*_callback)(res->results, res->count);
   }
 };
 
+struct NeuroonSignalProcessingState {
+  AlgCoreDaemon _daemon;
+  OnlinePresentationAlgorithm *_online_presentation;
+  OnlineSignalQualityAlgorithm *_online_signal_quality;
+  CallbackStagingSink *_staging_sink;
+  SnapshotStagingSink *_staging_snapshot;
+  SnapshotPresentationSink *_presentation_snapshot;
+};
+
 NeuroonSignalProcessingState *
 ncInitializeNeuroonAlgCore(ncStagingCallback staging_callback,
                            ncSignalQualityCallback sq_callback,
@@ -99,26 +179,34 @@ ncInitializeNeuroonAlgCore(ncStagingCallback staging_callback,
   LOG(INFO) << "API CALL";
   NeuroonSignalProcessingState *data = new NeuroonSignalProcessingState();
   data->_online_presentation = nullptr;
+  data->_online_signal_quality = nullptr;
 
   LoggingSink *ls = new LoggingSink();
   CallbackStagingSink *css = new CallbackStagingSink(staging_callback);
+  data->_staging_sink = css;
+  data->_staging_snapshot = new SnapshotStagingSink();
   auto online_alg = std::unique_ptr<IStreamingAlgorithm>(
-      new OnlineStagingAlgorithm({ls, css}));
+      new OnlineStagingAlgorithm({ls, css, data->_staging_snapshot}, true));
   data->_daemon.add_streaming_algorithms(online_alg);
 
+  // the presentation is available through ncGetLatestPresentation
+  // even without the callback
+  data->_presentation_snapshot = new SnapshotPresentationSink();
+  std::vector<OnlinePresentationAlgorithm::sink_t *> presentation_sinks(
+      {data->_presentation_snapshot});
   if (reinterpret_cast<long>(presentation_callback) != 0) {
-    CallbackPresentationSink *ps =
-        new CallbackPresentationSink(presentation_callback);
-    auto presentation_alg = new OnlinePresentationAlgorithm({ps});
-    auto alg_ptr = std::unique_ptr<IStreamingAlgorithm>(presentation_alg);
-    data->_daemon.add_streaming_algorithms(alg_ptr);
-    data->_online_presentation = presentation_alg;
+    presentation_sinks.push_back(
+        new CallbackPresentationSink(presentation_callback));
   }
+  auto presentation_alg = new OnlinePresentationAlgorithm(presentation_sinks);
+  auto alg_ptr = std::unique_ptr<IStreamingAlgorithm>(presentation_alg);
+  data->_daemon.add_streaming_algorithms(alg_ptr);
+  data->_online_presentation = presentation_alg;
 
-  // initialize online signal quality mock
+  // initialize online signal quality
   if (reinterpret_cast<long>(sq_callback) != 0) {
-    auto *ps = new CallbackSignalQualityMockSink(sq_callback);
-    auto online_quality_alg = new OnlineSignalQualityAlgorithmMock({ps});
+    auto *ps = new CallbackSignalQualitySink(sq_callback);
+    auto online_quality_alg = new OnlineSignalQualityAlgorithm({ps});
     auto alg_ptr = std::unique_ptr<IStreamingAlgorithm>(online_quality_alg);
     data->_daemon.add_streaming_algorithms(alg_ptr);
     data->_online_signal_quality = online_quality_alg;
@@ -152,7 +240,7 @@ bool ncStopSleep(NeuroonSignalProcessingState *data) {
 bool ncStartSignalQualityMeasurement(ncNeuroonSignalProcessingState *data) {
   LOG(INFO) << "API CALL";
 
-  if (!data->_online_presentation) {
+  if (!data->_online_signal_quality) {
     return false;
   }
 
@@ -164,7 +252,7 @@ bool ncStartSignalQualityMeasurement(ncNeuroonSignalProcessingState *data) {
 bool ncStopSignalQualityMeasurement(ncNeuroonSignalProcessingState *data) {
   LOG(INFO) << "API CALL";
 
-  if (!data->_online_presentation) {
+  if (!data->_online_signal_quality) {
     return false;
   }
 
@@ -207,6 +295,61 @@ bool ncFeedDataStream2(NeuroonSignalProcessingState *data, char *bytes,
   return true;
 }
 
+bool ncSetStagingDeltaCallback(NeuroonSignalProcessingState *data,
+                               ncStagingDeltaCallback callback) {
+  LOG(INFO) << "API CALL";
+  data->_staging_sink->_delta_callback.store(callback);
+  LOG(INFO) << "API CALL END";
+  return true;
+}
+
+int ncGetLatestStaging(NeuroonSignalProcessingState *data,
+                       ncStagingElement *buffer, int bufferSize,
+                       int *committedSize) {
+  std::shared_ptr<const StagingSnapshot> snapshot =
+      data->_staging_snapshot->_snapshot.latest();
+  if (!snapshot) {
+    if (committedSize) {
+      *committedSize = 0;
+    }
+    return 0;
+  }
+
+  int size = snapshot->size();
+  snapshot->copy_to(buffer, std::max(0, bufferSize));
+  if (committedSize) {
+    *committedSize = snapshot->committed;
+  }
+  return size;
+}
+
+bool ncGetLatestPresentation(NeuroonSignalProcessingState *data,
+                             ncBrainWaveLevels *bwBuffer, int *bwSize,
+                             double *heartRate, double *pulseBuffer,
+                             int *pulseSize) {
+  std::shared_ptr<const PresentationSnapshot> snapshot =
+      data->_presentation_snapshot->_snapshot.latest();
+  if (!snapshot) {
+    *bwSize = 0;
+    *pulseSize = 0;
+    return false;
+  }
+
+  // the most recent elements are at the ends
+  int bw_count = std::min<int>(std::max(0, *bwSize), snapshot->brain_waves.size());
+  std::copy(snapshot->brain_waves.end() - bw_count, snapshot->brain_waves.end(),
+            bwBuffer);
+  *bwSize = bw_count;
+
+  int pulse_count = std::min<int>(std::max(0, *pulseSize), snapshot->pulse_data.size());
+  std::copy(snapshot->pulse_data.end() - pulse_count, snapshot->pulse_data.end(),
+            pulseBuffer);
+  *pulseSize = pulse_count;
+
+  *heartRate = snapshot->heart_rate;
+  return true;
+}
+
 bool ncInstallLogCallback(NeuroonSignalProcessingState *data,
                           ncLoggerCallback callback) {
   LOG(INFO) << "API CALL";
@@ -215,6 +358,54 @@ bool ncInstallLogCallback(NeuroonSignalProcessingState *data,
   return true;
 }
 
+bool ncInstallSynchronousLogCallback(NeuroonSignalProcessingState *data,
+                                     ncLoggerCallback callback) {
+  LOG(INFO) << "API CALL";
+  configure_logger(callback, true);
+  LOG(INFO) << "API CALL END";
+  return true;
+}
+
+bool ncFlushLogs(NeuroonSignalProcessingState *data) {
+  flush_logs();
+  return true;
+}
+
+bool ncEnableDiagnostics(NeuroonSignalProcessingState *data, bool enabled,
+                         unsigned int sampleEvery) {
+#ifdef NC_DIAGNOSTICS
+  if (enabled) {
+    Diagnostics::reset();
+    Diagnostics::set_sample_every(sampleEvery);
+    Diagnostics::set_enabled(true);
+  } else if (Diagnostics::enabled()) {
+    Diagnostics::set_enabled(false);
+    Diagnostics::report();
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+int ncGetPerformanceStats(NeuroonSignalProcessingState *data,
+                          ncPerformanceStats *buffer, int bufferSize) {
+  std::vector<PerformanceCounters::StageStats> stats =
+      PerformanceCounters::stats();
+
+  int count = std::min<int>(std::max(0, bufferSize), stats.size());
+  for (int i = 0; i != count; ++i) {
+    buffer[i] = PerformanceCounters::summary(
+        static_cast<ncPerformanceStage>(i), stats[i]);
+  }
+  return stats.size();
+}
+
+bool ncResetPerformanceStats(NeuroonSignalProcessingState *data) {
+  PerformanceCounters::reset();
+  return true;
+}
+
 bool ncStartPresentation(NeuroonSignalProcessingState *data) {
   LOG(INFO) << "API CALL";
 
@@ -227,6 +418,19 @@ bool ncStartPresentation(NeuroonSignalProcessingState *data) {
   return true;
 }
 
+bool ncSetPresentationMaxRate(NeuroonSignalProcessingState *data,
+                              double callsPerSecond) {
+  LOG(INFO) << "API CALL";
+
+  if (!data->_online_presentation || !(callsPerSecond >= 0)) {
+    return false;
+  }
+
+  data->_online_presentation->set_max_results_rate(callsPerSecond);
+  LOG(INFO) << "API CALL END";
+  return true;
+}
+
 bool ncStopPresentation(NeuroonSignalProcessingState *data) {
   LOG(INFO) << "API CALL";
 
@@ -11,11 +11,16 @@
 
 // -------------- PUBLIC API -----------------------
 
+NeuroonSignals::NeuroonSignals()
+  : _actigraphy(_signal_specs.at(SignalOrigin::ACCELEROMETER).sampling_rate()) {}
+
 const std::vector<double> & NeuroonSignals::eeg_signal() const { return SIGNAL_VEC(_eeg_signal); }
 const std::vector<double> & NeuroonSignals::ir_led_signal() const { return SIGNAL_VEC(_ir_led_signal); }
 const std::vector<double> & NeuroonSignals::red_led_signal() const { return SIGNAL_VEC(_red_led_signal); }
 const std::vector<Double3d> & NeuroonSignals::accel_axes_signal() const { return SIGNAL_VEC(_accel_axes_signal); }
 const std::vector<double> & NeuroonSignals::temperature_signal() const { return SIGNAL_VEC(_temperature_signal); }
+const std::vector<Double3d> & NeuroonSignals::accel_axes_high_passed_signal() const { return _accel_axes_high_passed_signal; }
+const Actigraphy::Totals & NeuroonSignals::movement_totals() const { return _actigraphy.totals(); }
 
 
 void NeuroonSignals::clear_data(){
@@ -24,6 +29,37 @@ void NeuroonSignals::clear_data(){
   _red_led_signal = std::make_tuple(0,0,std::vector<double>());
   _accel_axes_signal = std::make_tuple(0,0,std::vector<Double3d>());
   _temperature_signal = std::make_tuple(0,0,std::vector<double>());
+  _actigraphy.reset();
+  _accel_axes_high_passed_signal.clear();
+
+  for (auto & channel : _decimated_eeg) {
+    channel.second.decimator.reset();
+    channel.second.total_count = 0;
+    channel.second.signal.clear();
+  }
+}
+
+void NeuroonSignals::add_decimated_eeg(int factor){
+  if (_decimated_eeg.count(factor) != 0) {
+    return;
+  }
+  _decimated_eeg.insert(std::make_pair(factor, DecimatedEeg{PolyphaseDecimator(factor), 0, {}}));
+}
+
+const std::vector<double> & NeuroonSignals::decimated_eeg_signal(int factor) const {
+  auto channel = _decimated_eeg.find(factor);
+  if (channel == _decimated_eeg.end()) {
+    throw std::logic_error("EEG decimated by this factor not added");
+  }
+  return channel->second.signal;
+}
+
+std::size_t NeuroonSignals::total_decimated_eeg_samples(int factor) const {
+  auto channel = _decimated_eeg.find(factor);
+  if (channel == _decimated_eeg.end()) {
+    throw std::logic_error("EEG decimated by this factor not added");
+  }
+  return channel->second.total_count;
 }
 
 ullong NeuroonSignals::last_timestamp(SignalOrigin so) const {
@@ -83,6 +119,13 @@ void NeuroonSignals::consume(std::shared_ptr<EegFrame> frame){
   // insert new data
   signal.insert(signal.end(),frame->signal, frame->signal + frame->Length);
   TOTAL_COUNT(_eeg_signal) += signal.size() - old_sz;
+
+  for (auto & channel : _decimated_eeg) {
+    auto & decimated = channel.second;
+    auto decimated_old_sz = decimated.signal.size();
+    decimated.decimator.process(signal.data() + old_sz, signal.size() - old_sz, decimated.signal);
+    decimated.total_count += decimated.signal.size() - decimated_old_sz;
+  }
   LAST_TS(_eeg_signal) = frame->timestamp + std::max(static_cast<std::size_t>(0), frame->Length - 1) * ms_per_sample;
 }
 
@@ -125,6 +168,9 @@ void NeuroonSignals::consume(std::shared_ptr<PatFrame> frame){
       (double)frame->accel_axes.z});
   temperature_signal.push_back((double) std::max(frame->temperature[0],frame->temperature[1]));
 
+  _actigraphy.consume(accel_axes_signal.back());
+  _accel_axes_high_passed_signal.push_back(_actigraphy.high_passed());
+
 
   TOTAL_COUNT(_ir_led_signal) += ir_signal.size() - ir_old_sz;
   LAST_TS(_ir_led_signal) = frame->timestamp;
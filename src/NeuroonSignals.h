@@ -7,10 +7,13 @@
 #include <memory>
 #include <functional>
 #include <tuple>
+#include <stdexcept>
 #include "VectorView.h"
 #include "DataSink.h"
 #include "NeuroonSignalFrames.h"
 #include "SignalTypes.h"
+#include "PolyphaseDecimator.h"
+#include "Actigraphy.h"
 
 
 class INeuroonSignals {
@@ -30,6 +33,29 @@ public:
   // samples. The implementation may change as we might want not to store all the samples
   // in the vectors.
   virtual std::size_t total_signal_samples(SignalOrigin ss) const = 0;
+
+  // EEG low-pass filtered and decimated by the factor, i.e. sampled at
+  // 125 / factor Hz; only the factors requested by the algorithms
+  // (see IStreamingAlgorithm::eeg_decimations) are available
+  virtual const std::vector<double> & decimated_eeg_signal(int factor) const {
+    throw std::logic_error("decimated EEG not available");
+  }
+  virtual std::size_t total_decimated_eeg_samples(int factor) const {
+    throw std::logic_error("decimated EEG not available");
+  }
+
+  // the accelerometer axes with gravity (everything below ~0.25 Hz)
+  // filtered out, sample by sample as in accel_axes_signal
+  virtual const std::vector<Double3d> & accel_axes_high_passed_signal() const {
+    throw std::logic_error("high-passed accelerometer not available");
+  }
+
+  // the movement totals of the accelerometer signal received so far,
+  // see Actigraphy; no movement without the accelerometer
+  virtual const Actigraphy::Totals & movement_totals() const {
+    static const Actigraphy::Totals no_movement = {0, 0, 0};
+    return no_movement;
+  }
 };
 
 class NeuroonSignals : public INeuroonSignals, public IDataSinkSp<EegFrame>, public IDataSinkSp<PatFrame>{
@@ -63,6 +89,20 @@ private:
   std::tuple<std::size_t, ullong, std::vector<Double3d>> _accel_axes_signal = {};
   std::tuple<std::size_t, ullong, std::vector<double>> _temperature_signal = {};
 
+  // derived EEG channels by the decimation factor, each sample
+  // is decimated once, when it arrives
+  struct DecimatedEeg {
+    PolyphaseDecimator decimator;
+    std::size_t total_count;
+    std::vector<double> signal;
+  };
+  std::map<int, DecimatedEeg> _decimated_eeg = {};
+
+  // filters the three accelerometer axes and sums the movement
+  // as the frames arrive
+  Actigraphy _actigraphy;
+  std::vector<Double3d> _accel_axes_high_passed_signal = {};
+
 
   void _add_new_vector_data(SignalOrigin origin, llong timestamp, std::vector<double>& v);
 
@@ -77,7 +117,7 @@ private:
 
 public:
 
-  NeuroonSignals() {}
+  NeuroonSignals();
 
   // clears so far collected signals
   void clear_data();
@@ -94,6 +134,10 @@ public:
     _accelledstemp_lost_frame_hole_filling_function = fun;
   }
 
+  // adds the EEG channel decimated by the factor, nothing is done
+  // if it's already there
+  void add_decimated_eeg(int factor);
+
   // consumes a frame converting it to signal vectors
   void consume(std::shared_ptr<EegFrame> frame) override;
   void consume(std::shared_ptr<PatFrame> frame) override;
@@ -120,6 +164,12 @@ public:
   // in the vectors.
   std::size_t total_signal_samples(SignalOrigin ss) const override;
 
+  const std::vector<Double3d> & accel_axes_high_passed_signal() const override;
+  const Actigraphy::Totals & movement_totals() const override;
+
+  const std::vector<double> & decimated_eeg_signal(int factor) const override;
+  std::size_t total_decimated_eeg_samples(int factor) const override;
+
 };
 
 #endif
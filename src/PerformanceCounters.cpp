@@ -0,0 +1,226 @@
+/*
+ * PerformanceCounters.cpp
+ */
+
+#include "PerformanceCounters.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace {
+
+typedef unsigned long long ullong;
+
+/*
+ * The counters of a single thread. Only the owning thread writes them,
+ * the atomics (with relaxed plain loads and stores) only make
+ * the concurrent reads in stats() well defined.
+ */
+struct ThreadCounters {
+	struct Stage {
+		std::atomic<ullong> calls;
+		std::atomic<ullong> total_ns;
+		std::atomic<ullong> max_ns;
+		std::atomic<ullong> histogram[PerformanceCounters::BUCKETS];
+	};
+
+	// the reset generation the counters belong to
+	std::atomic<unsigned> generation;
+	Stage stages[NC_PERF_STAGES_COUNT];
+
+	explicit ThreadCounters(unsigned generation) {
+		clear(generation);
+	}
+
+	void clear(unsigned new_generation) {
+		for (Stage& stage : stages) {
+			stage.calls.store(0, std::memory_order_relaxed);
+			stage.total_ns.store(0, std::memory_order_relaxed);
+			stage.max_ns.store(0, std::memory_order_relaxed);
+			for (auto& count : stage.histogram) {
+				count.store(0, std::memory_order_relaxed);
+			}
+		}
+		generation.store(new_generation, std::memory_order_release);
+	}
+
+	void add_to(std::vector<PerformanceCounters::StageStats>& stats) const {
+		for (int s = 0; s != NC_PERF_STAGES_COUNT; ++s) {
+			const Stage& stage = stages[s];
+			PerformanceCounters::StageStats& sum = stats[s];
+			sum.calls += stage.calls.load(std::memory_order_relaxed);
+			sum.total_ns += stage.total_ns.load(std::memory_order_relaxed);
+			sum.max_ns = std::max(sum.max_ns, stage.max_ns.load(std::memory_order_relaxed));
+			for (int b = 0; b != PerformanceCounters::BUCKETS; ++b) {
+				sum.histogram[b] += stage.histogram[b].load(std::memory_order_relaxed);
+			}
+		}
+	}
+};
+
+void increase(std::atomic<ullong>& counter, ullong value) {
+	counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+/*
+ * The counters of the running threads, and the sums of the finished ones
+ */
+struct Registry {
+	std::mutex mutex;
+	std::atomic<unsigned> generation;
+	std::vector<ThreadCounters*> threads;
+	std::vector<PerformanceCounters::StageStats> finished;
+
+	Registry()
+	: generation(0)
+	, finished(empty_stats())
+	{}
+
+	static std::vector<PerformanceCounters::StageStats> empty_stats() {
+		PerformanceCounters::StageStats empty = {0, 0, 0, std::vector<ullong>(PerformanceCounters::BUCKETS, 0)};
+		return std::vector<PerformanceCounters::StageStats>(NC_PERF_STAGES_COUNT, empty);
+	}
+};
+
+Registry& registry() {
+	static Registry instance;
+	return instance;
+}
+
+/*
+ * Registers the counters of a thread on its first measurement,
+ * and moves them to the finished ones when the thread ends
+ */
+struct ThreadCountersHandle {
+	std::unique_ptr<ThreadCounters> counters;
+
+	ThreadCounters& get() {
+		if (!counters) {
+			Registry& r = registry();
+			std::lock_guard<std::mutex> lock(r.mutex);
+			counters.reset(new ThreadCounters(r.generation.load(std::memory_order_relaxed)));
+			r.threads.push_back(counters.get());
+		}
+		return *counters;
+	}
+
+	~ThreadCountersHandle() {
+		if (!counters) {
+			return;
+		}
+		Registry& r = registry();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		if (counters->generation.load(std::memory_order_acquire) == r.generation.load(std::memory_order_relaxed)) {
+			counters->add_to(r.finished);
+		}
+		r.threads.erase(std::find(r.threads.begin(), r.threads.end(), counters.get()));
+	}
+};
+
+thread_local ThreadCountersHandle thread_counters;
+
+}
+
+const int PerformanceCounters::SUB_BUCKET_BITS;
+const int PerformanceCounters::SUB_BUCKETS;
+const int PerformanceCounters::MAX_EXPONENT;
+const int PerformanceCounters::BUCKETS;
+
+void PerformanceCounters::record(ncPerformanceStage stage, unsigned long long nanoseconds) {
+	ThreadCounters& counters = thread_counters.get();
+
+	unsigned generation = registry().generation.load(std::memory_order_relaxed);
+	if (counters.generation.load(std::memory_order_relaxed) != generation) {
+		counters.clear(generation);
+	}
+
+	ThreadCounters::Stage& counted = counters.stages[stage];
+	increase(counted.calls, 1);
+	increase(counted.total_ns, nanoseconds);
+	if (nanoseconds > counted.max_ns.load(std::memory_order_relaxed)) {
+		counted.max_ns.store(nanoseconds, std::memory_order_relaxed);
+	}
+	increase(counted.histogram[bucket(nanoseconds)], 1);
+}
+
+std::vector<PerformanceCounters::StageStats> PerformanceCounters::stats() {
+	Registry& r = registry();
+	std::lock_guard<std::mutex> lock(r.mutex);
+
+	unsigned generation = r.generation.load(std::memory_order_relaxed);
+	std::vector<StageStats> result = r.finished;
+	for (const ThreadCounters* counters : r.threads) {
+		// the threads which haven't recorded anything since the reset
+		// still hold the old counters
+		if (counters->generation.load(std::memory_order_acquire) == generation) {
+			counters->add_to(result);
+		}
+	}
+	return result;
+}
+
+void PerformanceCounters::reset() {
+	Registry& r = registry();
+	std::lock_guard<std::mutex> lock(r.mutex);
+	r.finished = Registry::empty_stats();
+	r.generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+ncPerformanceStats PerformanceCounters::summary(ncPerformanceStage stage, const StageStats& stats) {
+	const double NS_PER_MS = 1e6;
+
+	ncPerformanceStats result;
+	result.stage = stage;
+	result.calls = stats.calls;
+	result.total_ms = stats.total_ns / NS_PER_MS;
+	result.max_ms = stats.max_ns / NS_PER_MS;
+	result.p50_ms = percentile(stats, 0.5) / NS_PER_MS;
+	result.p90_ms = percentile(stats, 0.9) / NS_PER_MS;
+	result.p99_ms = percentile(stats, 0.99) / NS_PER_MS;
+	return result;
+}
+
+unsigned long long PerformanceCounters::percentile(const StageStats& stats, double fraction) {
+	ullong total = 0;
+	for (ullong count : stats.histogram) {
+		total += count;
+	}
+	if (total == 0) {
+		return 0;
+	}
+
+	// the rank of the percentile among the recorded times, counting from 1
+	ullong rank = std::max<ullong>(1, static_cast<ullong>(fraction * total + 0.5));
+	ullong seen = 0;
+	for (int b = 0; b != BUCKETS; ++b) {
+		seen += stats.histogram[b];
+		if (seen >= rank) {
+			return std::min(bucket_upper_bound(b), stats.max_ns);
+		}
+	}
+	return stats.max_ns;
+}
+
+int PerformanceCounters::bucket(unsigned long long nanoseconds) {
+	if (nanoseconds < static_cast<ullong>(SUB_BUCKETS)) {
+		return static_cast<int>(nanoseconds);
+	}
+
+	int exponent = 63 - __builtin_clzll(nanoseconds);
+	if (exponent >= MAX_EXPONENT) {
+		return BUCKETS - 1;
+	}
+	int shift = exponent - SUB_BUCKET_BITS;
+	int sub_bucket = static_cast<int>(nanoseconds >> shift) - SUB_BUCKETS;
+	return (shift + 1) * SUB_BUCKETS + sub_bucket;
+}
+
+unsigned long long PerformanceCounters::bucket_upper_bound(int bucket) {
+	if (bucket < SUB_BUCKETS) {
+		return bucket;
+	}
+	int shift = bucket / SUB_BUCKETS - 1;
+	ullong lowest = static_cast<ullong>(SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+	return lowest + (1ull << shift) - 1;
+}
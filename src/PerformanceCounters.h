@@ -0,0 +1,103 @@
+/*
+ * PerformanceCounters.h
+ *
+ * The execution times of the stages of the processing, see ncPerformanceStage.
+ */
+
+#ifndef SRC_PERFORMANCECOUNTERS_H_
+#define SRC_PERFORMANCECOUNTERS_H_
+
+#include <chrono>
+#include <vector>
+#include "NeuroonApiCommons.h"
+
+/**
+ * Collects the numbers of calls, the total and the maximal execution times
+ * and the histograms of the execution times of the stages.
+ *
+ * Every thread accumulates into its own counters, which only that thread
+ * writes, so recording a measurement takes no locks and no atomic
+ * read-modify-write operations. The counters of all the threads (including
+ * the finished ones) are summed when the statistics are read.
+ *
+ * The histograms are log-linear, like the HDR histograms: every power of 2
+ * of nanoseconds is split into SUB_BUCKETS buckets, so the relative
+ * precision is 1 / SUB_BUCKETS over the whole range.
+ */
+class PerformanceCounters {
+public:
+	static const int SUB_BUCKET_BITS = 3;
+	static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+
+	// the times are recorded up to 2^MAX_EXPONENT ns (~69 s), the longer ones
+	// fall into the last bucket
+	static const int MAX_EXPONENT = 36;
+	static const int BUCKETS = (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+	struct StageStats {
+		unsigned long long calls;
+		unsigned long long total_ns;
+		unsigned long long max_ns;
+		std::vector<unsigned long long> histogram;
+	};
+
+	/**
+	 * Records a single execution of the stage on the calling thread
+	 */
+	static void record(ncPerformanceStage stage, unsigned long long nanoseconds);
+
+	/**
+	 * @return the statistics of all the stages, indexed by ncPerformanceStage
+	 */
+	static std::vector<StageStats> stats();
+
+	/**
+	 * Zeroes the statistics of all the threads. Each thread clears its
+	 * own counters when it records the next measurement.
+	 */
+	static void reset();
+
+	/**
+	 * @return the ncPerformanceStats of a stage, with the times in milliseconds
+	 */
+	static ncPerformanceStats summary(ncPerformanceStage stage, const StageStats& stats);
+
+	/**
+	 * @return the smallest time (in ns) which is greater or equal to
+	 * the given fraction of the recorded times, up to the bucket precision
+	 */
+	static unsigned long long percentile(const StageStats& stats, double fraction);
+
+	static int bucket(unsigned long long nanoseconds);
+
+	/**
+	 * @return the greatest time (in ns) falling into the bucket
+	 */
+	static unsigned long long bucket_upper_bound(int bucket);
+};
+
+/**
+ * Records the time from its construction to its destruction
+ * as an execution of the stage
+ */
+class ScopedPerformanceTimer {
+	ncPerformanceStage m_stage;
+	std::chrono::steady_clock::time_point m_start;
+
+public:
+	explicit ScopedPerformanceTimer(ncPerformanceStage stage)
+	: m_stage(stage)
+	, m_start(std::chrono::steady_clock::now())
+	{}
+
+	~ScopedPerformanceTimer() {
+		auto elapsed = std::chrono::steady_clock::now() - m_start;
+		PerformanceCounters::record(m_stage,
+				std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+	}
+
+	ScopedPerformanceTimer(const ScopedPerformanceTimer&) = delete;
+	ScopedPerformanceTimer& operator=(const ScopedPerformanceTimer&) = delete;
+};
+
+#endif /* SRC_PERFORMANCECOUNTERS_H_ */
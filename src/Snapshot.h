@@ -0,0 +1,36 @@
+#ifndef __SNAPSHOT__
+#define __SNAPSHOT__
+
+#include <memory>
+
+/**
+ * The latest value published by one thread for readers on other threads.
+ *
+ * Each published value is immutable, publishing replaces the pointer with
+ * a single atomic store, and a reader gets a shared_ptr keeping its snapshot
+ * alive and consistent however long it uses it, while newer values are
+ * published in the meantime. Neither side waits for the other to finish
+ * copying the data.
+ */
+template<class T>
+class Snapshot {
+  std::shared_ptr<const T> _value;
+
+public:
+  void publish(std::shared_ptr<const T> value) {
+    std::atomic_store(&_value, std::move(value));
+  }
+
+  /**
+   * @return the latest published value, nullptr if nothing was published yet
+   */
+  std::shared_ptr<const T> latest() const {
+    return std::atomic_load(&_value);
+  }
+
+  void clear() {
+    publish(nullptr);
+  }
+};
+
+#endif
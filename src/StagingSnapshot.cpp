@@ -0,0 +1,70 @@
+#include "StagingSnapshot.h"
+#include <algorithm>
+#include "OnlineStagingAlgorithm.h"
+
+const std::size_t StagingSnapshot::CHUNK_SIZE;
+
+const ncStagingElement &StagingSnapshot::at(std::size_t index) const {
+  std::size_t chunked = chunks.size() * CHUNK_SIZE;
+  if (index < chunked) {
+    return (*chunks[index / CHUNK_SIZE])[index % CHUNK_SIZE];
+  }
+  return tail[index - chunked];
+}
+
+std::size_t StagingSnapshot::copy_to(ncStagingElement *buffer,
+                                     std::size_t capacity) const {
+  std::size_t copied = 0;
+  for (const chunk_t &chunk : chunks) {
+    std::size_t count = std::min(CHUNK_SIZE, capacity - copied);
+    std::copy(chunk->begin(), chunk->begin() + count, buffer + copied);
+    copied += count;
+    if (copied == capacity) {
+      return copied;
+    }
+  }
+  std::size_t count = std::min(tail.size(), capacity - copied);
+  std::copy(tail.begin(), tail.begin() + count, buffer + copied);
+  return copied + count;
+}
+
+std::shared_ptr<const StagingSnapshot>
+StagingSnapshot::apply(const StagingSnapshot *previous,
+                       const SleepStagingResult &delta) {
+  auto next = std::make_shared<StagingSnapshot>();
+  next->committed = delta.m_committed;
+
+  const std::size_t total = delta.m_total_size;
+  const std::size_t first = delta.m_first_index;
+  const std::size_t committed = std::min(delta.m_committed, total);
+
+  // the chunks before the first changed element stay shared, e.g. all of
+  // them unless the staging was reset
+  if (previous != nullptr) {
+    std::size_t kept = std::min(previous->chunks.size(),
+                                std::min(first, committed) / CHUNK_SIZE);
+    next->chunks.assign(previous->chunks.begin(),
+                        previous->chunks.begin() + kept);
+  }
+
+  // the unchanged elements after the chunks, followed by the delta
+  const std::size_t start = next->chunks.size() * CHUNK_SIZE;
+  std::vector<ncStagingElement> elements;
+  elements.reserve(total - start);
+  for (std::size_t i = start; i != first; ++i) {
+    elements.push_back(previous != nullptr && i < previous->size()
+                           ? previous->at(i)
+                           : ncStagingElement());
+  }
+  elements.insert(elements.end(), delta.m_stages.begin(), delta.m_stages.end());
+
+  // the newly committed elements are moved to new chunks
+  std::size_t offset = 0;
+  while (start + offset + CHUNK_SIZE <= committed) {
+    next->chunks.push_back(std::make_shared<const std::vector<ncStagingElement>>(
+        elements.begin() + offset, elements.begin() + offset + CHUNK_SIZE));
+    offset += CHUNK_SIZE;
+  }
+  next->tail.assign(elements.begin() + offset, elements.end());
+  return next;
+}
@@ -0,0 +1,49 @@
+#ifndef __STAGING_SNAPSHOT__
+#define __STAGING_SNAPSHOT__
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "NeuroonSignalStreamApi.h"
+
+class SleepStagingResult;
+
+/**
+ * An immutable copy of the whole staging, published for ncGetLatestStaging.
+ *
+ * The committed elements, which don't change anymore, are kept in chunks of
+ * CHUNK_SIZE elements shared by the consecutive snapshots, only the elements
+ * after the last full chunk are copied into each one. So publishing a step
+ * copies less than CHUNK_SIZE elements plus the ones not yet committed,
+ * and the pointers to the chunks, instead of the whole night.
+ */
+struct StagingSnapshot {
+  static const std::size_t CHUNK_SIZE = 256;
+
+  typedef std::shared_ptr<const std::vector<ncStagingElement>> chunk_t;
+
+  std::vector<chunk_t> chunks;
+  std::vector<ncStagingElement> tail;
+  std::size_t committed = 0;
+
+  std::size_t size() const { return chunks.size() * CHUNK_SIZE + tail.size(); }
+
+  const ncStagingElement &at(std::size_t index) const;
+
+  /**
+   * Copies the first elements of the staging, at most capacity of them
+   * @return the number of the elements copied
+   */
+  std::size_t copy_to(ncStagingElement *buffer, std::size_t capacity) const;
+
+  /**
+   * @param previous : the snapshot the delta applies to, nullptr before the
+   * first one
+   * @return the snapshot of the staging updated with the delta, sharing
+   * the chunks of the previous one which the delta doesn't change
+   */
+  static std::shared_ptr<const StagingSnapshot>
+  apply(const StagingSnapshot *previous, const SleepStagingResult &delta);
+};
+
+#endif
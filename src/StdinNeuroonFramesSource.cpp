@@ -36,28 +36,22 @@ void StdinNeuroonFramesSource::_readerAction() {
       break;
     }
     default: {
-      std::cerr << "\ninvalid frame id";
-      std::fflush(stdout);
+      DIAG_COUNT("stdin_frames.invalid_frame_id");
       finish = false;
       break;
     }
     }
     _reader_should_stop = _reader_should_stop || finish;
   }
-  std::cerr << "reader action stopped";
-  std::fflush(stdout);
+  DIAG_COUNT("stdin_frames.reader_stopped");
 }
 
 void StdinNeuroonFramesSource::startStreaming() {
-  std::cerr << "startsteaming";
-  std::fflush(stdout);
   if (!this->_reader_should_stop && _reader) {
-    std::cerr << "startsteaming failed";
-    std::fflush(stdout);
+    // already streaming
     return;
   } else if (_reader) {
-    std::cerr << "startsteaming continued";
-    std::fflush(stdout);
+    DIAG_COUNT("stdin_frames.restarted");
     this->_reader_should_stop = true;
     if (_reader->joinable()) {
       _reader->join();
@@ -66,8 +60,7 @@ void StdinNeuroonFramesSource::startStreaming() {
     _reader = nullptr;
     this->_reader_should_stop = false;
   } else {
-    std::cerr << "startsteaming success";
-    std::fflush(stdout);
+    DIAG_COUNT("stdin_frames.started");
     this->_reader_should_stop = false;
     _reader = new std::thread(&StdinNeuroonFramesSource::_readerAction, this);
   }
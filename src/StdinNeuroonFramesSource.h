@@ -8,6 +8,7 @@
 #include <thread>
 #include "DataSink.h"
 #include "DataSource.h"
+#include "Diagnostics.h"
 
 #include "NeuroonSignalFrames.h"
 
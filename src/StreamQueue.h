@@ -3,7 +3,7 @@
 
 #include "DataSink.h"
 #include "DataSource.h"
-#include <iostream>
+#include "Diagnostics.h"
 
 template <typename T>
 class StreamQueue : public IDataSinkSp<T>, public IPullingDataSourceSp<T> {
@@ -22,7 +22,6 @@ public:
 
   virtual void
   setDataSourceDelegate(SinkSetDelegateKey, std::weak_ptr<IDataSourceDelegate> delegate) override {
-    std::fflush(stdout);
     _source_delegate = delegate;
   }
 
@@ -37,8 +36,8 @@ public:
     if (auto delsp = _source_delegate.lock()) {
       return delsp->isDepleted();
     }
-    std::cerr <<"damn..";
-    std::fflush(stdout);
+    // the source is gone, so nothing more will arrive
+    DIAG_COUNT("stream_queue.no_source");
     return true;
   }
 
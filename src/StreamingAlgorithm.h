@@ -4,6 +4,7 @@
 #include <vector>
 #include "NeuroonSignals.h"
 #include "DataSink.h"
+#include "PerformanceCounters.h"
 
 class IStreamingAlgorithm{
 public:
@@ -11,6 +12,10 @@ public:
   virtual void reset_state () = 0;
   virtual void process_input (const INeuroonSignals & input ) = 0;
   virtual void end_streaming (const INeuroonSignals & input) = 0;
+
+  // the factors of the decimated EEG channels the algorithm reads,
+  // see INeuroonSignals::decimated_eeg_signal
+  virtual std::vector<int> eeg_decimations() const { return {}; }
 };
 
 
@@ -22,6 +27,7 @@ class SinkStreamingAlgorithm : public IStreamingAlgorithm {
 protected:
 
   void feed_all_sinks(T result){
+    ScopedPerformanceTimer timer(NC_PERF_SINKS);
     for(auto & s : _sinks){
       if(s != nullptr){
         s->consume(result);
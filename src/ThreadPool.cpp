@@ -0,0 +1,50 @@
+/*
+ * ThreadPool.cpp
+ */
+
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(unsigned int threads)
+: m_stopping(false)
+{
+	for (unsigned int i = 0; i != threads; ++i) {
+		m_workers.emplace_back(&ThreadPool::work, this);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+	m_task_available.notify_all();
+	for (std::thread& worker : m_workers) {
+		worker.join();
+	}
+}
+
+unsigned int ThreadPool::size() const {
+	return m_workers.size();
+}
+
+unsigned int ThreadPool::hardware_threads() {
+	unsigned int threads = std::thread::hardware_concurrency();
+	return threads > 0 ? threads : 1;
+}
+
+void ThreadPool::work() {
+	while (true) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_task_available.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+			if (m_tasks.empty()) {
+				// stopping and nothing left to do
+				return;
+			}
+			task = std::move(m_tasks.front());
+			m_tasks.pop();
+		}
+		task();
+	}
+}
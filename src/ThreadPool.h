@@ -0,0 +1,93 @@
+/*
+ * ThreadPool.h
+ *
+ * A fixed-size pool of worker threads executing the submitted tasks
+ * in the order of submission.
+ */
+
+#ifndef SRC_THREADPOOL_H_
+#define SRC_THREADPOOL_H_
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Executes tasks on a fixed number of worker threads. The results (and the
+ * exceptions thrown by the tasks) are passed back through std::futures, so
+ * dependencies between the tasks are expressed by waiting for the futures
+ * on the thread that submits the dependent tasks.
+ *
+ * The tasks must not wait for other tasks submitted to the same pool,
+ * as that can deadlock when all the workers are waiting.
+ *
+ * A pool with zero threads executes the tasks synchronously inside submit(),
+ * which gives the same order of execution as a plain serial code.
+ */
+class ThreadPool {
+public:
+	/**
+	 * @param threads : the number of worker threads, 0 means executing
+	 * the tasks on the calling thread.
+	 */
+	explicit ThreadPool(unsigned int threads);
+
+	/**
+	 * Waits for all the submitted tasks to finish and joins the workers.
+	 */
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	template <typename F>
+	std::future<typename std::result_of<F()>::type> submit(F task);
+
+	/**
+	 * @return the number of worker threads
+	 */
+	unsigned int size() const;
+
+	/**
+	 * @return the number of hardware threads, at least 1
+	 */
+	static unsigned int hardware_threads();
+
+private:
+	void work();
+
+	std::vector<std::thread> m_workers;
+	std::queue<std::function<void()>> m_tasks;
+	std::mutex m_mutex;
+	std::condition_variable m_task_available;
+	bool m_stopping;
+};
+
+template <typename F>
+std::future<typename std::result_of<F()>::type> ThreadPool::submit(F task) {
+	typedef typename std::result_of<F()>::type result_type;
+
+	// std::function requires copyable callables, hence the shared_ptr
+	auto packaged = std::make_shared<std::packaged_task<result_type()>>(std::move(task));
+	std::future<result_type> result = packaged->get_future();
+
+	if (m_workers.empty()) {
+		(*packaged)();
+		return result;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_tasks.push([packaged]() { (*packaged)(); });
+	}
+	m_task_available.notify_one();
+	return result;
+}
+
+#endif /* SRC_THREADPOOL_H_ */
@@ -4,11 +4,15 @@ ONCE_PER_APP_INITIALIZE_LOGGER
 
 FunctionPointerCallback::f_pointer FunctionPointerCallback::_callback = nullptr;
 
+AsyncLogger& async_logger() {
+	static AsyncLogger logger(nullptr);
+	return logger;
+}
+
 //template<typename T=FunctionPointerCallback>
-void configure_logger(FunctionPointerCallback::f_pointer callback) {
+void configure_logger(FunctionPointerCallback::f_pointer callback, bool synchronous) {
 	FunctionPointerCallback::_callback = callback;
 
-	el::Helpers::installLogDispatchCallback<FunctionPointerCallback>("default");
 	el::Loggers::addFlag(el::LoggingFlag::ColoredTerminalOutput);
 
 	// el::Loggers::reconfigureAllLoggers(el::ConfigurationType::Format, "%datetime %level %logger %fbase:%line  %msg");
@@ -16,6 +20,34 @@ void configure_logger(FunctionPointerCallback::f_pointer callback) {
   // michal debug
 	// el::Loggers::reconfigureAllLoggers(el::ConfigurationType::Format, "%datetime{%d/%M %h:%m:%s,%g} %level %logger | %func@%fbase:%line\n%msg");
 
+	el::Helpers::uninstallLogDispatchCallback<SynchronousFunctionPointerCallback>("synchronous");
+	if (callback != nullptr && synchronous) {
+		// the messages captured so far go first
+		async_logger().flush();
+		el::Helpers::uninstallLogDispatchCallback<el::base::DefaultLogDispatchCallback>("DefaultLogDispatchCallback");
+		el::Helpers::uninstallLogDispatchCallback<FunctionPointerCallback>("default");
+		el::Helpers::installLogDispatchCallback<SynchronousFunctionPointerCallback>("synchronous");
+	} else if (callback != nullptr) {
+		// the builder is only used for the colors, which are safe to add
+		// on the background thread
+		el::LogBuilder* builder = el::Loggers::getLogger("default")->logBuilder();
+		async_logger().set_sink([builder](int level, const std::string& line) {
+			std::string message = line;
+			builder->convertToColoredOutput(&message, static_cast<el::Level>(level));
+			FunctionPointerCallback::save_log(message);
+		});
+
+		// the default dispatch would format every message on the logging thread
+		el::Helpers::uninstallLogDispatchCallback<el::base::DefaultLogDispatchCallback>("DefaultLogDispatchCallback");
+		el::Helpers::installLogDispatchCallback<FunctionPointerCallback>("default");
+	} else {
+		el::Helpers::uninstallLogDispatchCallback<FunctionPointerCallback>("default");
+		el::Helpers::installLogDispatchCallback<el::base::DefaultLogDispatchCallback>("DefaultLogDispatchCallback");
+	}
+
 	CLOG(INFO, "default") << "Logger initialized";
 }
 
+void flush_logs() {
+	async_logger().flush();
+}
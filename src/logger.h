@@ -11,7 +11,32 @@
  * feel free to change the implementation completely.
  */
 
-#define ELPP_DISABLE_DEBUG_LOGS
+/**
+ * The least severe level which is compiled in. The LOG statements below it
+ * are removed by the preprocessor, e.g. -DNC_LOG_LEVEL=NC_LOG_LEVEL_WARNING
+ * removes all the INFO logs from the hot paths of a release build.
+ */
+#define NC_LOG_LEVEL_DEBUG 0
+#define NC_LOG_LEVEL_INFO 1
+#define NC_LOG_LEVEL_WARNING 2
+#define NC_LOG_LEVEL_ERROR 3
+
+#ifndef NC_LOG_LEVEL
+	#define NC_LOG_LEVEL NC_LOG_LEVEL_INFO
+#endif
+
+#if NC_LOG_LEVEL > NC_LOG_LEVEL_DEBUG
+	#define ELPP_DISABLE_DEBUG_LOGS
+#endif
+#if NC_LOG_LEVEL > NC_LOG_LEVEL_INFO
+	#define ELPP_DISABLE_INFO_LOGS
+#endif
+#if NC_LOG_LEVEL > NC_LOG_LEVEL_WARNING
+	#define ELPP_DISABLE_WARNING_LOGS
+#endif
+#if NC_LOG_LEVEL > NC_LOG_LEVEL_ERROR
+	#define ELPP_DISABLE_ERROR_LOGS
+#endif
 
 #ifndef ANDROID
 	#define ELPP_STACKTRACE_ON_CRASH
@@ -19,50 +44,86 @@
 
 #define ELPP_DEFAULT_LOG_FILE "neuroon-alg-core.log"
 
+// the algorithms log from the tasks of the thread pools too, e.g. the sampled
+// diagnostics traces, and easylogging writes to shared streams
+#define ELPP_THREAD_SAFE
+
 #include "../3rd_party/easylogging/easylogging++.h"
+#include "AsyncLogger.h"
 
+/**
+ * The asynchronous backend shared by all the LoggingCallbacks
+ */
+AsyncLogger& async_logger();
 
 /**
  * You can use such a structure to capture the logs.
  * This may be useful e.g. when using mobile devices
  * where you can't write to a file directly using
  * the C++ standard library
+ *
+ * The records are only captured in handle(), on the logging thread.
+ * They are formatted and passed to the sink of the async_logger()
+ * on its background thread, or in flush_logs().
+ * Note that easylogging has already composed the message on the logging
+ * thread by then, and that the messages are truncated to
+ * LogRecord::MESSAGE_CAPACITY - 1 bytes.
  */
 struct LoggingCallback : public el::LogDispatchCallback {
 
-	std::ofstream* log_file;
-
 	virtual ~LoggingCallback(){}
 
 
 	void handle(const el::LogDispatchData* handlePtr) {
 		const el::LogMessage* logMessage = handlePtr->logMessage();
-		std::string message = logMessage->logger()->logBuilder()->build(logMessage, false);
-		logMessage->logger()->logBuilder()->convertToColoredOutput(&message, logMessage->level());
-
-		save_log(message);
+		async_logger().capture(static_cast<int>(logMessage->level()),
+							   el::LevelHelper::convertToString(logMessage->level()),
+							   logMessage->logger()->id().c_str(),
+							   logMessage->file().c_str(), logMessage->line(),
+							   logMessage->message());
 	}
-
-	virtual void save_log(const std::string& message) = 0;
 };
 
 #define ONCE_PER_APP_INITIALIZE_LOGGER INITIALIZE_EASYLOGGINGPP
 
-struct DummyCallback : public LoggingCallback {
-	virtual void save_log(const std::string& ) {}
-};
-
 struct FunctionPointerCallback : public LoggingCallback {
 
 	typedef void (*f_pointer)(const char*);
 	static f_pointer _callback;
 
-	virtual void save_log(const std::string& message) {
+	static void save_log(const std::string& message) {
 		if (_callback != nullptr) {
 			(*_callback)(message.c_str());
 		}
 	}
 };
 
-void configure_logger(FunctionPointerCallback::f_pointer callback = nullptr);
+/**
+ * Passes every message to the callback right away, on the logging thread,
+ * formatted by easylogging, i.e. without the rate limiting, the dropping
+ * and the truncation of the async_logger()
+ */
+struct SynchronousFunctionPointerCallback : public el::LogDispatchCallback {
+
+	void handle(const el::LogDispatchData* handlePtr) {
+		const el::LogMessage* logMessage = handlePtr->logMessage();
+		std::string message = logMessage->logger()->logBuilder()->build(logMessage, false);
+		logMessage->logger()->logBuilder()->convertToColoredOutput(&message, logMessage->level());
+		FunctionPointerCallback::save_log(message);
+	}
+};
+
+/**
+ * Without a callback the logs are written synchronously to the standard
+ * output and to ELPP_DEFAULT_LOG_FILE, as configured by easylogging.
+ * With a callback they are only captured, and the callback is called
+ * on the background thread of the async_logger(), unless synchronous is true,
+ * then it's called on the logging thread, see SynchronousFunctionPointerCallback.
+ */
+void configure_logger(FunctionPointerCallback::f_pointer callback = nullptr, bool synchronous = false);
+
+/**
+ * Dispatches the pending log records to the callback on the calling thread
+ */
+void flush_logs();
 #endif
@@ -0,0 +1,42 @@
+/*
+ * AcCouplingFilter.cpp
+ */
+
+#include "AcCouplingFilter.h"
+#include <stdexcept>
+
+AcCouplingFilter::AcCouplingFilter(int window)
+: m_window(window > 0 ? window : 0)
+{
+	if (window <= 0) {
+		throw std::logic_error("the window of the AC coupling filter has to be positive");
+	}
+	reset();
+}
+
+void AcCouplingFilter::reset() {
+	m_next = 0;
+	m_size = 0;
+	m_sum = 0;
+}
+
+double AcCouplingFilter::filter(double sample) {
+	const int window = m_window.size();
+	if (m_size == window) {
+		m_sum -= m_window[m_next];
+	} else {
+		++m_size;
+	}
+	m_window[m_next] = sample;
+	m_sum += sample;
+
+	m_next = m_next + 1 == window ? 0 : m_next + 1;
+	if (m_next == 0) {
+		m_sum = 0;
+		for (double value : m_window) {
+			m_sum += value;
+		}
+	}
+
+	return sample - m_sum / m_size;
+}
@@ -0,0 +1,38 @@
+/*
+ * AcCouplingFilter.h
+ */
+
+#ifndef SRC_NUMERICS_ACCOUPLINGFILTER_H_
+#define SRC_NUMERICS_ACCOUPLINGFILTER_H_
+
+#include <vector>
+
+/**
+ * A streaming filter removing the slowly changing (DC) component of a signal
+ * by subtracting the mean of the last 'window' samples (including the current
+ * one) from each sample. Until the window is filled, the mean of the samples
+ * seen so far is used.
+ *
+ * Each sample is processed in O(1): the running sum is updated with the
+ * sample entering and the one leaving the window, and recomputed from
+ * the window whenever it wraps around, so rounding errors don't accumulate.
+ */
+class AcCouplingFilter {
+public:
+	AcCouplingFilter(int window);
+
+	/**
+	 * @return the sample minus the mean of the window
+	 */
+	double filter(double sample);
+
+	void reset();
+
+private:
+	std::vector<double> m_window;
+	int m_next;
+	int m_size;
+	double m_sum;
+};
+
+#endif /* SRC_NUMERICS_ACCOUPLINGFILTER_H_ */
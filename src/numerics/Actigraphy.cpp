@@ -0,0 +1,75 @@
+/*
+ * Actigraphy.cpp
+ */
+
+#include "Actigraphy.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+std::vector<std::vector<Biquad>> actigraphy_filters(double fs) {
+	std::vector<std::vector<Biquad>> filters(3, {Biquad::high_pass(fs, Actigraphy::CUTOFF)});
+	filters.resize(6, {Biquad::low_pass(fs, Actigraphy::CUTOFF)});
+	return filters;
+}
+
+double norm(const Double3d& v) {
+	return std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+}
+
+}
+
+Actigraphy::Actigraphy(double fs)
+: m_settling_samples(static_cast<std::size_t>(SETTLING_SECONDS * fs))
+, m_posture_cos(std::cos(POSTURE_ANGLE_DEGREES * M_PI / 180))
+, m_filters(actigraphy_filters(fs))
+{
+	reset();
+}
+
+void Actigraphy::reset() {
+	m_filters.reset();
+	m_high_passed = {0, 0, 0};
+	m_totals = {0, 0, 0};
+	m_has_posture = false;
+	m_posture = {0, 0, 0};
+	m_posture_settling = 0;
+}
+
+void Actigraphy::consume(const Double3d& sample) {
+	double filtered[6] = {sample.x, sample.y, sample.z, sample.x, sample.y, sample.z};
+	m_filters.process(filtered, 1, filtered);
+	m_high_passed = {filtered[0], filtered[1], filtered[2]};
+	Double3d gravity = {filtered[3], filtered[4], filtered[5]};
+	++m_totals.samples;
+
+	double g = norm(gravity);
+	if (m_totals.samples <= m_settling_samples || !(g > 0)) {
+		return;
+	}
+
+	double movement = norm(m_high_passed) / g;
+	m_totals.energy += movement * movement;
+
+	Double3d direction = {gravity.x / g, gravity.y / g, gravity.z / g};
+	if (!m_has_posture) {
+		m_posture = direction;
+		m_has_posture = true;
+	} else if (m_posture_settling > 0) {
+		// the gravity estimate is still turning towards the new posture
+		m_posture = direction;
+		--m_posture_settling;
+	} else if (direction.x * m_posture.x + direction.y * m_posture.y + direction.z * m_posture.z < m_posture_cos) {
+		m_posture = direction;
+		m_posture_settling = m_settling_samples;
+		++m_totals.posture_changes;
+	}
+}
+
+double Actigraphy::activity_between(const Totals& begin, const Totals& end) {
+	if (end.samples <= begin.samples) {
+		return 0;
+	}
+	return std::sqrt(std::max(0., end.energy - begin.energy) / (end.samples - begin.samples));
+}
@@ -0,0 +1,81 @@
+/*
+ * Actigraphy.h
+ */
+
+#ifndef SRC_NUMERICS_ACTIGRAPHY_H_
+#define SRC_NUMERICS_ACTIGRAPHY_H_
+
+#include <cstddef>
+#include "CommonTypes.h"
+#include "FilterBank.h"
+
+/**
+ * Follows the movements of the subject in the accelerometer signal,
+ * sample by sample, in O(1) per sample.
+ *
+ * Each sample is split into the gravity (low-passed axes) and the movement
+ * (high-passed axes). The squared magnitude of the movement, in units of
+ * the gravity (g), is summed into the energy, and a posture change is counted
+ * whenever the direction of the gravity turns from the last posture by more
+ * than POSTURE_ANGLE_DEGREES. After a change the new posture follows the
+ * gravity for SETTLING_SECONDS, so that a single turn is counted once.
+ * The totals only grow, so the movement in any epoch is the difference
+ * of the totals at its ends, see activity_between().
+ */
+class Actigraphy {
+public:
+	static constexpr double CUTOFF = 0.25;
+	static constexpr double POSTURE_ANGLE_DEGREES = 45;
+
+	// the time the gravity estimate needs to settle before the first posture
+	static constexpr double SETTLING_SECONDS = 5;
+
+	struct Totals {
+		double energy;
+		std::size_t samples;
+		std::size_t posture_changes;
+	};
+
+	/**
+	 * @param fs : the sampling frequency of the accelerometer
+	 */
+	Actigraphy(double fs);
+
+	void consume(const Double3d& sample);
+
+	/**
+	 * @return the last sample without the gravity
+	 */
+	const Double3d& high_passed() const {
+		return m_high_passed;
+	}
+
+	/**
+	 * @return the totals since the beginning or the reset
+	 */
+	const Totals& totals() const {
+		return m_totals;
+	}
+
+	/**
+	 * @return the RMS of the movement in g between two totals, 0 if no samples
+	 */
+	static double activity_between(const Totals& begin, const Totals& end);
+
+	void reset();
+
+private:
+	std::size_t m_settling_samples;
+	double m_posture_cos;
+
+	// the high-pass of the three axes followed by the low-pass of the three axes
+	FilterBank m_filters;
+	Double3d m_high_passed;
+	Totals m_totals;
+
+	bool m_has_posture;
+	Double3d m_posture;
+	std::size_t m_posture_settling;
+};
+
+#endif /* SRC_NUMERICS_ACTIGRAPHY_H_ */
@@ -0,0 +1,65 @@
+/*
+ * Biquad.cpp
+ */
+
+#include "Biquad.h"
+#include <cmath>
+#include <stdexcept>
+
+Biquad::Biquad(double b0, double b1, double b2, double a1, double a2)
+: m_b0(b0), m_b1(b1), m_b2(b2)
+, m_a1(a1), m_a2(a2)
+{
+	reset();
+}
+
+void Biquad::reset() {
+	m_z1 = 0;
+	m_z2 = 0;
+}
+
+namespace {
+
+void check_cutoff(double fs, double cutoff) {
+	if (!(cutoff > 0 && cutoff < fs / 2)) {
+		throw std::logic_error("the cutoff frequency of a biquad has to be between 0 and fs / 2");
+	}
+}
+
+}
+
+Biquad Biquad::low_pass(double fs, double cutoff, double q) {
+	check_cutoff(fs, cutoff);
+	double w0 = 2 * M_PI * cutoff / fs;
+	double alpha = std::sin(w0) / (2 * q);
+	double cos_w0 = std::cos(w0);
+	double a0 = 1 + alpha;
+
+	return Biquad((1 - cos_w0) / 2 / a0, (1 - cos_w0) / a0, (1 - cos_w0) / 2 / a0,
+				  -2 * cos_w0 / a0, (1 - alpha) / a0);
+}
+
+Biquad Biquad::band_pass(double fs, double center, double q) {
+	check_cutoff(fs, center);
+	double w0 = 2 * M_PI * center / fs;
+	double alpha = std::sin(w0) / (2 * q);
+	double cos_w0 = std::cos(w0);
+	double a0 = 1 + alpha;
+
+	return Biquad(alpha / a0, 0, -alpha / a0, -2 * cos_w0 / a0, (1 - alpha) / a0);
+}
+
+Biquad Biquad::identity() {
+	return Biquad(1, 0, 0, 0, 0);
+}
+
+Biquad Biquad::high_pass(double fs, double cutoff, double q) {
+	check_cutoff(fs, cutoff);
+	double w0 = 2 * M_PI * cutoff / fs;
+	double alpha = std::sin(w0) / (2 * q);
+	double cos_w0 = std::cos(w0);
+	double a0 = 1 + alpha;
+
+	return Biquad((1 + cos_w0) / 2 / a0, -(1 + cos_w0) / a0, (1 + cos_w0) / 2 / a0,
+				  -2 * cos_w0 / a0, (1 - alpha) / a0);
+}
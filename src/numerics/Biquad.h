@@ -0,0 +1,67 @@
+/*
+ * Biquad.h
+ */
+
+#ifndef SRC_NUMERICS_BIQUAD_H_
+#define SRC_NUMERICS_BIQUAD_H_
+
+/**
+ * A second order IIR filter (a biquad) in the transposed direct form II,
+ * processing a signal sample by sample in O(1).
+ *
+ * The coefficients of the low-pass, high-pass and band-pass filters follow
+ * the well known 'Audio EQ Cookbook' formulas. To filter many channels at
+ * once, put the biquads in a FilterBank.
+ */
+class Biquad {
+public:
+	static constexpr double BUTTERWORTH_Q = 0.7071067811865476;
+
+	/**
+	 * The coefficients are normalized, i.e. a0 = 1
+	 */
+	Biquad(double b0, double b1, double b2, double a1, double a2);
+
+	/**
+	 * @param fs : the sampling frequency of the signal
+	 * @param cutoff : the cutoff frequency, lower than fs / 2
+	 */
+	static Biquad low_pass(double fs, double cutoff, double q = BUTTERWORTH_Q);
+	static Biquad high_pass(double fs, double cutoff, double q = BUTTERWORTH_Q);
+
+	/**
+	 * A band-pass with the unit gain at the center frequency, passing
+	 * the band between center / k and center * k, where k is about
+	 * 1 + 1 / (2 * q) for narrow bands
+	 */
+	static Biquad band_pass(double fs, double center, double q);
+
+	/**
+	 * A filter passing the signal unchanged
+	 */
+	static Biquad identity();
+
+	double filter(double sample) {
+		double result = m_b0 * sample + m_z1;
+		m_z1 = m_b1 * sample - m_a1 * result + m_z2;
+		m_z2 = m_b2 * sample - m_a2 * result;
+		return result;
+	}
+
+	void reset();
+
+	double b0() const { return m_b0; }
+	double b1() const { return m_b1; }
+	double b2() const { return m_b2; }
+	double a1() const { return m_a1; }
+	double a2() const { return m_a2; }
+
+private:
+	double m_b0, m_b1, m_b2;
+	double m_a1, m_a2;
+
+	// the state of the filter
+	double m_z1, m_z2;
+};
+
+#endif /* SRC_NUMERICS_BIQUAD_H_ */
@@ -1,25 +1,65 @@
 #include "ExpandingMean.h"
+#include <algorithm>
 #include <dlib/matrix.h>
 
-ExpandingMean::ExpandingMean(int rows, int cols) {
-	m_sum = dlib::matrix<double>(rows, cols);
-	dlib::set_all_elements(m_sum, NAN);
-	m_count = 0;
+ExpandingMean::ExpandingMean(int rows, int cols)
+: m_mean(rows, cols)
+{
+	reset();
 }
 
 void ExpandingMean::consume(const dlib::matrix<double> &x) {
+	if (x.nr() != m_mean.nr() || x.nc() != m_mean.nc()) {
+		throw std::logic_error("ExpandingMean: the consumed matrix has wrong dimensions");
+	}
 	if (!dlib::is_finite(x)) {
 		return;
 	}
 
+	++m_count;
+	const double weight = 1. / m_count;
+	const double* values = x.begin();
+	double* mean = m_mean.begin();
+	if (m_count == 1) {
+		std::copy(values, values + x.size(), mean);
+		return;
+	}
+	for (long i = 0; i != x.size(); ++i) {
+		mean[i] += (values[i] - mean[i]) * weight;
+	}
+}
+
+void ExpandingMean::merge(const ExpandingMean &other) {
+	if (other.m_mean.nr() != m_mean.nr() || other.m_mean.nc() != m_mean.nc()) {
+		throw std::logic_error("ExpandingMean: can't merge means of different dimensions");
+	}
+	if (other.m_count == 0) {
+		return;
+	}
 	if (m_count == 0) {
-		m_sum = x;
-	} else {
-		m_sum = m_sum + x;
+		*this = other;
+		return;
 	}
-	++m_count;
+
+	const long count = m_count + other.m_count;
+	const double other_weight = double(other.m_count) / count;
+	const double* other_mean = other.m_mean.begin();
+	double* mean = m_mean.begin();
+	for (long i = 0; i != m_mean.size(); ++i) {
+		mean[i] += (other_mean[i] - mean[i]) * other_weight;
+	}
+	m_count = count;
+}
+
+void ExpandingMean::reset() {
+	dlib::set_all_elements(m_mean, NAN);
+	m_count = 0;
+}
+
+const dlib::matrix<double>& ExpandingMean::value() const {
+	return m_mean;
 }
 
-dlib::matrix<double> ExpandingMean::value() const {
-	return (1. / m_count) * m_sum;
+long ExpandingMean::count() const {
+	return m_count;
 }
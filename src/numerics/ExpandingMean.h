@@ -20,14 +20,42 @@
  *
  * This concept is very important for the standardization used in online
  * staging algorithm
+ *
+ * The mean is updated in place (mean += (x - mean) / n), so consuming a value
+ * doesn't allocate and the accuracy doesn't degrade over long recordings.
  */
 class ExpandingMean {
-	dlib::matrix<double> m_sum;
-	int m_count;
+	dlib::matrix<double> m_mean;
+	long m_count;
 public:
 	ExpandingMean(int rows, int cols);
+
+	/**
+	 * Updates the mean with 'x', which has to have the dimensions given in the
+	 * constructor. Matrices containing non-finite values are ignored.
+	 */
 	void consume(const dlib::matrix<double> &x);
-	dlib::matrix<double> value() const;
+
+	/**
+	 * Combines the statistics of 'other', computed over a disjoint set of values,
+	 * into this one, as if all of its values were consumed by this object.
+	 */
+	void merge(const ExpandingMean &other);
+
+	/**
+	 * Forgets all the consumed values.
+	 */
+	void reset();
+
+	/**
+	 * @return the mean of the consumed values, NaNs if nothing was consumed
+	 */
+	const dlib::matrix<double>& value() const;
+
+	/**
+	 * @return the number of consumed values
+	 */
+	long count() const;
 };
 
 #endif /* SRC_EXPANDINGMEAN_H_ */
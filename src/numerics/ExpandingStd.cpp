@@ -1,37 +1,89 @@
 #include "ExpandingStd.h"
+#include <algorithm>
 
-ExpandingStd::ExpandingStd(int rows, int cols) {
-	m_sum = dlib::matrix<double>(rows, cols);
-	dlib::set_all_elements(m_sum, NAN);
-
-	m_sum_of_squares = dlib::matrix<double>(rows, cols);
-	dlib::set_all_elements(m_sum_of_squares, NAN);
-
-	m_count = 0;
+ExpandingStd::ExpandingStd(int rows, int cols)
+: m_mean(rows, cols)
+, m_squared_deviations(rows, cols)
+, m_std(rows, cols)
+{
+	reset();
 }
 
 void ExpandingStd::consume(const dlib::matrix<double> &x) {
+	if (x.nr() != m_mean.nr() || x.nc() != m_mean.nc()) {
+		throw std::logic_error("ExpandingStd: the consumed matrix has wrong dimensions");
+	}
 	if (!dlib::is_finite(x)) {
 		return;
 	}
 
-	if (m_count == 0) {
-		m_sum = x;
-		m_sum_of_squares = dlib::pointwise_multiply(x,x);
+	++m_count;
+	const double weight = 1. / m_count;
+	const double* values = x.begin();
+	double* mean = m_mean.begin();
+	double* squared_deviations = m_squared_deviations.begin();
+	if (m_count == 1) {
+		std::copy(values, values + x.size(), mean);
+		std::fill(squared_deviations, squared_deviations + x.size(), 0.);
 	} else {
-		m_sum = m_sum + x;
-		m_sum_of_squares = m_sum_of_squares + dlib::pointwise_multiply(x,x);
+		for (long i = 0; i != x.size(); ++i) {
+			double delta = values[i] - mean[i];
+			mean[i] += delta * weight;
+			squared_deviations[i] += delta * (values[i] - mean[i]);
+		}
+	}
+	update_std();
+}
+
+void ExpandingStd::merge(const ExpandingStd &other) {
+	if (other.m_mean.nr() != m_mean.nr() || other.m_mean.nc() != m_mean.nc()) {
+		throw std::logic_error("ExpandingStd: can't merge stds of different dimensions");
+	}
+	if (other.m_count == 0) {
+		return;
+	}
+	if (m_count == 0) {
+		*this = other;
+		return;
+	}
+
+	// Chan et al. pairwise combination of the partial statistics
+	const long count = m_count + other.m_count;
+	const double other_weight = double(other.m_count) / count;
+	const double cross_weight = double(m_count) * other_weight;
+	const double* other_mean = other.m_mean.begin();
+	const double* other_squared_deviations = other.m_squared_deviations.begin();
+	double* mean = m_mean.begin();
+	double* squared_deviations = m_squared_deviations.begin();
+	for (long i = 0; i != m_mean.size(); ++i) {
+		double delta = other_mean[i] - mean[i];
+		mean[i] += delta * other_weight;
+		squared_deviations[i] += other_squared_deviations[i] + delta * delta * cross_weight;
+	}
+	m_count = count;
+	update_std();
+}
+
+void ExpandingStd::reset() {
+	dlib::set_all_elements(m_mean, NAN);
+	dlib::set_all_elements(m_squared_deviations, NAN);
+	dlib::set_all_elements(m_std, NAN);
+	m_count = 0;
+}
+
+void ExpandingStd::update_std() {
+	const double weight = 1. / m_count;
+	const double* squared_deviations = m_squared_deviations.begin();
+	double* std = m_std.begin();
+	for (long i = 0; i != m_std.size(); ++i) {
+		std[i] = std::sqrt(squared_deviations[i] * weight);
 	}
-	++m_count;
 }
 
-dlib::matrix<double> ExpandingStd::value() const {
-	dlib::matrix<double> m1 = (1. / m_count) * m_sum;
-	dlib::matrix<double> m1_squared = dlib::pointwise_multiply(m1, m1);
+const dlib::matrix<double>& ExpandingStd::value() const {
+	return m_std;
+}
 
-	dlib::matrix<double> m2 = (1. / m_count) * m_sum_of_squares;
-	dlib::matrix<double> variance = m2 - m1_squared;
-	LOG(DEBUG) << "variance: "<< variance;
-	dlib::matrix<double> std = dlib::sqrt(variance);
-	return std;
+long ExpandingStd::count() const {
+	return m_count;
 }
@@ -21,16 +21,48 @@
  *
  * This concept is very important for the standardization used in online
  * staging algorithm
+ *
+ * Uses Welford's algorithm: the mean and the sum of squared deviations from
+ * the mean are updated in place, which is numerically stable unlike
+ * E[x^2] - E[x]^2, and consuming a value doesn't allocate.
  */
 
 class ExpandingStd {
-	dlib::matrix<double> m_sum;
-	dlib::matrix<double> m_sum_of_squares;
-	int m_count;
+	dlib::matrix<double> m_mean;
+	dlib::matrix<double> m_squared_deviations;
+	dlib::matrix<double> m_std;
+	long m_count;
+
+	void update_std();
 public:
 	ExpandingStd(int rows, int cols);
+
+	/**
+	 * Updates the std with 'x', which has to have the dimensions given in the
+	 * constructor. Matrices containing non-finite values are ignored.
+	 */
 	void consume(const dlib::matrix<double> &x);
-	dlib::matrix<double> value() const;
+
+	/**
+	 * Combines the statistics of 'other', computed over a disjoint set of values,
+	 * into this one, as if all of its values were consumed by this object.
+	 */
+	void merge(const ExpandingStd &other);
+
+	/**
+	 * Forgets all the consumed values.
+	 */
+	void reset();
+
+	/**
+	 * @return the (biased) std of the consumed values, NaNs if nothing was consumed
+	 */
+	const dlib::matrix<double>& value() const;
+
+	/**
+	 * @return the number of consumed values
+	 */
+	long count() const;
 };
 
 #endif /* SRC_EXPANDINGSTD_H_ */
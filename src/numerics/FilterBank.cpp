@@ -0,0 +1,90 @@
+/*
+ * FilterBank.cpp
+ */
+
+#include "FilterBank.h"
+#include <algorithm>
+#include <stdexcept>
+
+FilterBank::FilterBank(const std::vector<std::vector<Biquad>>& cascades)
+: m_channels(cascades.size())
+, m_sections(0)
+{
+	if (cascades.empty()) {
+		throw std::logic_error("a filter bank needs at least one channel");
+	}
+	for (const auto& cascade : cascades) {
+		m_sections = std::max<int>(m_sections, cascade.size());
+	}
+
+	const std::size_t size = m_sections * m_channels;
+	m_b0.resize(size);
+	m_b1.resize(size);
+	m_b2.resize(size);
+	m_a1.resize(size);
+	m_a2.resize(size);
+	m_z1.resize(size);
+	m_z2.resize(size);
+
+	for (int c = 0; c != m_channels; ++c) {
+		for (int s = 0; s != m_sections; ++s) {
+			Biquad biquad = s < static_cast<int>(cascades[c].size()) ? cascades[c][s] : Biquad::identity();
+			std::size_t i = s * m_channels + c;
+			m_b0[i] = biquad.b0();
+			m_b1[i] = biquad.b1();
+			m_b2[i] = biquad.b2();
+			m_a1[i] = biquad.a1();
+			m_a2[i] = biquad.a2();
+		}
+	}
+
+	reset();
+}
+
+void FilterBank::reset() {
+	std::fill(m_z1.begin(), m_z1.end(), 0.);
+	std::fill(m_z2.begin(), m_z2.end(), 0.);
+}
+
+/*
+ * Filters one sample of every channel in place, through all the sections
+ */
+void FilterBank::filter_row(double* row) {
+	const int channels = m_channels;
+	for (int s = 0; s != m_sections; ++s) {
+		const std::size_t offset = s * channels;
+		const double* b0 = &m_b0[offset];
+		const double* b1 = &m_b1[offset];
+		const double* b2 = &m_b2[offset];
+		const double* a1 = &m_a1[offset];
+		const double* a2 = &m_a2[offset];
+		double* z1 = &m_z1[offset];
+		double* z2 = &m_z2[offset];
+
+		for (int c = 0; c != channels; ++c) {
+			double x = row[c];
+			double y = b0[c] * x + z1[c];
+			z1[c] = b1[c] * x - a1[c] * y + z2[c];
+			z2[c] = b2[c] * x - a2[c] * y;
+			row[c] = y;
+		}
+	}
+}
+
+void FilterBank::process(const double* input, std::size_t frames, double* output) {
+	for (std::size_t t = 0; t != frames; ++t) {
+		double* row = output + t * m_channels;
+		if (row != input + t * m_channels) {
+			std::copy(input + t * m_channels, input + (t + 1) * m_channels, row);
+		}
+		filter_row(row);
+	}
+}
+
+void FilterBank::process_broadcast(const double* input, std::size_t frames, double* output) {
+	for (std::size_t t = 0; t != frames; ++t) {
+		double* row = output + t * m_channels;
+		std::fill(row, row + m_channels, input[t]);
+		filter_row(row);
+	}
+}
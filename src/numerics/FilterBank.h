@@ -0,0 +1,71 @@
+/*
+ * FilterBank.h
+ */
+
+#ifndef SRC_NUMERICS_FILTERBANK_H_
+#define SRC_NUMERICS_FILTERBANK_H_
+
+#include <cstddef>
+#include <vector>
+#include "Biquad.h"
+
+/**
+ * A bank of streaming IIR filters, one cascade of biquads per channel,
+ * e.g. a high-pass for each axis of the accelerometer, or several band-pass
+ * filters of the same signal.
+ *
+ * The coefficients and the states are kept as structures of arrays, one
+ * array per coefficient and section, indexed by the channel, so a sample of
+ * all the channels is filtered by one loop over contiguous arrays without
+ * dependencies between the iterations. For a single channel the Biquads
+ * called directly are cheaper.
+ * The results are the same as of the Biquads filtering each channel alone.
+ *
+ * A NaN sample makes the output of its channel NaN until reset().
+ */
+class FilterBank {
+public:
+	/**
+	 * @param cascades : the biquads of each channel, applied in order;
+	 * the shorter cascades are padded with Biquad::identity()
+	 */
+	FilterBank(const std::vector<std::vector<Biquad>>& cascades);
+
+	/**
+	 * Filters 'frames' samples of every channel.
+	 *
+	 * @param input : frames x channels() samples, the channels of a frame next to each other
+	 * @param output : room for frames x channels() samples in the same layout,
+	 * can be the same as input
+	 */
+	void process(const double* input, std::size_t frames, double* output);
+
+	/**
+	 * Same as above, but the same input sample is filtered by every channel
+	 *
+	 * @param input : 'frames' samples
+	 */
+	void process_broadcast(const double* input, std::size_t frames, double* output);
+
+	int channels() const {
+		return m_channels;
+	}
+
+	int sections() const {
+		return m_sections;
+	}
+
+	void reset();
+
+private:
+	void filter_row(double* row);
+
+	int m_channels;
+	int m_sections;
+
+	// sections x channels, the channels of a section next to each other
+	std::vector<double> m_b0, m_b1, m_b2, m_a1, m_a2;
+	std::vector<double> m_z1, m_z2;
+};
+
+#endif /* SRC_NUMERICS_FILTERBANK_H_ */
@@ -0,0 +1,74 @@
+/*
+ * PolyphaseDecimator.cpp
+ */
+
+#include "PolyphaseDecimator.h"
+#include <cmath>
+#include <stdexcept>
+
+PolyphaseDecimator::PolyphaseDecimator(int factor, int taps_per_phase, double cutoff)
+: m_factor(factor)
+, m_taps_per_phase(taps_per_phase)
+{
+	if (factor < 1 || taps_per_phase < 1) {
+		throw std::logic_error("the decimation factor and the taps per phase have to be positive");
+	}
+	if (!(cutoff > 0 && cutoff <= 1)) {
+		throw std::logic_error("the cutoff of the decimator has to be in (0, 1]");
+	}
+
+	// a Hamming-windowed sinc with the unit gain at 0 Hz
+	const int taps = factor * taps_per_phase;
+	const double relative_cutoff = cutoff / factor;
+	const double center = (taps - 1) / 2.;
+	std::vector<double> h(taps);
+	double sum = 0;
+	for (int i = 0; i != taps; ++i) {
+		double x = i - center;
+		double sinc = x == 0 ? 1 : std::sin(M_PI * relative_cutoff * x) / (M_PI * relative_cutoff * x);
+		double window = taps == 1 ? 1 : 0.54 - 0.46 * std::cos(2 * M_PI * i / (taps - 1));
+		h[i] = sinc * window;
+		sum += h[i];
+	}
+
+	// an output is computed after the sample of the last phase, y = sum_i h[i] x[n - i],
+	// so the sample of phase q is multiplied by the coefficients h[factor - 1 - q + factor * j],
+	// where j = 0 for the newest sample of the phase
+	m_phase_coefficients.resize(factor);
+	for (int q = 0; q != factor; ++q) {
+		m_phase_coefficients[q].resize(taps_per_phase);
+		for (int j = 0; j != taps_per_phase; ++j) {
+			m_phase_coefficients[q][taps_per_phase - 1 - j] = h[factor - 1 - q + factor * j] / sum;
+		}
+		m_phase_history.push_back(MirroredRing<double>(taps_per_phase));
+	}
+
+	reset();
+}
+
+void PolyphaseDecimator::reset() {
+	for (auto& history : m_phase_history) {
+		history.fill(0.);
+	}
+	m_phase = 0;
+}
+
+void PolyphaseDecimator::process(const double* samples, std::size_t size, std::vector<double>& output) {
+	for (std::size_t i = 0; i != size; ++i) {
+		m_phase_history[m_phase].push(samples[i]);
+		if (++m_phase != m_factor) {
+			continue;
+		}
+		m_phase = 0;
+
+		double result = 0;
+		for (int q = 0; q != m_factor; ++q) {
+			const double* history = m_phase_history[q].data();
+			const double* coefficients = m_phase_coefficients[q].data();
+			for (int j = 0; j != m_taps_per_phase; ++j) {
+				result += coefficients[j] * history[j];
+			}
+		}
+		output.push_back(result);
+	}
+}
@@ -0,0 +1,69 @@
+/*
+ * PolyphaseDecimator.h
+ */
+
+#ifndef SRC_NUMERICS_POLYPHASEDECIMATOR_H_
+#define SRC_NUMERICS_POLYPHASEDECIMATOR_H_
+
+#include <vector>
+#include "MirroredRing.h"
+
+/**
+ * A streaming decimator: low-pass filters a signal with a windowed-sinc FIR
+ * (to avoid aliasing) and keeps every factor-th sample of the result.
+ *
+ * The filter is split into 'factor' phases, each holding every factor-th
+ * coefficient and filtering the input samples of one phase, so only the
+ * outputs which are kept are computed: a sample costs O(1) to store and
+ * an output costs taps() multiplications, i.e. taps() / factor per input sample.
+ *
+ * The output is delayed by (taps() - 1) / 2 input samples and the filter
+ * starts from zeros, so the first outputs show the transient of the filter.
+ */
+class PolyphaseDecimator {
+public:
+	// with the default cutoff, the filter is flat up to 0.9 of the output
+	// Nyquist frequency and attenuates the frequencies above the Nyquist
+	// frequency by more than 45 dB, i.e. for the EEG decimated by 2 it's flat
+	// up to 28 Hz and practically nothing is aliased, but 29 - 31 Hz are
+	// attenuated (by 6 dB at 29.7 Hz)
+	static const int DEFAULT_TAPS_PER_PHASE = 64;
+
+	// the cutoff frequency of the filter relative to the output Nyquist frequency
+	static constexpr double DEFAULT_CUTOFF = 0.95;
+
+	/**
+	 * @param factor : the number of input samples per output sample
+	 * @param taps_per_phase : the length of the filter is factor * taps_per_phase
+	 * @param cutoff : the -6 dB point of the filter, relative to
+	 * the Nyquist frequency of the output
+	 */
+	PolyphaseDecimator(int factor, int taps_per_phase = DEFAULT_TAPS_PER_PHASE, double cutoff = DEFAULT_CUTOFF);
+
+	/**
+	 * Feeds the samples and appends the outputs to 'output'
+	 */
+	void process(const double* samples, std::size_t size, std::vector<double>& output);
+
+	int factor() const {
+		return m_factor;
+	}
+
+	int taps() const {
+		return m_factor * m_taps_per_phase;
+	}
+
+	void reset();
+
+private:
+	int m_factor;
+	int m_taps_per_phase;
+
+	// the coefficients of the phases, the coefficients of a phase
+	// are in the order of its history, oldest sample first
+	std::vector<std::vector<double>> m_phase_coefficients;
+	std::vector<MirroredRing<double>> m_phase_history;
+	int m_phase;
+};
+
+#endif /* SRC_NUMERICS_POLYPHASEDECIMATOR_H_ */
@@ -7,11 +7,12 @@
 
 #include "RollingMean.h"
 #include <cmath>
-#include <iostream>
+#include "Diagnostics.h"
 
-RollingMean::RollingMean(int window, int columns)
+RollingMean::RollingMean(int window, int columns, bool partial)
 : m_window(window)
 , m_columns(columns)
+, m_partial(partial)
 , m_data() {}
 
 void RollingMean::feed(dlib::matrix<double> input) {
@@ -25,15 +26,15 @@ void RollingMean::feed(dlib::matrix<double> input) {
 dlib::matrix<double> RollingMean::value() {
 	dlib::matrix<double> result = dlib::zeros_matrix<double>(1, m_columns);
 
-	if (m_data.size() < m_window) {
-		std::cout << "rolling mean nan\n";
+	if (m_data.empty() || (m_data.size() < m_window && !m_partial)) {
+		DIAG_COUNT("rolling_mean.nan");
 		return NAN * result;
 	}
 
 	for (auto e : m_data) {
 		result = result + e;
 	}
-	return (1. / m_window) * result;
+	return (1. / m_data.size()) * result;
 }
 
 
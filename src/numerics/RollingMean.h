@@ -18,10 +18,15 @@ class RollingMean {
 
 	int m_window;
 	int m_columns;
+	bool m_partial;
 	std::vector<dlib::matrix<double>> m_data;
 
 public:
-	RollingMean(int window, int columns);
+	/**
+	 * @param partial : if true, the mean of the available rows is returned until
+	 * the window is filled, otherwise NaN
+	 */
+	RollingMean(int window, int columns, bool partial = false);
 
 	void feed(dlib::matrix<double> input);
 	dlib::matrix<double> value();
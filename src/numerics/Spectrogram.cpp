@@ -7,11 +7,13 @@
 
 #include "Spectrogram.h"
 
+#include <cmath>
 #include <vector>
 #include <algorithm>
 #include <numeric>
 #include <dlib/matrix.h>
 #include <exception>
+#include "PerformanceCounters.h"
 #include "logger.h"
 
 Spectrogram::Spectrogram() {
@@ -27,6 +29,10 @@ int smaller_power_of_2(int x) {
 	return result;
 }
 
+double noise_magnitude_scale(int x, int reference_window) {
+	return std::sqrt(static_cast<double>(smaller_power_of_2(reference_window)) / smaller_power_of_2(x));
+}
+
 /*
  * currently this is designed and tested to compute the exact C++ equivalent of scipy's:
  * t, f, Sxx = spectrogram(signal, nperseg=window, noverlap=noverlap, mode='magnitude',
@@ -45,6 +51,7 @@ int smaller_power_of_2(int x) {
  */
 Spectrogram::Spectrogram(const dlib::matrix<double>& signal, double sampling_frequency,
 			int window, int noverlap) {
+	ScopedPerformanceTimer timer(NC_PERF_SPECTROGRAM);
 
 	LOG(DEBUG) << "computing spectrogram from size: (" << signal.nr() << "," << signal.nc() <<"), window: " << window
 			  << ", noverlap: " << noverlap;
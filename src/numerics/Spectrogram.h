@@ -12,6 +12,20 @@
 #include <ostream>
 #include <dlib/matrix.h>
 
+/**
+ * The largest power of 2 not greater than x, i.e. the length of the FFTs
+ * computed by the Spectrogram for windows of x samples
+ */
+int smaller_power_of_2(int x);
+
+/**
+ * The factor scaling a noise-like signal analyzed with windows of x samples
+ * so that its spectrogram has the level of one analyzed with windows of
+ * reference_window samples. The magnitudes aren't normalized by the FFT length,
+ * so for noise they grow with its square root.
+ */
+double noise_magnitude_scale(int x, int reference_window);
+
 /**
  * Represents a spectrogram i.e. a series of Fast Fourier Transforms computed
  * for consecutive ranges of time points of a given signal (windows).
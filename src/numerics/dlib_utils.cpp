@@ -1,6 +1,9 @@
 #include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <stdexcept>
 #include "dlib_utils.h"
+#include "fast_math.h"
 
 double percentile (dlib::matrix<double> signal, double percentile) {
 	std::sort(signal.begin(), signal.end());
@@ -20,6 +23,16 @@ void fill_with_last(dlib::matrix<double>& signal, double to_replace) {
 	}
 }
 
+namespace {
+
+// v - v is NaN for both NaNs and infinities, so the comparison is false
+// for all of them without a branch
+inline unsigned char is_finite_value(double v) {
+	return (v - v) == 0;
+}
+
+}
+
 /*
  * dlib's implementation of standard deviation computes the unbiased estimator of
  * standard deviation: std(x) = 1/(n-1) * sum( (x_i - x_mean)^2 )
@@ -28,62 +41,161 @@ void fill_with_last(dlib::matrix<double>& signal, double to_replace) {
  * with the onse from scikit-learn's StandardScaler, i.e.: std(x) = 1/n * sum( (x_i - x_mean)^2 )
  */
 double standard_deviation(const dlib::matrix<double> &signal) {
-	double mean = dlib::mean(signal);
-	dlib::matrix<double> deviations =  (signal - mean);
-	deviations = dlib::pointwise_multiply(deviations, deviations);
+	return standard_deviation(signal.begin(), signal.size());
+}
+
+double standard_deviation(const double* data, long size) {
+	double sum = 0;
+	for (long i = 0; i != size; ++i) {
+		sum += data[i];
+	}
+	double mean = sum / size;
 
-	double variance = dlib::mean(deviations);
-	double stddev = sqrt(variance);
-	return stddev;
+	double squares = 0;
+	for (long i = 0; i != size; ++i) {
+		double deviation = data[i] - mean;
+		squares += deviation * deviation;
+	}
+
+	double variance = squares / size;
+	return sqrt(variance);
 }
 
+dlib::matrix<unsigned char> finite_rows_mask(const dlib::matrix<double>& input) {
+	const long rows = input.nr();
+	const long cols = input.nc();
+	const double* data = input.begin();
 
-dlib::matrix<int> nonnan_rows(const dlib::matrix<double>& input) {
-	std::vector<int> v;
+	dlib::matrix<unsigned char> mask(rows, 1);
+	unsigned char* selected = mask.begin();
+	if (cols == 1) {
+		for (long i = 0; i != rows; ++i) {
+			selected[i] = is_finite_value(data[i]);
+		}
+		return mask;
+	}
 
-	for (std::size_t i = 0; i != input.nr(); ++i) {
-		bool finite = dlib::is_finite(dlib::rowm(input, i));
-		if (finite) {
-			v.push_back(i);
+	for (long i = 0; i != rows; ++i) {
+		unsigned char finite = 1;
+		const double* row = data + i * cols;
+		for (long j = 0; j != cols; ++j) {
+			finite &= is_finite_value(row[j]);
 		}
+		selected[i] = finite;
 	}
+	return mask;
+}
 
-	dlib::matrix<int> result(v.size(), 1);
-	for (std::size_t i = 0; i != v.size(); ++i) {
-		result(i,0) = v[i];
+dlib::matrix<unsigned char> greater_than_mask(const dlib::matrix<double> &signal, double threshold) {
+	const long rows = signal.nr();
+	const long cols = signal.nc();
+	const double* data = signal.begin();
+
+	dlib::matrix<unsigned char> mask(rows, 1);
+	unsigned char* selected = mask.begin();
+	for (long i = 0; i != rows; ++i) {
+		selected[i] = data[i * cols] > threshold;
 	}
-	return result;
+	return mask;
 }
 
+long count_selected(const dlib::matrix<unsigned char> &mask) {
+	const unsigned char* selected = mask.begin();
+	long count = 0;
+	for (long i = 0; i != mask.size(); ++i) {
+		count += selected[i];
+	}
+	return count;
+}
 
-double nan_ratio(const dlib::matrix<double>& input) {
-	int nans = 0;
-	for (std::size_t i = 0; i != input.nr(); ++i) {
-		bool finite = dlib::is_finite(dlib::rowm(input, i));
-		if (!finite) {
-			nans++;
+void set_selected_rows(dlib::matrix<double> &data, const dlib::matrix<unsigned char> &mask, double value) {
+	if (mask.size() != data.nr()) {
+		throw std::logic_error("set_selected_rows: mask size differs from the number of rows");
+	}
+
+	const long cols = data.nc();
+	const unsigned char* selected = mask.begin();
+	double* values = data.begin();
+	for (long i = 0; i != data.nr(); ++i) {
+		if (selected[i]) {
+			std::fill(values + i * cols, values + (i + 1) * cols, value);
 		}
 	}
+}
+
+dlib::matrix<double> compact_rows(const dlib::matrix<double> &data, const dlib::matrix<unsigned char> &mask) {
+	if (mask.size() != data.nr()) {
+		throw std::logic_error("compact_rows: mask size differs from the number of rows");
+	}
 
-	return double(nans) / input.nr();
+	const long cols = data.nc();
+	dlib::matrix<double> result(count_selected(mask), cols);
+
+	const unsigned char* selected = mask.begin();
+	const double* source = data.begin();
+	double* destination = result.begin();
+	for (long i = 0; i != data.nr(); ++i) {
+		if (selected[i]) {
+			std::copy(source + i * cols, source + (i + 1) * cols, destination);
+			destination += cols;
+		}
+	}
+	return result;
 }
 
+dlib::matrix<double> expand_rows(const dlib::matrix<double> &compacted, const dlib::matrix<unsigned char> &mask,
+								 double fill) {
+	if (count_selected(mask) != compacted.nr()) {
+		throw std::logic_error("expand_rows: mask doesn't select as many rows as given");
+	}
 
-dlib::matrix<int> rows_greater_than(const dlib::matrix<double> &signal, double threshold) {
-	std::vector<int> rows;
+	const long cols = compacted.nc();
+	dlib::matrix<double> result(mask.size(), cols);
 
-	for (int i = 0; i != signal.nr(); ++i) {
-		double value = signal(i, 0);
-		if (value > threshold) {
-			rows.push_back(i);
+	const unsigned char* selected = mask.begin();
+	const double* source = compacted.begin();
+	double* destination = result.begin();
+	for (long i = 0; i != mask.size(); ++i, destination += cols) {
+		if (selected[i]) {
+			std::copy(source, source + cols, destination);
+			source += cols;
+		} else {
+			std::fill(destination, destination + cols, fill);
 		}
 	}
+	return result;
+}
+
+dlib::matrix<int> nonnan_rows(const dlib::matrix<double>& input) {
+	dlib::matrix<unsigned char> mask = finite_rows_mask(input);
 
-	dlib::matrix<int> result(rows.size(), 1);
-	for (std::size_t i = 0; i != rows.size(); ++i) {
-		result(i, 0) = rows[i];
+	dlib::matrix<int> result(count_selected(mask), 1);
+	int* indices = result.begin();
+	for (long i = 0; i != mask.size(); ++i) {
+		if (mask(i, 0)) {
+			*indices++ = i;
+		}
 	}
+	return result;
+}
 
+
+double nan_ratio(const dlib::matrix<double>& input) {
+	long finite = count_selected(finite_rows_mask(input));
+	return double(input.nr() - finite) / input.nr();
+}
+
+
+dlib::matrix<int> rows_greater_than(const dlib::matrix<double> &signal, double threshold) {
+	dlib::matrix<unsigned char> mask = greater_than_mask(signal, threshold);
+
+	dlib::matrix<int> result(count_selected(mask), 1);
+	int* indices = result.begin();
+	for (long i = 0; i != mask.size(); ++i) {
+		if (mask(i, 0)) {
+			*indices++ = i;
+		}
+	}
 	return result;
 }
 
@@ -110,14 +222,53 @@ dlib::matrix<int> argmax(const dlib::matrix<double>& input) {
 
 dlib::matrix<double> normalize(const dlib::matrix<double> &signal) {
 	//TODO: make sure it works with negative values also
-	double sum = dlib::sum(signal);
-	return signal / sum;
+	const double* data = signal.begin();
+	double sum = 0;
+	for (long i = 0; i != signal.size(); ++i) {
+		sum += data[i];
+	}
+
+	dlib::matrix<double> result(signal.nr(), signal.nc());
+	double* normalized = result.begin();
+	for (long i = 0; i != signal.size(); ++i) {
+		normalized[i] = data[i] / sum;
+	}
+	return result;
 }
 
 double entropy(const dlib::matrix<double> &signal) {
-	dlib::matrix<double> normalized = normalize(signal);
-	dlib::matrix<double> to_sum = dlib::pointwise_multiply(normalized, dlib::log(normalized));
-	double result = (-1) * dlib::sum(to_sum);
+	const double* data = signal.begin();
+	double sum = 0;
+	for (long i = 0; i != signal.size(); ++i) {
+		sum += data[i];
+	}
+
+	double result = 0;
+	for (long i = 0; i != signal.size(); ++i) {
+		double p = data[i] / sum;
+		result += p * std::log(p);
+	}
+	return (-1) * result;
+}
+
+dlib::matrix<double> row_entropies(const dlib::matrix<double> &data) {
+	const long cols = data.nc();
+	dlib::matrix<double> result(data.nr(), 1);
+
+	// with s being the sum of the row:
+	// -sum(a/s * log(a/s)) = log(s) - sum(a * log(a)) / s
+	// so the row doesn't have to be normalized first
+	for (long i = 0; i != data.nr(); ++i) {
+		const double* row = data.begin() + i * cols;
+		double sum = 0;
+		double weighted_logs = 0;
+		for (long j = 0; j != cols; ++j) {
+			double a = row[j];
+			sum += a;
+			weighted_logs += a > 0 ? a * fast_log(a) : 0.;
+		}
+		result(i, 0) = sum > 0 ? fast_log(sum) - weighted_logs / sum : NAN;
+	}
 	return result;
 }
 
@@ -217,7 +368,18 @@ dlib::matrix<double> softmax(const dlib::matrix<double>& input) {
 
 dlib::matrix<double> standardize(const dlib::matrix<double> &input, const dlib::matrix<double> &means,
 								 const dlib::matrix<double> &stds) {
+	if (input.nr() != means.nr() || input.nc() != means.nc()
+		|| input.nr() != stds.nr() || input.nc() != stds.nc()) {
+		throw std::logic_error("standardize: the dimensions of the matrices don't agree");
+	}
 
-	//TODO: test it
-	return dlib::pointwise_multiply((input - means), 1. / stds);
+	dlib::matrix<double> result(input.nr(), input.nc());
+	const double* x = input.begin();
+	const double* m = means.begin();
+	const double* s = stds.begin();
+	double* standardized = result.begin();
+	for (long i = 0; i != input.size(); ++i) {
+		standardized[i] = (x[i] - m[i]) * (1. / s[i]);
+	}
+	return result;
 }
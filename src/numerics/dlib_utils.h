@@ -11,6 +11,13 @@
  * Conventions:
  * Usually by 'signal' a 2-D matrix of dimensions (n, 1) i.e. a column matrix
  * is meant. 
+ *
+ * By 'mask' a column matrix of unsigned chars is meant, with one element
+ * per row of the matrix it describes; 1 selects the row, 0 rejects it.
+ *
+ * The element-wise operations are scalar loops working directly on the
+ * contiguous storage of the matrices, without the temporaries of the dlib
+ * expressions.
  */
 
 
@@ -36,6 +43,11 @@ void fill_with_last(dlib::matrix<double>& signal, double to_replace);
  */ 
 double standard_deviation(const dlib::matrix<double> &signal);
 
+/**
+ * Same as above, but for 'size' values starting at 'data'
+ */
+double standard_deviation(const double* data, long size);
+
 /**
  * Returns a matrix of indices of rows that don't contain any Not a Number value
  */ 
@@ -53,6 +65,40 @@ double nan_ratio(const dlib::matrix<double>& input);
  */ 
 dlib::matrix<int> rows_greater_than(const dlib::matrix<double> &signal, double threshold);
 
+/**
+ * Returns a mask selecting the rows that don't contain any NaN or infinite value
+ */
+dlib::matrix<unsigned char> finite_rows_mask(const dlib::matrix<double>& input);
+
+/**
+ * Returns a mask selecting the rows of 'signal' with values greater than 'threshold'.
+ * Currently only column matrices are supported.
+ */
+dlib::matrix<unsigned char> greater_than_mask(const dlib::matrix<double> &signal, double threshold);
+
+/**
+ * Number of rows selected by the 'mask'
+ */
+long count_selected(const dlib::matrix<unsigned char> &mask);
+
+/**
+ * Sets all the elements of the rows selected by the 'mask' to 'value', in place.
+ */
+void set_selected_rows(dlib::matrix<double> &data, const dlib::matrix<unsigned char> &mask, double value);
+
+/**
+ * Returns a matrix made of the rows of 'data' selected by the 'mask', in their
+ * original order.
+ */
+dlib::matrix<double> compact_rows(const dlib::matrix<double> &data, const dlib::matrix<unsigned char> &mask);
+
+/**
+ * The inverse of compact_rows: puts the consecutive rows of 'compacted' in the
+ * rows selected by the 'mask' and fills the other rows with 'fill'.
+ */
+dlib::matrix<double> expand_rows(const dlib::matrix<double> &compacted, const dlib::matrix<unsigned char> &mask,
+								 double fill);
+
 /**
  * Returns a matrix of indices of biggest values for each row of the matrix.
  * i.e. for an input matrix of dimension: N x M, the result matrix
@@ -76,6 +122,14 @@ dlib::matrix<double> normalize(const dlib::matrix<double> &signal);
  */ 
 double entropy(const dlib::matrix<double> &signal);
 
+/**
+ * Computes the entropy of every row of 'data' at once, the result is a column
+ * matrix with one entropy per row. Uses fast_log, so the results differ from
+ * the ones of 'entropy' by less than 1e-8. Zero elements contribute nothing
+ * (as in scipy.stats.entropy), rows containing NaNs get NaN entropy.
+ */
+dlib::matrix<double> row_entropies(const dlib::matrix<double> &data);
+
 /**
  * Loads a matrix from the file given by filename
  */
@@ -0,0 +1,46 @@
+/*
+ * fast_math.h
+ *
+ * Approximations of elementary functions that, unlike the ones from <cmath>,
+ * don't handle errno or special cases, and are inlined into the loops
+ * using them instead of being called.
+ */
+
+#ifndef SRC_NUMERICS_FAST_MATH_H_
+#define SRC_NUMERICS_FAST_MATH_H_
+
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Natural logarithm for positive, finite, normal arguments. The absolute
+ * error is below 1e-9, the result for other arguments is unspecified.
+ *
+ * The argument is split into x = m * 2^e with m in [sqrt(1/2), sqrt(2)),
+ * log(m) is computed from the series of 2 * atanh((m - 1) / (m + 1)).
+ */
+inline double fast_log(double x) {
+	const std::uint64_t MANTISSA_MASK = 0x000FFFFFFFFFFFFFull;
+	const std::uint64_t EXPONENT_ONE = 0x3FF0000000000000ull;
+	const double LN2 = 0.69314718055994530942;
+	const double SQRT2 = 1.41421356237309504880;
+
+	std::uint64_t bits;
+	std::memcpy(&bits, &x, sizeof(bits));
+	double exponent = static_cast<double>(static_cast<std::int64_t>(bits >> 52) - 1023);
+	bits = (bits & MANTISSA_MASK) | EXPONENT_ONE;
+	double m;
+	std::memcpy(&m, &bits, sizeof(m));
+
+	// branch-free reduction of m from [1, 2) to [sqrt(1/2), sqrt(2))
+	double above = m > SQRT2 ? 1. : 0.;
+	m = m * (1. - 0.5 * above);
+	exponent += above;
+
+	double z = (m - 1.) / (m + 1.);
+	double z2 = z * z;
+	double series = 1. + z2 * (1. / 3 + z2 * (1. / 5 + z2 * (1. / 7 + z2 * (1. / 9 + z2 * (1. / 11)))));
+	return exponent * LN2 + 2. * z * series;
+}
+
+#endif /* SRC_NUMERICS_FAST_MATH_H_ */
@@ -15,15 +15,25 @@
 #include "logger.h"
 #include "BrainWaveLevels.h"
 #include "Spectrogram.h"
-#include "SpectrogramHeartRate.h"
 #include <algorithm>
 
 OnlinePresentationAlgorithm::OnlinePresentationAlgorithm(const std::vector<OnlinePresentationAlgorithm::sink_t*> & sinks)
 : SinkStreamingAlgorithmSp<OnlinePresentationResult>(sinks)
+, m_brain_waves_data(BRAIN_WAVES_ELEMENTS)
+, m_pulse_filter(AC_FILTER_WINDOW)
+, m_pulse_data(PULSE_ELEMENTS)
+, m_filtered_ir_samples(0)
+, m_heart_rate(Config::instance().neuroon_ir_freq())
 {
+	m_pulse_data.fill(0.);
+
 	m_last_eeg_index = 0;
-	m_last_ir_index = 0;
 	m_active = false;
+
+	m_updated = false;
+	m_max_results_rate = DEFAULT_MAX_RESULTS_RATE;
+	m_last_result_timestamp = 0;
+	m_any_result = false;
 }
 
 OnlinePresentationAlgorithm::~OnlinePresentationAlgorithm() {}
@@ -31,7 +41,13 @@ OnlinePresentationAlgorithm::~OnlinePresentationAlgorithm() {}
 void OnlinePresentationAlgorithm::reset_state() {
 	m_bw.reset_state();
 	m_brain_waves_data.clear();
-	m_pulse_data.clear();
+	m_last_eeg_index = 0;
+	m_pulse_filter.reset();
+	m_pulse_data.fill(0.);
+	m_filtered_ir_samples = 0;
+	m_heart_rate.reset();
+	m_updated = false;
+	m_any_result = false;
 }
 
 void OnlinePresentationAlgorithm::process_input(const INeuroonSignals & input) {
@@ -41,81 +57,65 @@ void OnlinePresentationAlgorithm::process_input(const INeuroonSignals & input) {
 
 	process_brain_waves(input);
 	process_pulseoximetry(input);
-}
-
-void OnlinePresentationAlgorithm::update_heart_rate(const INeuroonSignals & input) {
-	const int IR_WINDOW = 128;
-	const int OVERLAP = IR_WINDOW - 8;
-
-	if (m_last_ir_index + (IR_WINDOW - OVERLAP) > input.total_signal_samples(SignalOrigin::IR_LED)) {
-		return;
-	}
-
-	dlib::matrix<double> ir_signal = range_to_dlib_matrix(input.ir_led_signal().end() - IR_WINDOW, input.ir_led_signal().end());
-	Spectrogram ir_spectrogram(ir_signal, Config::instance().neuroon_ir_freq(), IR_WINDOW, OVERLAP);
-
-	SpectrogramHeartRate shr;
-	double hr = shr.predict(ir_spectrogram).front();
-	m_heart_rate = hr;
-}
-
-void rolling_mean_ac_filter(std::vector<double> &data) {
- 	RollingMean rm(40, 1);
- 	std::vector<double> rolling_m(data.size());
- 	for (int i = 0; i != data.size(); ++i) {
- 		dlib::matrix<double> mat(1,1);
- 		mat(0,0) = data[i];
- 		rm.feed(mat);
- 		rolling_m[i] = rm.value();
- 		data[i] -= rm.value();
- 	}
+	update_results(input);
 }
 
 void OnlinePresentationAlgorithm::update_pulseoximeter_data(const INeuroonSignals & input) {
- 	std::size_t PULSE_ELEMENTS = 5 * 25;// * 16;
- 	m_pulse_data.resize(PULSE_ELEMENTS);
- 	std::fill(m_pulse_data.begin(), m_pulse_data.end(), 0);
- 	std::copy(input.ir_led_signal().end() - std::min(PULSE_ELEMENTS, input.ir_led_signal().size()),
- 			  input.ir_led_signal().end(), m_pulse_data.begin());
-
- 	rolling_mean_ac_filter(m_pulse_data);
+	// only the samples which arrived since the last call are filtered,
+	// if more arrived than the buffer of the signal holds, the oldest are lost
+	const std::vector<double>& ir = input.ir_led_signal();
+	std::size_t total_samples = input.total_signal_samples(SignalOrigin::IR_LED);
+	std::size_t new_samples = std::min<std::size_t>(total_samples - std::min(m_filtered_ir_samples, total_samples), ir.size());
+	m_filtered_ir_samples = total_samples;
+
+	for (auto it = ir.end() - new_samples; it != ir.end(); ++it) {
+		m_pulse_data.push(m_pulse_filter.filter(*it));
+		m_heart_rate.consume(*it);
+	}
 }
 
 void OnlinePresentationAlgorithm::process_pulseoximetry(const INeuroonSignals & input) {
-	update_heart_rate(input);
 	update_pulseoximeter_data(input);
-	update_results();
+	m_updated = true;
+}
+
+std::vector<int> OnlinePresentationAlgorithm::eeg_decimations() const {
+	return {EEG_DECIMATION};
 }
 
 void OnlinePresentationAlgorithm::process_brain_waves(const INeuroonSignals & input) {
-	const int EEG_WINDOW = 256;
-	const int OVERLAP = EEG_WINDOW - 8;
+	// ~2 s of the decimated EEG, the same frequency resolution as 256 samples at 125 Hz
+	const int EEG_WINDOW = 128;
+	const int OVERLAP = EEG_WINDOW - 4;
 
-	if (input.total_signal_samples(SignalOrigin::EEG) < EEG_WINDOW) {
+	const std::vector<double>& eeg = input.decimated_eeg_signal(EEG_DECIMATION);
+	std::size_t total_samples = input.total_decimated_eeg_samples(EEG_DECIMATION);
+	if (eeg.size() < EEG_WINDOW) {
 		return;
 	}
 
-	if (m_last_eeg_index + (EEG_WINDOW - OVERLAP) > input.total_signal_samples(SignalOrigin::EEG)) {
+	if (m_last_eeg_index + (EEG_WINDOW - OVERLAP) > total_samples) {
 		return;
 	}
 
-	m_last_eeg_index = input.total_signal_samples(SignalOrigin::EEG);
+	m_last_eeg_index = total_samples;
 
-	dlib::matrix<double> eeg_signal = range_to_dlib_matrix(input.eeg_signal().end() - EEG_WINDOW, input.eeg_signal().end());
-	Spectrogram eeg_spectrogram(eeg_signal, Config::instance().neuroon_eeg_freq(), EEG_WINDOW, OVERLAP);
+	dlib::matrix<double> eeg_signal = range_to_dlib_matrix(eeg.end() - EEG_WINDOW, eeg.end());
+	double fs = static_cast<double>(Config::instance().neuroon_eeg_freq()) / EEG_DECIMATION;
+	Spectrogram eeg_spectrogram(eeg_signal, fs, EEG_WINDOW, OVERLAP);
 
 	ncBrainWaveLevels b = m_bw.predict(eeg_spectrogram).front();
 
-	const int ELEMENTS_TO_REMEMBER = 256;
-	m_brain_waves_data.push_back(b);
-	if (m_brain_waves_data.size() > ELEMENTS_TO_REMEMBER) {
-		m_brain_waves_data.erase(m_brain_waves_data.begin());
-	}
-
-	update_results();
+	m_brain_waves_data.push(b);
+	m_updated = true;
 }
 
-void OnlinePresentationAlgorithm::end_streaming(const INeuroonSignals & input) {}
+void OnlinePresentationAlgorithm::end_streaming(const INeuroonSignals & input) {
+	// the last update is passed on, even if it came too soon after the previous one
+	if (m_active && m_updated) {
+		feed_result(input);
+	}
+}
 
 void OnlinePresentationAlgorithm::activate() {
 	m_active = true;
@@ -125,12 +125,40 @@ void OnlinePresentationAlgorithm::deactivate() {
 	m_active = false;
 }
 
-void OnlinePresentationAlgorithm::update_results() {
+void OnlinePresentationAlgorithm::set_max_results_rate(double results_per_second) {
+	m_max_results_rate = results_per_second;
+}
+
+ullong OnlinePresentationAlgorithm::last_timestamp(const INeuroonSignals & input) {
+	return std::max(input.last_timestamp(SignalOrigin::EEG), input.last_timestamp(SignalOrigin::IR_LED));
+}
+
+void OnlinePresentationAlgorithm::update_results(const INeuroonSignals & input) {
+	if (!m_updated) {
+		return;
+	}
+
+	ullong timestamp = last_timestamp(input);
+	if (m_any_result && m_max_results_rate > 0) {
+		const double MS_PER_SECOND = 1000;
+		if (timestamp < m_last_result_timestamp + MS_PER_SECOND / m_max_results_rate) {
+			return;
+		}
+	}
+
+	feed_result(input);
+}
+
+void OnlinePresentationAlgorithm::feed_result(const INeuroonSignals & input) {
+	m_updated = false;
+	m_any_result = true;
+	m_last_result_timestamp = last_timestamp(input);
+
 	OnlinePresentationResult result;
 	result.brain_waves = m_brain_waves_data.data();
 	result.bw_size = m_brain_waves_data.size();
-	result.heart_rate = m_heart_rate;
-	result.pulse_data = m_pulse_data.data();// + m_pulse_data.size()/2;
-	result.pd_size = m_pulse_data.size();// - m_pulse_data.size()/2;
+	result.heart_rate = m_heart_rate.heart_rate();
+	result.pulse_data = m_pulse_data.data();
+	result.pd_size = m_pulse_data.capacity();
 	feed_all_sinks(std::make_shared<OnlinePresentationResult>(result));
 }
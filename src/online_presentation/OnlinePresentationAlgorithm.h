@@ -14,6 +14,9 @@
 #include <vector>
 #include <stdexcept>
 #include "BrainWaveLevels.h"
+#include "AcCouplingFilter.h"
+#include "StreamingHeartRate.h"
+#include "MirroredRing.h"
 
 #include "NeuroonSignalStreamApi.h"
 
@@ -23,33 +26,60 @@
  * screen for the end-user of the application
  */
 struct OnlinePresentationResult {
-	ncBrainWaveLevels* brain_waves;
+	const ncBrainWaveLevels* brain_waves;
 	int bw_size;
 	double heart_rate;
-	double* pulse_data;
+	const double* pulse_data;
 	int pd_size;
 };
 
 /**
  * An implementation of a SinkStreamingAlgorithm for the online presentation mode 
+ *
+ * The brain waves and the pulse are updated as the frames arrive, while the
+ * results are passed to the sinks at most max_results_rate times per second
+ * (of the signal time), so many updates are coalesced into one result.
+ * The result points directly to the ring buffers of the algorithm.
  */
 class OnlinePresentationAlgorithm : public SinkStreamingAlgorithmSp<OnlinePresentationResult> {
 
-	std::vector<ncBrainWaveLevels> m_brain_waves_data;
-	std::vector<double> m_pulse_data;
-	double m_heart_rate;
+	// the number of the last IR samples presented as the pulse, 5 s
+	static const int PULSE_ELEMENTS = 5 * 25;
+	static const int AC_FILTER_WINDOW = 40;
+
+	// the brain waves are computed from the EEG at 62.5 Hz
+	static const int EEG_DECIMATION = 2;
+
+	// the history of the brain waves presented
+	static const int BRAIN_WAVES_ELEMENTS = 256;
+	MirroredRing<ncBrainWaveLevels> m_brain_waves_data;
+
+	// the filtered pulse and the heart rate, each IR sample is processed
+	// once, when it arrives
+	AcCouplingFilter m_pulse_filter;
+	MirroredRing<double> m_pulse_data;
+	std::size_t m_filtered_ir_samples;
+	StreamingHeartRate m_heart_rate;
 
 	int m_last_eeg_index;
-	int m_last_ir_index;
 	bool m_active;
+
+	// a result is passed to the sinks only if something changed
+	// and enough time passed since the previous one
+	bool m_updated;
+	double m_max_results_rate;
+	ullong m_last_result_timestamp;
+	bool m_any_result;
+
 	BrainWaveLevels m_bw;
 
 	void process_brain_waves(const INeuroonSignals & input);
 	void process_pulseoximetry(const INeuroonSignals & input);
 
 	void update_pulseoximeter_data(const INeuroonSignals & input);
-	void update_heart_rate(const INeuroonSignals & input);
-	void update_results();
+	void update_results(const INeuroonSignals & input);
+	void feed_result(const INeuroonSignals & input);
+	static ullong last_timestamp(const INeuroonSignals & input);
 
 public:
 
@@ -61,10 +91,19 @@ public:
 	virtual void reset_state() override;
 	virtual void process_input(const INeuroonSignals & input) override;
 	virtual void end_streaming(const INeuroonSignals & input) override;
+	virtual std::vector<int> eeg_decimations() const override;
 
 	void activate();
 	void deactivate();
 
+	static constexpr double DEFAULT_MAX_RESULTS_RATE = 30;
+
+	/**
+	 * Sets the maximal number of results per second, 0 means passing a result
+	 * after every update
+	 */
+	void set_max_results_rate(double results_per_second);
+
 private:
 };
 
@@ -0,0 +1,57 @@
+/*
+ * OnlineSignalQualityAlgorithm.cpp
+ */
+
+#include "OnlineSignalQualityAlgorithm.h"
+#include "Config.h"
+#include <algorithm>
+
+OnlineSignalQualityAlgorithm::OnlineSignalQualityAlgorithm(const std::vector<sink_t*> & sinks)
+: SinkStreamingAlgorithmSp<OnlineSignalQualityResult>(sinks)
+, m_quality(Config::instance().neuroon_eeg_freq())
+, m_active(false)
+{
+	reset_state();
+}
+
+OnlineSignalQualityAlgorithm::~OnlineSignalQualityAlgorithm() {}
+
+void OnlineSignalQualityAlgorithm::reset_state() {
+	m_quality.reset();
+	m_processed_samples = 0;
+	m_samples_since_result = 0;
+	m_results.clear();
+}
+
+void OnlineSignalQualityAlgorithm::process_input(const INeuroonSignals & input) {
+	// the samples are followed also when inactive, so the quality
+	// is up to date as soon as the measurement starts
+	const std::vector<double>& eeg = input.eeg_signal();
+	std::size_t total_samples = input.total_signal_samples(SignalOrigin::EEG);
+	std::size_t new_samples = std::min<std::size_t>(total_samples - std::min(m_processed_samples, total_samples), eeg.size());
+	m_processed_samples = total_samples;
+
+	m_results.clear();
+	for (auto it = eeg.end() - new_samples; it != eeg.end(); ++it) {
+		m_quality.consume(*it);
+		if (++m_samples_since_result == SAMPLES_PER_RESULT) {
+			m_samples_since_result = 0;
+			m_results.push_back(static_cast<ncSignalQuality>(m_quality.quality()));
+		}
+	}
+
+	if (m_active && !m_results.empty()) {
+		feed_all_sinks(std::make_shared<OnlineSignalQualityResult>(
+				OnlineSignalQualityResult{m_results.data(), static_cast<unsigned int>(m_results.size())}));
+	}
+}
+
+void OnlineSignalQualityAlgorithm::end_streaming(const INeuroonSignals &) {}
+
+void OnlineSignalQualityAlgorithm::activate() {
+	m_active = true;
+}
+
+void OnlineSignalQualityAlgorithm::deactivate() {
+	m_active = false;
+}
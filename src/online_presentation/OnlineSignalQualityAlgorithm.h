@@ -0,0 +1,57 @@
+/*
+ * OnlineSignalQualityAlgorithm.h
+ */
+
+#ifndef SRC_ONLINE_PRESENTATION_ONLINESIGNALQUALITYALGORITHM_H_
+#define SRC_ONLINE_PRESENTATION_ONLINESIGNALQUALITYALGORITHM_H_
+
+#include "CommonTypes.h"
+#include "StreamingAlgorithm.h"
+#include "StreamingEegQuality.h"
+#include <vector>
+
+#include "NeuroonSignalStreamApi.h"
+
+/**
+ * The grades of the EEG quality since the previous result, one per
+ * OnlineSignalQualityAlgorithm::SAMPLES_PER_RESULT EEG samples.
+ * The array is owned by the algorithm.
+ */
+struct OnlineSignalQualityResult {
+	const ncSignalQuality *results;
+	unsigned int count;
+};
+
+/**
+ * An implementation of a SinkStreamingAlgorithm for the online signal quality,
+ * i.e. the quick feedback while putting the mask on.
+ *
+ * Every new EEG sample is fed to a StreamingEegQuality and its grade
+ * is taken every SAMPLES_PER_RESULT samples.
+ */
+class OnlineSignalQualityAlgorithm : public SinkStreamingAlgorithmSp<OnlineSignalQualityResult> {
+public:
+	// 5 grades per second at 125 Hz
+	static const int SAMPLES_PER_RESULT = 25;
+
+	using sink_t = IDataSinkSp<OnlineSignalQualityResult>;
+
+	OnlineSignalQualityAlgorithm(const std::vector<sink_t*> & sinks);
+	virtual ~OnlineSignalQualityAlgorithm();
+
+	virtual void reset_state() override;
+	virtual void process_input(const INeuroonSignals & input) override;
+	virtual void end_streaming(const INeuroonSignals & input) override;
+
+	void activate();
+	void deactivate();
+
+private:
+	StreamingEegQuality m_quality;
+	std::size_t m_processed_samples;
+	int m_samples_since_result;
+	std::vector<ncSignalQuality> m_results;
+	bool m_active;
+};
+
+#endif /* SRC_ONLINE_PRESENTATION_ONLINESIGNALQUALITYALGORITHM_H_ */
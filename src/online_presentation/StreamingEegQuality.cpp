@@ -0,0 +1,121 @@
+/*
+ * StreamingEegQuality.cpp
+ */
+
+#include "StreamingEegQuality.h"
+#include <cmath>
+
+namespace {
+	const double BAND_LOW = 10;
+	const double BAND_HIGH = 14;
+	const double LINE_FREQUENCY = 50;
+	const double LINE_Q = 5;
+
+	// the Qs of the two sections of a 4th order Butterworth filter
+	const double BUTTERWORTH_4_Q1 = 0.5411961;
+	const double BUTTERWORTH_4_Q2 = 1.3065630;
+
+	// the time constant of the running means, in seconds
+	const double TIME_CONSTANT = 1;
+
+	// the logarithm of the sum of the magnitude spectrum (Spectrogram with an
+	// 8192-point window) in the band over the RMS of the band, for a noise-like
+	// signal: the magnitudes are Rayleigh distributed, so the sum over B bins
+	// is sqrt(pi) / 2 * N * sqrt(2 * B) * RMS, with N = 8192 and B = 262 at 125 Hz;
+	// the filters of the band don't pass exactly the band,
+	// which is corrected by their equivalent noise bandwidth (from the impulse response)
+	const double LOG_SPECTRUM_PER_RMS = 12.021;
+	const double BAND_NOISE_CORRECTION = -0.033;
+
+	// the borders of EegSignalQuality
+	const double QUALITY_BORDERS[] = {19, 18, 17.25, 16.5};
+	const int BEST_QUALITY = 4;
+	const int BAD_QUALITY = 2;
+	const int NO_SIGNAL_QUALITY = 0;
+
+	// the line noise RMS over the band RMS above which the quality is at most BAD
+	const double LINE_NOISE_RATIO = 3;
+
+	// |sample| at which the amplifier is saturated
+	const double SATURATION_LEVEL = 32000;
+
+	// the parts of the recent samples saturated or missing for NO_SIGNAL
+	const double SATURATED_PART = 0.05;
+	const double MISSING_PART = 0.05;
+
+	// the number of equal consecutive samples for NO_SIGNAL, 0.2 s at 125 Hz
+	const int FLAT_SAMPLES = 25;
+}
+
+StreamingEegQuality::StreamingEegQuality(double fs)
+: m_fs(fs)
+, m_filters({
+	{Biquad::high_pass(fs, BAND_LOW, BUTTERWORTH_4_Q1), Biquad::high_pass(fs, BAND_LOW, BUTTERWORTH_4_Q2),
+	 Biquad::low_pass(fs, BAND_HIGH, BUTTERWORTH_4_Q1), Biquad::low_pass(fs, BAND_HIGH, BUTTERWORTH_4_Q2)},
+	{Biquad::band_pass(fs, LINE_FREQUENCY, LINE_Q)}
+})
+, m_decay(1. / (TIME_CONSTANT * fs))
+{
+	reset();
+}
+
+void StreamingEegQuality::reset() {
+	m_filters.reset();
+	m_band_square = 0;
+	m_line_square = 0;
+	m_saturated = 0;
+	m_missing = 0;
+	m_weight = 0;
+	m_previous = NAN;
+	m_flat_samples = 0;
+}
+
+void StreamingEegQuality::consume(double sample) {
+	// the weight of the running means, so they're unbiased from the start
+	m_weight += m_decay * (1 - m_weight);
+
+	bool missing = std::isnan(sample);
+	m_missing += m_decay * (missing - m_missing);
+	if (missing) {
+		m_flat_samples = 0;
+		return;
+	}
+
+	m_saturated += m_decay * ((std::abs(sample) >= SATURATION_LEVEL) - m_saturated);
+	m_flat_samples = sample == m_previous ? m_flat_samples + 1 : 0;
+	m_previous = sample;
+
+	double filtered[2];
+	m_filters.process_broadcast(&sample, 1, filtered);
+	m_band_square += m_decay * (filtered[0] * filtered[0] - m_band_square);
+	m_line_square += m_decay * (filtered[1] * filtered[1] - m_line_square);
+}
+
+double StreamingEegQuality::band_rms() const {
+	return m_weight > 0 ? std::sqrt(m_band_square / m_weight) : 0;
+}
+
+double StreamingEegQuality::band_power() const {
+	return LOG_SPECTRUM_PER_RMS + BAND_NOISE_CORRECTION + std::log(band_rms());
+}
+
+int StreamingEegQuality::quality() const {
+	if (m_weight == 0 || m_flat_samples >= FLAT_SAMPLES
+			|| m_saturated > SATURATED_PART * m_weight || m_missing > MISSING_PART * m_weight) {
+		return NO_SIGNAL_QUALITY;
+	}
+
+	double power = band_power();
+	int result = BEST_QUALITY;
+	for (int i = 0; i != BEST_QUALITY; ++i) {
+		if (power >= QUALITY_BORDERS[i]) {
+			result = i;
+			break;
+		}
+	}
+
+	if (result > BAD_QUALITY && m_line_square > LINE_NOISE_RATIO * LINE_NOISE_RATIO * m_band_square) {
+		result = BAD_QUALITY;
+	}
+	return result;
+}
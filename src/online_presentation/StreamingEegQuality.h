@@ -0,0 +1,68 @@
+/*
+ * StreamingEegQuality.h
+ */
+
+#ifndef SRC_ONLINE_PRESENTATION_STREAMINGEEGQUALITY_H_
+#define SRC_ONLINE_PRESENTATION_STREAMINGEEGQUALITY_H_
+
+#include "FilterBank.h"
+
+/**
+ * Estimates the quality of the EEG signal sample by sample, from
+ * time-domain statistics updated in O(1) per sample, so the quality follows
+ * the contact of the electrodes within a second, e.g. while the mask is
+ * being put on.
+ *
+ * The main measure is the running RMS in the 10-14 Hz band, converted to
+ * the scale of EegSignalQuality (the logarithm of the sum of the magnitude
+ * spectrum in that band for an 8192-point window) and graded with the same
+ * borders, so both give the same grades for a stationary signal. On top of
+ * that, the signal is graded NO_SIGNAL when it's flat (no contact), saturated
+ * or missing (NaN), and at most BAD when the 50 Hz line noise dominates.
+ */
+class StreamingEegQuality {
+public:
+	/**
+	 * @param fs : the sampling frequency of the EEG
+	 */
+	StreamingEegQuality(double fs);
+
+	void consume(double sample);
+
+	/**
+	 * @return the quality of the recent signal, with the values of ncSignalQuality:
+	 * 4 is the best, 0 is the worst (no signal)
+	 */
+	int quality() const;
+
+	/**
+	 * @return the running RMS of the 10-14 Hz band
+	 */
+	double band_rms() const;
+
+	/**
+	 * @return the running RMS of the band on the scale of EegSignalQuality
+	 */
+	double band_power() const;
+
+	void reset();
+
+private:
+	double m_fs;
+
+	// channel 0: the 10-14 Hz band, channel 1: the line noise
+	FilterBank m_filters;
+	double m_decay;
+
+	// exponentially weighted means
+	double m_band_square;
+	double m_line_square;
+	double m_saturated;
+	double m_missing;
+	double m_weight;
+
+	double m_previous;
+	int m_flat_samples;
+};
+
+#endif /* SRC_ONLINE_PRESENTATION_STREAMINGEEGQUALITY_H_ */
@@ -22,14 +22,8 @@ dlib::matrix<double> AmplitudeFilter::transform(const dlib::matrix<double> &data
 
 	LOG(WARNING) << "filter: " << filter_column(0,0);
 
-	dlib::matrix<int> incorrect_rows = rows_greater_than(filter_column, m_critical_value);
 	dlib::matrix<double> result = data;
-
-	if (incorrect_rows.size() > 0) {
-		dlib::matrix<double> incorrect_data(incorrect_rows.size(), data.nc());
-		dlib::set_all_elements(incorrect_data, NAN);
-		dlib::set_rowm(result, incorrect_rows) = incorrect_data;
-	}
+	set_selected_rows(result, greater_than_mask(filter_column, m_critical_value), NAN);
 	return result;
 }
 
@@ -20,16 +20,12 @@ EntropyFilter::~EntropyFilter() {
 	// TODO Auto-generated destructor stub
 }
 
-dlib::matrix<double> EntropyFilter::transform(const dlib::matrix<double> &data) {
-	dlib::matrix<double> entropies(data.nr(), 1);
+dlib::matrix<unsigned char> EntropyFilter::rejected_rows(const dlib::matrix<double> &data) const {
+	return greater_than_mask(row_entropies(data), m_critical_value);
+}
 
-	dlib::matrix<double> result(data.nr(), data.nc());
-	result = data;
-	for (int i = 0; i != entropies.nr(); ++i) {
-		double entr = entropy(dlib::rowm(data, i));
-		if (entr > m_critical_value) {
-			dlib::set_rowm(result, i) = NAN;
-		}
-	}
+dlib::matrix<double> EntropyFilter::transform(const dlib::matrix<double> &data) const {
+	dlib::matrix<double> result = data;
+	set_selected_rows(result, rejected_rows(data), NAN);
 	return result;
 }
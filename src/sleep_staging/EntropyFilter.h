@@ -29,14 +29,22 @@ public:
 	EntropyFilter(double critical_value);
 	virtual ~EntropyFilter();
 
+    /**
+     * Returns a mask (see dlib_utils.h) selecting the most noisy samples, i.e.
+     * the rows with entropy greater than the critical value. The entropies of
+     * all the rows are computed in a single batch.
+     *
+     * @param data : the spectrogram to be filtered.
+     */
+	dlib::matrix<unsigned char> rejected_rows(const dlib::matrix<double> &data) const;
+
     /**
      * Returns a matrix that is a copy of the input matrix, except that the most
-     * noisy samples (those with entropy greater than the critical value) are 
-     * set to NaN
+     * noisy samples (those selected by rejected_rows) are set to NaN
      *
      * @param data : the spectrogram to be filtered.
      */
-	dlib::matrix<double> transform(const dlib::matrix<double> &data);
+	dlib::matrix<double> transform(const dlib::matrix<double> &data) const;
 
 };
 
@@ -9,7 +9,7 @@
 #include "Spectrogram.h"
 #include <cmath>
 #include <algorithm>
-#include <iostream>
+#include "Diagnostics.h"
 #include <exception>
 #include <functional>
 #include "dlib_utils.h"
@@ -63,13 +63,19 @@ dlib::matrix<double> Features::rolling_mean(const dlib::matrix<double> &signal,
 	if (signal.nr() < window_size) {
 		throw std::logic_error("rolling_mean: window bigger than signal!");
 	}
+	if (signal.nc() != 1) {
+		throw std::logic_error("rolling_mean: only column signals are supported");
+	}
 
 	dlib::matrix<double> result(signal.nr(), 1);
 	dlib::set_all_elements(result, NAN);
-	for (size_t i = 0; i != signal.nr() - window_size; ++i) {
-		dlib::matrix<double> window = dlib::rowm(signal, dlib::range(i, i+window_size-1));
 
-		double sum = dlib::sum(window);
+	const double* data = signal.begin();
+	for (long i = 0; i != signal.nr() - window_size; ++i) {
+		double sum = 0;
+		for (int j = 0; j != window_size; ++j) {
+			sum += data[i + j];
+		}
 		double mean = sum / window_size;
 		result(i + (window_size/2), 0) = mean;
 	}
@@ -77,12 +83,16 @@ dlib::matrix<double> Features::rolling_mean(const dlib::matrix<double> &signal,
 }
 
 dlib::matrix<double> Features::rolling_std(const dlib::matrix<double> &signal, int window_size) {
+	if (signal.nc() != 1) {
+		throw std::logic_error("rolling_std: only column signals are supported");
+	}
+
 	dlib::matrix<double> result(signal.nr(), 1);
 	dlib::set_all_elements(result, NAN);
-	for (size_t i = 0; i != signal.nr() - window_size; ++i) {
-		const dlib::matrix<double> window = dlib::rowm(signal, dlib::range(i, i+window_size-1));
 
-		double sd = standard_deviation(window);
+	const double* data = signal.begin();
+	for (long i = 0; i < signal.nr() - window_size; ++i) {
+		double sd = standard_deviation(data + i, window_size);
 		result(i + (window_size/2), 0) = sd;
 	}
 	return result;
@@ -94,19 +104,16 @@ dlib::matrix<double> Features::rolling_std(const dlib::matrix<double> &signal, i
 dlib::matrix<double> Features::sparse_rolling(const dlib::matrix<double> &signal, int window_size,
 												 std::function<dlib::matrix<double> (const dlib::matrix<double>&, int)> rolling_operation) {
 
-	dlib::matrix<double> index(signal.nr(), 1);
-	dlib::set_colm(index, 0) = dlib::trans(dlib::range(0, signal.nr() - 1));
-	dlib::matrix<int> nonnans = nonnan_rows(signal);
-
-	dlib::matrix<double> result(signal.nr(), signal.nc());
-	dlib::set_all_elements(result, NAN);
+	dlib::matrix<unsigned char> finite = finite_rows_mask(signal);
 
-	if (nonnans.size() > 0) {
-		dlib::matrix<double> rolling_input = dlib::rowm(signal, nonnans);
-		dlib::set_rowm(result, nonnans) = rolling_operation(rolling_input, window_size);
+	if (count_selected(finite) == 0) {
+		dlib::matrix<double> result(signal.nr(), signal.nc());
+		dlib::set_all_elements(result, NAN);
+		return result;
 	}
 
-	return result;
+	dlib::matrix<double> rolling_input = compact_rows(signal, finite);
+	return expand_rows(rolling_operation(rolling_input, window_size), finite, NAN);
 }
 
 dlib::matrix<double> Features::sparse_rolling_mean(const dlib::matrix<double> &signal, int window_size) {
@@ -146,17 +153,17 @@ dlib::matrix<double> Features::n_max_to_median(const dlib::matrix<double> &data,
 
 
 dlib::matrix<double> Features::standardize(const dlib::matrix<double> &signal) {
-	dlib::matrix<int> nonnans = nonnan_rows(signal);
+	dlib::matrix<unsigned char> finite = finite_rows_mask(signal);
 
-	if (nonnans.nr() == 0) {
+	if (count_selected(finite) == 0) {
 		dlib::matrix<double> result(signal.nr(), signal.nc());
 		dlib::set_all_elements(result, NAN);
 		return result;
 	} else {
-		dlib::matrix<double> correct_rows = dlib::rowm(signal, nonnans);
+		dlib::matrix<double> correct_rows = compact_rows(signal, finite);
 		double mean = dlib::mean(correct_rows);
 		double sd = standard_deviation(correct_rows);
-		std::cout << "mean: " << mean << "; std: " << sd << std::endl;
+		DIAG_TRACE("features.standardize") << "mean: " << mean << "; std: " << sd;
 		dlib::matrix<double> result = (signal - mean) / sd;
 		return result;
 	}
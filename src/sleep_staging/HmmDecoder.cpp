@@ -0,0 +1,239 @@
+/*
+ * HmmDecoder.cpp
+ */
+
+#include "HmmDecoder.h"
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include "ThreadPool.h"
+
+HmmDecoder::HmmDecoder(const dlib::matrix<double>& transition_matrix,
+					   const dlib::matrix<double>& start_probabilities,
+					   const dlib::matrix<double>& final_probabilities,
+					   double viterbi_weight)
+: m_states(transition_matrix.nr())
+, m_transitions(m_states * m_states)
+, m_log_transitions(m_states * m_states)
+, m_start_p(m_states)
+, m_final_p(m_states)
+{
+	if (m_states == 0 || transition_matrix.nc() != m_states) {
+		throw std::logic_error("the transition matrix has to be square and not empty");
+	}
+	if (m_states > std::numeric_limits<unsigned char>::max()) {
+		throw std::logic_error("the decoder supports up to 255 states");
+	}
+	if (start_probabilities.size() != m_states || final_probabilities.size() != m_states) {
+		throw std::logic_error("the start and final probabilities have to be given for each state");
+	}
+
+	for (long state = 0; state != m_states; ++state) {
+		for (long next_state = 0; next_state != m_states; ++next_state) {
+			double p = std::pow(transition_matrix(state, next_state), viterbi_weight);
+			m_transitions[next_state * m_states + state] = p;
+			m_log_transitions[next_state * m_states + state] = std::log(p);
+		}
+		m_start_p[state] = start_probabilities(state);
+		m_final_p[state] = final_probabilities(state);
+	}
+}
+
+HmmDecoder::HmmDecoder(const dlib::matrix<double>& transition_matrix, double viterbi_weight)
+: HmmDecoder(transition_matrix,
+			 dlib::uniform_matrix<double>(transition_matrix.nr(), 1, 1. / transition_matrix.nr()),
+			 dlib::uniform_matrix<double>(transition_matrix.nr(), 1, 1. / transition_matrix.nr()),
+			 viterbi_weight)
+{}
+
+long HmmDecoder::states() const {
+	return m_states;
+}
+
+void HmmDecoder::check_emissions(const dlib::matrix<double>& emissions) const {
+	if (emissions.nc() != m_states) {
+		std::stringstream ss;
+		ss << "the emissions have " << emissions.nc() << " columns, the model has " << m_states << " states";
+		throw std::logic_error(ss.str());
+	}
+}
+
+/*
+ * Copies the emissions of the epoch to 'row', returns false for a rejected epoch,
+ * which gets equal emissions for all the states.
+ */
+bool HmmDecoder::emission_row(const dlib::matrix<double>& emissions, long epoch, double* row) const {
+	const double* source = &emissions(epoch, 0);
+	bool finite = true;
+	for (long state = 0; state != m_states; ++state) {
+		row[state] = source[state];
+		finite = finite && std::isfinite(source[state]);
+	}
+	if (!finite) {
+		std::fill(row, row + m_states, 1.);
+	}
+	return finite;
+}
+
+std::vector<int> HmmDecoder::viterbi(const dlib::matrix<double>& emissions) const {
+	check_emissions(emissions);
+	const long epochs = emissions.nr();
+	std::vector<int> path(epochs);
+	if (epochs == 0) {
+		return path;
+	}
+
+	std::vector<double> log_probs(m_states);
+	std::vector<double> next_log_probs(m_states);
+	std::vector<double> emission(m_states);
+	std::vector<unsigned char> backpointers(epochs * m_states);
+
+	emission_row(emissions, 0, emission.data());
+	for (long state = 0; state != m_states; ++state) {
+		log_probs[state] = std::log(emission[state]) + std::log(m_start_p[state]);
+	}
+
+	for (long epoch = 1; epoch != epochs; ++epoch) {
+		emission_row(emissions, epoch, emission.data());
+		unsigned char* previous_states = &backpointers[epoch * m_states];
+		for (long next_state = 0; next_state != m_states; ++next_state) {
+			const double* log_transitions = &m_log_transitions[next_state * m_states];
+			long best_state = 0;
+			double best_log_prob = -std::numeric_limits<double>::infinity();
+			for (long state = 0; state != m_states; ++state) {
+				double log_prob = log_probs[state] + log_transitions[state];
+				if (log_prob > best_log_prob) {
+					best_log_prob = log_prob;
+					best_state = state;
+				}
+			}
+			next_log_probs[next_state] = best_log_prob + std::log(emission[next_state]);
+			previous_states[next_state] = static_cast<unsigned char>(best_state);
+		}
+		log_probs.swap(next_log_probs);
+	}
+
+	for (long state = 0; state != m_states; ++state) {
+		log_probs[state] += std::log(m_final_p[state]);
+	}
+
+	int state = std::max_element(log_probs.begin(), log_probs.end()) - log_probs.begin();
+	for (long epoch = epochs - 1; epoch >= 0; --epoch) {
+		path[epoch] = state;
+		state = backpointers[epoch * m_states + state];
+	}
+	return path;
+}
+
+dlib::matrix<double> HmmDecoder::posteriors(const dlib::matrix<double>& emissions) const {
+	check_emissions(emissions);
+	const long epochs = emissions.nr();
+	dlib::matrix<double> result(epochs, m_states);
+	if (epochs == 0) {
+		return result;
+	}
+
+	// the scaled forward probabilities are stored directly in the result,
+	// the backward pass multiplies them in place. The final probabilities
+	// are the backward probabilities of the last epoch.
+	std::vector<double> emission(m_states);
+	std::vector<double> beta(m_final_p);
+	std::vector<double> next_beta(m_states);
+	std::vector<double> scales(epochs);
+
+	for (long epoch = 0; epoch != epochs; ++epoch) {
+		emission_row(emissions, epoch, emission.data());
+		double* alpha = &result(epoch, 0);
+		if (epoch == 0) {
+			for (long state = 0; state != m_states; ++state) {
+				alpha[state] = m_start_p[state] * emission[state];
+			}
+		} else {
+			const double* previous_alpha = &result(epoch - 1, 0);
+			for (long next_state = 0; next_state != m_states; ++next_state) {
+				const double* transitions = &m_transitions[next_state * m_states];
+				double sum = 0;
+				for (long state = 0; state != m_states; ++state) {
+					sum += previous_alpha[state] * transitions[state];
+				}
+				alpha[next_state] = sum * emission[next_state];
+			}
+		}
+		double sum = 0;
+		for (long state = 0; state != m_states; ++state) {
+			sum += alpha[state];
+		}
+		if (sum <= 0) {
+			throw std::logic_error("the emissions have zero probability under the model");
+		}
+		scales[epoch] = 1. / sum;
+		for (long state = 0; state != m_states; ++state) {
+			alpha[state] *= scales[epoch];
+		}
+	}
+
+	for (long epoch = epochs - 1; epoch >= 0; --epoch) {
+		double* posterior = &result(epoch, 0);
+		double sum = 0;
+		for (long state = 0; state != m_states; ++state) {
+			posterior[state] *= beta[state];
+			sum += posterior[state];
+		}
+		if (sum <= 0) {
+			throw std::logic_error("the emissions have zero probability under the model");
+		}
+		for (long state = 0; state != m_states; ++state) {
+			posterior[state] *= 1. / sum;
+		}
+
+		if (epoch == 0) {
+			break;
+		}
+
+		// beta of the previous epoch, from the emissions of this one
+		emission_row(emissions, epoch, emission.data());
+		for (long state = 0; state != m_states; ++state) {
+			emission[state] *= beta[state];
+		}
+		std::fill(next_beta.begin(), next_beta.end(), 0.);
+		for (long next_state = 0; next_state != m_states; ++next_state) {
+			const double* transitions = &m_transitions[next_state * m_states];
+			const double weight = emission[next_state] * scales[epoch];
+			for (long state = 0; state != m_states; ++state) {
+				next_beta[state] += transitions[state] * weight;
+			}
+		}
+		beta.swap(next_beta);
+	}
+
+	return result;
+}
+
+std::vector<std::vector<int>> HmmDecoder::viterbi(const std::vector<dlib::matrix<double>>& nights, ThreadPool& pool) const {
+	std::vector<std::future<std::vector<int>>> futures;
+	for (const dlib::matrix<double>& night : nights) {
+		futures.push_back(pool.submit([this, &night]() { return viterbi(night); }));
+	}
+
+	std::vector<std::vector<int>> result;
+	for (auto& future : futures) {
+		result.push_back(future.get());
+	}
+	return result;
+}
+
+std::vector<dlib::matrix<double>> HmmDecoder::posteriors(const std::vector<dlib::matrix<double>>& nights, ThreadPool& pool) const {
+	std::vector<std::future<dlib::matrix<double>>> futures;
+	for (const dlib::matrix<double>& night : nights) {
+		futures.push_back(pool.submit([this, &night]() { return posteriors(night); }));
+	}
+
+	std::vector<dlib::matrix<double>> result;
+	for (auto& future : futures) {
+		result.push_back(future.get());
+	}
+	return result;
+}
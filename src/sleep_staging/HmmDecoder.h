@@ -0,0 +1,81 @@
+/*
+ * HmmDecoder.h
+ *
+ * Smoothing of a whole night of staging with a hidden Markov model.
+ */
+
+#ifndef SRC_SLEEP_STAGING_HMMDECODER_H_
+#define SRC_SLEEP_STAGING_HMMDECODER_H_
+
+#include <dlib/matrix.h>
+#include <vector>
+
+class ThreadPool;
+
+/**
+ * Decodes a whole sequence of emission probabilities at once, i.e. the batch
+ * counterpart of OnLineViterbiSearch. The emissions are given as a matrix with
+ * one row per epoch and one column per state, e.g. the output of
+ * MlpClassifier::predict_proba. Rows containing NaNs (rejected epochs) are
+ * treated as carrying no information about the state.
+ *
+ * The inner loops run over the states on contiguous rows, with the transition
+ * matrix stored transposed.
+ * The decoder has no mutable state, so many nights can be decoded in parallel.
+ */
+class HmmDecoder {
+public:
+	/**
+	 * @param transition_matrix : states x states, the probabilities of transitions
+	 * from the row state to the column state
+	 * @param start_probabilities, final_probabilities : column matrices with the
+	 * probabilities of the states at the first and the last epoch
+	 * @param viterbi_weight : the power applied to the transition matrix,
+	 * see OnLineViterbiSearch
+	 */
+	HmmDecoder(const dlib::matrix<double>& transition_matrix,
+			   const dlib::matrix<double>& start_probabilities,
+			   const dlib::matrix<double>& final_probabilities,
+			   double viterbi_weight = 1);
+
+	/**
+	 * Creates a decoder with uniform start and final probabilities
+	 */
+	HmmDecoder(const dlib::matrix<double>& transition_matrix, double viterbi_weight = 1);
+
+	long states() const;
+
+	/**
+	 * @return the indices of the states on the most probable path, one per epoch
+	 */
+	std::vector<int> viterbi(const dlib::matrix<double>& emissions) const;
+
+	/**
+	 * Computes the posterior probabilities of the states with the forward-backward
+	 * algorithm, normalized at each epoch to avoid underflows.
+	 * @return epochs x states, each row summing to 1
+	 */
+	dlib::matrix<double> posteriors(const dlib::matrix<double>& emissions) const;
+
+	/**
+	 * Decodes many nights, each of them as a separate task of the pool
+	 */
+	std::vector<std::vector<int>> viterbi(const std::vector<dlib::matrix<double>>& nights, ThreadPool& pool) const;
+
+	std::vector<dlib::matrix<double>> posteriors(const std::vector<dlib::matrix<double>>& nights, ThreadPool& pool) const;
+
+private:
+	void check_emissions(const dlib::matrix<double>& emissions) const;
+	bool emission_row(const dlib::matrix<double>& emissions, long epoch, double* row) const;
+
+	long m_states;
+
+	// both transposed, i.e. [next state][previous state]
+	std::vector<double> m_transitions;
+	std::vector<double> m_log_transitions;
+
+	std::vector<double> m_start_p;
+	std::vector<double> m_final_p;
+};
+
+#endif /* SRC_SLEEP_STAGING_HMMDECODER_H_ */
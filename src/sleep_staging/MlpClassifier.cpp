@@ -7,23 +7,73 @@
 
 #include "MlpClassifier.h"
 
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+#include "Diagnostics.h"
 #include "dlib_utils.h"
 
-MlpClassifier::MlpClassifier(std::vector<dlib::matrix<double>> weights, std::vector<dlib::matrix<double>> intercepts)
+MlpClassifier::MlpClassifier(std::vector<dlib::matrix<double>> weights, std::vector<dlib::matrix<double>> intercepts,
+							 bool quantized)
 : m_mlp(weights, intercepts)
+{
+	if (quantized) {
+		m_mlp.quantize();
+	}
+}
+
+MlpClassifier::MlpClassifier(std::vector<dlib::matrix<signed char>> quantized_weights,
+							 std::vector<dlib::matrix<double>> scales,
+							 std::vector<dlib::matrix<double>> intercepts)
+: m_mlp(quantized_weights, scales, intercepts)
 {}
 
+MlpClassifier::MlpClassifier(std::shared_ptr<const StagingModel> model)
+: m_mlp(model)
+{}
+
+std::unique_ptr<MlpClassifier> MlpClassifier::load_quantized(const std::string& directory) {
+	std::vector<dlib::matrix<signed char>> quantized_weights;
+	std::vector<dlib::matrix<double>> scales;
+	std::vector<dlib::matrix<double>> intercepts;
+
+	for (int layer = 1; ; ++layer) {
+		std::string name = directory + "/w" + std::to_string(layer);
+		if (!std::ifstream(name + "_int8.csv").good()) {
+			break;
+		}
+
+		dlib::matrix<double> weights = load_matrix(name + "_int8.csv");
+		dlib::matrix<signed char> quantized(weights.nr(), weights.nc());
+		for (long k = 0; k != weights.nr(); ++k) {
+			for (long j = 0; j != weights.nc(); ++j) {
+				double w = weights(k, j);
+				if (w != std::round(w) || std::abs(w) > 127) {
+					throw std::logic_error("not an int8 weight in " + name + "_int8.csv");
+				}
+				quantized(k, j) = static_cast<signed char>(w);
+			}
+		}
+		quantized_weights.push_back(quantized);
+		scales.push_back(load_matrix(name + "_scales.csv"));
+		intercepts.push_back(load_matrix(directory + "/i" + std::to_string(layer) + ".csv"));
+	}
+
+	if (quantized_weights.empty()) {
+		throw std::logic_error("no quantized layers in " + directory);
+	}
+	return std::unique_ptr<MlpClassifier>(new MlpClassifier(quantized_weights, scales, intercepts));
+}
+
 MlpClassifier::~MlpClassifier() {}
 
 dlib::matrix<int> MlpClassifier::predict(const dlib::matrix<double>& input) {
 	dlib::matrix<double> mlp_output = m_mlp.predict(input);
-	std::cout << "stages nan ratio: " << nan_ratio(mlp_output) << std::endl;
+	DIAG_TRACE("mlp.stages_nan_ratio") << nan_ratio(mlp_output);
 	dlib::matrix<int> classes_output = argmax(mlp_output);
 	return classes_output;
 }
 
 dlib::matrix<double> MlpClassifier::predict_proba(const dlib::matrix<double>& input) {
-	dlib::matrix<double> mlp_output = m_mlp.predict(input);
-	dlib::matrix<double> probabilities = softmax(mlp_output);
-	return probabilities;
+	return m_mlp.predict_proba(input);
 }
@@ -8,6 +8,8 @@
 #ifndef SRC_SLEEP_STAGING_MLPCLASSIFIER_H_
 #define SRC_SLEEP_STAGING_MLPCLASSIFIER_H_
 
+#include <memory>
+#include <string>
 #include <vector>
 #include <dlib/matrix.h>
 #include "MultilayerPerceptron.h"
@@ -26,7 +28,31 @@ private:
 
 public:
 
-	MlpClassifier(std::vector<dlib::matrix<double>> weights, std::vector<dlib::matrix<double>> intercepts);
+	/**
+	 * @param quantized : whether to compute with int8 quantized weights, see MultilayerPerceptron
+	 */
+	MlpClassifier(std::vector<dlib::matrix<double>> weights, std::vector<dlib::matrix<double>> intercepts,
+				  bool quantized = false);
+
+	/**
+	 * Creates a classifier computing with already quantized weights, e.g. the ones
+	 * saved by the mlp_quantizer tool
+	 */
+	MlpClassifier(std::vector<dlib::matrix<signed char>> quantized_weights,
+				  std::vector<dlib::matrix<double>> scales,
+				  std::vector<dlib::matrix<double>> intercepts);
+
+	/**
+	 * Creates a classifier using the MLP layers of the model in place
+	 */
+	MlpClassifier(std::shared_ptr<const StagingModel> model);
+
+	/**
+	 * Loads a quantized classifier saved by the mlp_quantizer tool, i.e. the files
+	 * w<n>_int8.csv, w<n>_scales.csv and i<n>.csv for the layers n = 1, 2, ...
+	 * in 'directory'. Throws std::logic_error if the files are missing or invalid.
+	 */
+	static std::unique_ptr<MlpClassifier> load_quantized(const std::string& directory);
 
 	virtual ~MlpClassifier();
 
@@ -0,0 +1,103 @@
+/*
+ * MlpFixedShape.h
+ *
+ * Forward pass of a multilayer perceptron with the layer sizes known at
+ * compile time. All the loop bounds are constants and the layers are called
+ * directly, without the checks and the dispatch of the generic path.
+ * The MultilayerPerceptron switches to it for the shapes it knows about.
+ */
+
+#ifndef SRC_SLEEP_STAGING_MLPFIXEDSHAPE_H_
+#define SRC_SLEEP_STAGING_MLPFIXEDSHAPE_H_
+
+#include <cstddef>
+#include "MlpKernels.h"
+
+/**
+ * Same as mlp_dense_layer, but with the numbers of inputs and outputs fixed.
+ * The products are accumulated in the same order, so the results are the same.
+ */
+template <long INPUTS, long OUTPUTS>
+inline void mlp_fixed_dense_layer(const double* input, long rows,
+								  const double* weights, const double* bias,
+								  MlpActivation activation, double* output) {
+	for (long r = 0; r != rows; ++r) {
+		const double* x = input + r * INPUTS;
+		double* y = output + r * OUTPUTS;
+
+		for (long j = 0; j != OUTPUTS; ++j) {
+			y[j] = bias[j];
+		}
+		for (long k = 0; k != INPUTS; ++k) {
+			const double xk = x[k];
+			const double* weights_row = weights + k * OUTPUTS;
+			for (long j = 0; j != OUTPUTS; ++j) {
+				y[j] += xk * weights_row[j];
+			}
+		}
+
+		if (activation == MlpActivation::RELU) {
+			for (long j = 0; j != OUTPUTS; ++j) {
+				// written so that NaN is propagated, as in mlp_dense_layer
+				y[j] = y[j] < 0 ? 0. : y[j];
+			}
+		} else if (activation == MlpActivation::SOFTMAX) {
+			mlp_softmax_rows(y, 1, OUTPUTS);
+		}
+	}
+}
+
+/**
+ * The network with the consecutive layer sizes SIZES, i.e. the number of
+ * inputs followed by the numbers of outputs of every layer.
+ */
+template <long... SIZES>
+struct MlpFixedShape;
+
+template <long INPUTS, long OUTPUTS>
+struct MlpFixedShape<INPUTS, OUTPUTS> {
+	static const size_t LAYERS = 1;
+
+	// the number of intermediate values computed for each input row
+	static const long SCRATCH = 0;
+
+	/**
+	 * @param sizes : the inputs of the first layer and the outputs of every layer
+	 */
+	static bool matches(const long* sizes, size_t layers) {
+		return layers == LAYERS && sizes[0] == INPUTS && sizes[1] == OUTPUTS;
+	}
+
+	/**
+	 * @param weights, biases, activations : the parameters of the consecutive layers
+	 * @param scratch : room for rows * SCRATCH values
+	 * @param output : rows x the outputs of the last layer, row-major
+	 */
+	static void forward(const double* input, long rows,
+						const double* const* weights, const double* const* biases,
+						const MlpActivation* activations, double* scratch, double* output) {
+		(void) scratch;
+		mlp_fixed_dense_layer<INPUTS, OUTPUTS>(input, rows, weights[0], biases[0], activations[0], output);
+	}
+};
+
+template <long INPUTS, long HIDDEN, long... REST>
+struct MlpFixedShape<INPUTS, HIDDEN, REST...> {
+	typedef MlpFixedShape<HIDDEN, REST...> Next;
+
+	static const size_t LAYERS = Next::LAYERS + 1;
+	static const long SCRATCH = Next::SCRATCH + HIDDEN;
+
+	static bool matches(const long* sizes, size_t layers) {
+		return layers == LAYERS && sizes[0] == INPUTS && Next::matches(sizes + 1, layers - 1);
+	}
+
+	static void forward(const double* input, long rows,
+						const double* const* weights, const double* const* biases,
+						const MlpActivation* activations, double* scratch, double* output) {
+		mlp_fixed_dense_layer<INPUTS, HIDDEN>(input, rows, weights[0], biases[0], activations[0], scratch);
+		Next::forward(scratch, rows, weights + 1, biases + 1, activations + 1, scratch + rows * HIDDEN, output);
+	}
+};
+
+#endif /* SRC_SLEEP_STAGING_MLPFIXEDSHAPE_H_ */
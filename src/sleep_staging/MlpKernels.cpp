@@ -0,0 +1,216 @@
+/*
+ * MlpKernels.cpp
+ */
+
+#include "MlpKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace {
+
+// the tile of the output computed at once, ROW_BLOCK x COLUMN_BLOCK doubles
+// fits comfortably in the L1 cache
+const long ROW_BLOCK = 4;
+const long COLUMN_BLOCK = 32;
+
+}
+
+void mlp_softmax_rows(double* data, long rows, long cols) {
+	for (long i = 0; i != rows; ++i) {
+		double* row = data + i * cols;
+
+		// subtracting the maximum doesn't change the result but prevents
+		// exp from overflowing
+		double max = row[0];
+		for (long j = 1; j < cols; ++j) {
+			max = row[j] > max ? row[j] : max;
+		}
+
+		double sum = 0;
+		for (long j = 0; j != cols; ++j) {
+			row[j] = std::exp(row[j] - max);
+			sum += row[j];
+		}
+
+		const double scale = 1. / sum;
+		for (long j = 0; j != cols; ++j) {
+			row[j] *= scale;
+		}
+	}
+}
+
+namespace {
+
+// the inputs of a quantized layer are quantized per row to int16, so their
+// error is negligible next to the one of the int8 weights; the products of
+// INPUT_BLOCK of them with the weights always fit in an int32
+const long INPUT_BLOCK = 256;
+const double INT16_MAX_VALUE = 32767;
+
+/*
+ * Applies the activation to a computed tile of the output
+ */
+void store_tile(const double (&tile)[ROW_BLOCK][COLUMN_BLOCK], long block_rows, long block_columns,
+				MlpActivation activation, double* output, long outputs) {
+	for (long r = 0; r != block_rows; ++r) {
+		double* output_row = output + r * outputs;
+		if (activation == MlpActivation::RELU) {
+			// written this way NaNs are propagated, while std::max(0., x)
+			// would turn them into zeros
+			for (long c = 0; c != block_columns; ++c) {
+				output_row[c] = tile[r][c] < 0 ? 0. : tile[r][c];
+			}
+		} else {
+			for (long c = 0; c != block_columns; ++c) {
+				output_row[c] = tile[r][c];
+			}
+		}
+	}
+}
+
+}
+
+void mlp_dense_layer(const double* input, long rows, long inputs,
+					 const double* weights, const double* bias, long outputs,
+					 MlpActivation activation, double* output) {
+	double tile[ROW_BLOCK][COLUMN_BLOCK];
+
+	for (long first_row = 0; first_row < rows; first_row += ROW_BLOCK) {
+		const long block_rows = std::min(ROW_BLOCK, rows - first_row);
+
+		for (long first_column = 0; first_column < outputs; first_column += COLUMN_BLOCK) {
+			const long block_columns = std::min(COLUMN_BLOCK, outputs - first_column);
+
+			for (long r = 0; r != block_rows; ++r) {
+				for (long c = 0; c != block_columns; ++c) {
+					tile[r][c] = bias[first_column + c];
+				}
+			}
+
+			for (long k = 0; k != inputs; ++k) {
+				const double* weights_row = weights + k * outputs + first_column;
+				for (long r = 0; r != block_rows; ++r) {
+					const double x = input[(first_row + r) * inputs + k];
+					for (long c = 0; c != block_columns; ++c) {
+						tile[r][c] += x * weights_row[c];
+					}
+				}
+			}
+
+			store_tile(tile, block_rows, block_columns, activation,
+					   output + first_row * outputs + first_column, outputs);
+		}
+
+		if (activation == MlpActivation::SOFTMAX) {
+			// the rows of the block are still in the cache
+			mlp_softmax_rows(output + first_row * outputs, block_rows, outputs);
+		}
+	}
+}
+
+void mlp_dense_layer_int8(const double* input, long rows, long inputs,
+						  const signed char* quantized_weights, const double* scales,
+						  const double* bias, long outputs,
+						  MlpActivation activation, double* output) {
+	std::int16_t quantized_input[ROW_BLOCK][INPUT_BLOCK];
+	double input_scales[ROW_BLOCK];
+	double input_inverse_scales[ROW_BLOCK];
+	std::int32_t products[ROW_BLOCK][COLUMN_BLOCK];
+	double tile[ROW_BLOCK][COLUMN_BLOCK];
+
+	for (long first_row = 0; first_row < rows; first_row += ROW_BLOCK) {
+		const long block_rows = std::min(ROW_BLOCK, rows - first_row);
+
+		for (long r = 0; r != block_rows; ++r) {
+			const double* input_row = input + (first_row + r) * inputs;
+			bool finite = true;
+			double max_abs = 0;
+			for (long k = 0; k != inputs; ++k) {
+				finite = finite && std::isfinite(input_row[k]);
+				max_abs = std::max(max_abs, std::abs(input_row[k]));
+			}
+			// a row with a NaN or an infinity is quantized to zeros and its
+			// outputs are made NaN by the scale
+			input_scales[r] = finite ? max_abs / INT16_MAX_VALUE : NAN;
+			input_inverse_scales[r] = finite && max_abs > 0 ? INT16_MAX_VALUE / max_abs : 0.;
+		}
+
+		for (long first_column = 0; first_column < outputs; first_column += COLUMN_BLOCK) {
+			const long block_columns = std::min(COLUMN_BLOCK, outputs - first_column);
+
+			for (long r = 0; r != block_rows; ++r) {
+				for (long c = 0; c != block_columns; ++c) {
+					tile[r][c] = 0;
+				}
+			}
+
+			for (long first_input = 0; first_input < inputs; first_input += INPUT_BLOCK) {
+				const long block_inputs = std::min(INPUT_BLOCK, inputs - first_input);
+
+				for (long r = 0; r != block_rows; ++r) {
+					const double* input_row = input + (first_row + r) * inputs + first_input;
+					const double inverse_scale = input_inverse_scales[r];
+					for (long k = 0; k != block_inputs; ++k) {
+						quantized_input[r][k] = inverse_scale != 0
+								? static_cast<std::int16_t>(std::lrint(input_row[k] * inverse_scale)) : 0;
+					}
+					for (long c = 0; c != block_columns; ++c) {
+						products[r][c] = 0;
+					}
+				}
+
+				for (long k = 0; k != block_inputs; ++k) {
+					const signed char* weights_row = quantized_weights + (first_input + k) * outputs + first_column;
+					for (long r = 0; r != block_rows; ++r) {
+						const std::int32_t x = quantized_input[r][k];
+						for (long c = 0; c != block_columns; ++c) {
+							products[r][c] += x * weights_row[c];
+						}
+					}
+				}
+
+				for (long r = 0; r != block_rows; ++r) {
+					for (long c = 0; c != block_columns; ++c) {
+						tile[r][c] += products[r][c];
+					}
+				}
+			}
+
+			// both scales are applied once per output
+			for (long r = 0; r != block_rows; ++r) {
+				for (long c = 0; c != block_columns; ++c) {
+					tile[r][c] = bias[first_column + c] + input_scales[r] * scales[first_column + c] * tile[r][c];
+				}
+			}
+
+			store_tile(tile, block_rows, block_columns, activation,
+					   output + first_row * outputs + first_column, outputs);
+		}
+
+		if (activation == MlpActivation::SOFTMAX) {
+			mlp_softmax_rows(output + first_row * outputs, block_rows, outputs);
+		}
+	}
+}
+
+void mlp_quantize_weights(const double* weights, long inputs, long outputs,
+						  signed char* quantized_weights, double* scales) {
+	const double INT8_MAX_VALUE = 127;
+
+	for (long j = 0; j != outputs; ++j) {
+		double max_abs = 0;
+		for (long k = 0; k != inputs; ++k) {
+			max_abs = std::max(max_abs, std::abs(weights[k * outputs + j]));
+		}
+		scales[j] = max_abs > 0 ? max_abs / INT8_MAX_VALUE : 1.;
+	}
+
+	for (long k = 0; k != inputs; ++k) {
+		for (long j = 0; j != outputs; ++j) {
+			double q = std::round(weights[k * outputs + j] / scales[j]);
+			q = std::min(INT8_MAX_VALUE, std::max(-INT8_MAX_VALUE, q));
+			quantized_weights[k * outputs + j] = static_cast<signed char>(q);
+		}
+	}
+}
@@ -0,0 +1,72 @@
+/*
+ * MlpKernels.h
+ *
+ * Low level computational kernels used by the MultilayerPerceptron.
+ * They work on raw, row-major buffers (e.g. the storage of dlib matrices),
+ * without the temporaries of the dlib expressions.
+ */
+
+#ifndef SRC_SLEEP_STAGING_MLPKERNELS_H_
+#define SRC_SLEEP_STAGING_MLPKERNELS_H_
+
+/**
+ * The activation applied to the output of a layer.
+ * SOFTMAX normalizes every output row into probabilities.
+ */
+enum class MlpActivation {
+	IDENTITY,
+	RELU,
+	SOFTMAX
+};
+
+/**
+ * Computes a fully connected layer for a batch of observations:
+ * output = activation(input * weights + bias)
+ *
+ * The product is computed in blocks of rows and output columns, the bias
+ * and the activation are applied to each block while it's still in
+ * the registers/cache, i.e. no intermediate matrix is ever written.
+ *
+ * @param input : rows x inputs, row-major
+ * @param weights : inputs x outputs, row-major
+ * @param bias : outputs
+ * @param output : rows x outputs, row-major, must not alias the input
+ */
+void mlp_dense_layer(const double* input, long rows, long inputs,
+					 const double* weights, const double* bias, long outputs,
+					 MlpActivation activation, double* output);
+
+/**
+ * Same as mlp_dense_layer, but with the weights quantized per output channel:
+ * weight(k, j) ~= quantized_weights(k, j) * scales(j), see mlp_quantize_weights.
+ *
+ * Every input row is quantized to int16 with its own scale, the products with
+ * the int8 weights are accumulated in int32 and both scales and the bias are
+ * applied once per output. The outputs of the rows with a NaN or an infinity
+ * are NaN.
+ *
+ * @param quantized_weights : inputs x outputs, row-major
+ * @param scales : outputs
+ */
+void mlp_dense_layer_int8(const double* input, long rows, long inputs,
+						  const signed char* quantized_weights, const double* scales,
+						  const double* bias, long outputs,
+						  MlpActivation activation, double* output);
+
+/**
+ * Symmetric per-channel int8 quantization of a row-major inputs x outputs
+ * weight matrix: every output column j is scaled by scales(j) = max|w(., j)| / 127
+ * and rounded to the nearest integer in [-127, 127].
+ *
+ * @param quantized_weights : inputs x outputs, row-major, output
+ * @param scales : outputs, output
+ */
+void mlp_quantize_weights(const double* weights, long inputs, long outputs,
+						  signed char* quantized_weights, double* scales);
+
+/**
+ * Replaces every row of the row-major 'data' by its softmax.
+ */
+void mlp_softmax_rows(double* data, long rows, long cols);
+
+#endif /* SRC_SLEEP_STAGING_MLPKERNELS_H_ */
@@ -0,0 +1,128 @@
+/*
+ * ModelRegistry.cpp
+ */
+
+#include "ModelRegistry.h"
+#include <fstream>
+#include "ModelOnline.h"
+#include "ModelOnlineW1.h"
+#include "ModelOnlineW2.h"
+#include "OnlineStagingClassifier.h"
+#include "OnlineStagingFeaturePreprocessor.h"
+#include "StagingPreprocessor.h"
+#include "dlib_utils.h"
+#include "logger.h"
+
+const double ModelRegistry::ONLINE_FEATURE_CONFIG[StagingModel::FEATURE_CONFIG_SIZE] = {
+	OnlineStagingFeaturePreprocessor::NUMBER_OF_FEATURES,
+	OnlineStagingFeaturePreprocessor::ROLLING_WINDOW_SIZE,
+	OnlineStagingClassifier::FULL_EEG_WINDOW,
+	OnlineStagingClassifier::FULL_IR_WINDOW
+};
+
+const double ModelRegistry::OFFLINE_FEATURE_CONFIG[StagingModel::FEATURE_CONFIG_SIZE] = {
+	StagingPreprocessor::NUMBER_OF_FEATURES,
+	StagingPreprocessor::ROLLING_MEAN_WINDOW,
+	StagingPreprocessor::EEG_FFT_WINDOW,
+	StagingPreprocessor::IR_FFT_WINDOW
+};
+
+namespace {
+
+// the offline StagingPreprocessor isn't configurable, so the model
+// has to be trained with its features
+void check_offline_feature_config(const StagingModel &model, const std::string &source) {
+	if (!model.has("feature_config")) {
+		LOG(WARNING) << "the offline model from " << source
+					 << " has no feature_config, its features aren't checked";
+		return;
+	}
+	model.check_feature_config(ModelRegistry::OFFLINE_FEATURE_CONFIG);
+}
+
+}
+
+ModelRegistry& ModelRegistry::instance() {
+	static ModelRegistry registry;
+	return registry;
+}
+
+template <typename F>
+std::shared_ptr<const StagingModel> ModelRegistry::get_or_create(const std::string &key, F create) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto found = m_models.find(key);
+	if (found != m_models.end()) {
+		return found->second;
+	}
+
+	std::shared_ptr<const StagingModel> model = create();
+	m_models[key] = model;
+	return model;
+}
+
+std::shared_ptr<const StagingModel> ModelRegistry::get(const std::string &filename) {
+	return get_or_create("file:" + filename, [&filename]() {
+		return StagingModel::load(filename);
+	});
+}
+
+std::shared_ptr<const StagingModel> ModelRegistry::online_model() {
+	return get_or_create("builtin:online", []() {
+		return builtin_online_model().build();
+	});
+}
+
+std::shared_ptr<const StagingModel> ModelRegistry::offline_model() {
+	const std::string directory(MODEL_RES_DIRECTORY);
+	const std::string binary_filename = directory + "/offline_model.bin";
+	if (std::ifstream(binary_filename).good()) {
+		std::shared_ptr<const StagingModel> model = get(binary_filename);
+		check_offline_feature_config(*model, binary_filename);
+		return model;
+	}
+
+	std::shared_ptr<const StagingModel> model = get_or_create("csv:" + directory, [&directory]() {
+		return csv_offline_model(directory).build();
+	});
+	check_offline_feature_config(*model, directory);
+	return model;
+}
+
+void ModelRegistry::clear() {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_models.clear();
+}
+
+StagingModelBuilder ModelRegistry::builtin_online_model() {
+	using namespace online_model;
+
+	// the model is compiled with the preprocessor, so only the number of its
+	// features is really checked, against the input layer
+	StagingModelBuilder builder;
+	builder.add("w1", W1, W1_ROWS, W1_COLS)
+		   .add("i1", I1, I1_ROWS, I1_COLS)
+		   .add("w2", W2, W2_ROWS, W2_COLS)
+		   .add("i2", I2, I2_ROWS, I2_COLS)
+		   .add("transitions", Transitions, Transitions_ROWS, Transitions_COLS)
+		   .add("classes", Classes, Classes_ROWS, Classes_COLS)
+		   .add("feature_config", ONLINE_FEATURE_CONFIG, 1, StagingModel::FEATURE_CONFIG_SIZE);
+	return builder;
+}
+
+StagingModelBuilder ModelRegistry::csv_offline_model(const std::string &directory) {
+	StagingModelBuilder builder;
+	builder.add_csv_layers(directory);
+
+	// the configuration of the features the model was trained with
+	const std::string feature_config_filename = directory + "/feature_config.csv";
+	if (std::ifstream(feature_config_filename).good()) {
+		builder.add("feature_config", load_matrix(feature_config_filename));
+	}
+
+	// optional, used for smoothing the staging
+	const std::string transitions_filename = directory + "/transitions.csv";
+	if (std::ifstream(transitions_filename).good()) {
+		builder.add("transitions", load_matrix(transitions_filename));
+	}
+	return builder;
+}
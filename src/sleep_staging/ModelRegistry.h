@@ -0,0 +1,72 @@
+/*
+ * ModelRegistry.h
+ */
+
+#ifndef SRC_SLEEP_STAGING_MODELREGISTRY_H_
+#define SRC_SLEEP_STAGING_MODELREGISTRY_H_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "StagingModel.h"
+#include "StagingModelBuilder.h"
+
+/**
+ * Loads every staging model once and shares it read-only between all
+ * the classifiers, sessions and threads. The models are immutable, so
+ * no synchronization is needed after they're obtained.
+ */
+class ModelRegistry {
+	std::mutex m_mutex;
+	std::map<std::string, std::shared_ptr<const StagingModel>> m_models;
+
+	ModelRegistry() {}
+
+	template <typename F>
+	std::shared_ptr<const StagingModel> get_or_create(const std::string &key, F create);
+
+public:
+	static ModelRegistry& instance();
+
+	/**
+	 * @return the model from a binary model file, memory mapped on the first use
+	 */
+	std::shared_ptr<const StagingModel> get(const std::string &filename);
+
+	/**
+	 * @return the online staging model compiled into the library
+	 */
+	std::shared_ptr<const StagingModel> online_model();
+
+	/**
+	 * @return the offline staging model, from MODEL_RES_DIRECTORY/offline_model.bin
+	 * if it exists, otherwise converted from the CSV files in MODEL_RES_DIRECTORY.
+	 * Throws std::logic_error if the model was trained with different features,
+	 * a model without the feature_config is used with a warning.
+	 */
+	std::shared_ptr<const StagingModel> offline_model();
+
+	/**
+	 * Forgets all the models, they're released when the last user drops them
+	 */
+	void clear();
+
+	/**
+	 * The configurations of the features computed for the models, by the
+	 * OnlineStagingFeaturePreprocessor and the StagingPreprocessor,
+	 * see StagingModel::FeatureConfig
+	 */
+	static const double ONLINE_FEATURE_CONFIG[StagingModel::FEATURE_CONFIG_SIZE];
+	static const double OFFLINE_FEATURE_CONFIG[StagingModel::FEATURE_CONFIG_SIZE];
+
+	/**
+	 * The sources of the models, used also by the model_converter tool.
+	 * The CSV model has the feature_config section only if the directory
+	 * has a feature_config.csv file, saved with the model when it was trained.
+	 */
+	static StagingModelBuilder builtin_online_model();
+	static StagingModelBuilder csv_offline_model(const std::string &directory);
+};
+
+#endif /* SRC_SLEEP_STAGING_MODELREGISTRY_H_ */
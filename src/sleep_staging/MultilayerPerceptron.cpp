@@ -7,85 +7,276 @@
 
 #include "MultilayerPerceptron.h"
 #include <sstream>
+#include <stdexcept>
+#include "MlpFixedShape.h"
+#include "PerformanceCounters.h"
+
+namespace {
+
+struct FixedShape {
+	bool (*matches)(const long* sizes, size_t layers);
+	void (*forward)(const double* input, long rows,
+					const double* const* weights, const double* const* biases,
+					const MlpActivation* activations, double* scratch, double* output);
+	long scratch;
+};
+
+#define MLP_FIXED_SHAPE(...) \
+	{&MlpFixedShape<__VA_ARGS__>::matches, &MlpFixedShape<__VA_ARGS__>::forward, MlpFixedShape<__VA_ARGS__>::SCRATCH}
+
+// the shapes of the online and the offline staging models
+const FixedShape FIXED_SHAPES[] = {
+	MLP_FIXED_SHAPE(22, 100, 4),
+	MLP_FIXED_SHAPE(7, 100, 5)
+};
+
+#undef MLP_FIXED_SHAPE
+
+}
 
 MultilayerPerceptron::MultilayerPerceptron(std::vector<dlib::matrix<double>> weights, std::vector<dlib::matrix<double>> intercepts)
 : m_weights(weights)
-,  m_intercepts(intercepts)
+, m_intercepts(intercepts)
 {
-	// Currently only two hidden layers are supported but this can be
-    // easily changed.
-    // The activation functions can also be made more 'configurable' easily.
-    // For now, they're hardcoded here: 
-	m_activations.push_back(new RectifiedLinearActivationFunction());
-	m_activations.push_back(new LinearActivationFunction());
+	set_layers_from_matrices();
+	set_default_activations(m_layers.size());
+	check_matrices_dimensions();
+	select_fixed_shape();
+}
 
+MultilayerPerceptron::MultilayerPerceptron(std::vector<dlib::matrix<signed char>> quantized_weights,
+										   std::vector<dlib::matrix<double>> scales,
+										   std::vector<dlib::matrix<double>> intercepts)
+: m_intercepts(intercepts)
+, m_quantized_weights(quantized_weights)
+, m_scales(scales)
+{
+	if (m_quantized_weights.size() != m_scales.size()) {
+		throw std::logic_error("quantized weights and scales vector sizes don't agree");
+	}
+
+	for (size_t i = 0; i != m_quantized_weights.size(); ++i) {
+		if (m_scales[i].size() != m_quantized_weights[i].nc()) {
+			throw std::logic_error("the number of scales doesn't agree with the number of layer outputs");
+		}
+	}
+
+	set_layers_from_matrices();
+	set_default_activations(m_layers.size());
 	check_matrices_dimensions();
+	select_fixed_shape();
 }
 
-bool MultilayerPerceptron::check_matrices_dimensions() {
-	if (m_weights.size() != m_intercepts.size()) {
-		throw std::logic_error("weights and intercepts vector sizes don't agree ");
+MultilayerPerceptron::MultilayerPerceptron(std::shared_ptr<const StagingModel> model)
+: m_model(model)
+{
+
+	for (int i = 1; i <= model->layers(); ++i) {
+		const StagingModel::Array& weights = model->get("w" + std::to_string(i));
+		const StagingModel::Array& intercepts = model->get("i" + std::to_string(i));
+
+		Layer layer;
+		layer.weights = weights.doubles();
+		layer.quantized_weights = nullptr;
+		layer.scales = nullptr;
+		layer.intercepts = intercepts.doubles();
+		layer.inputs = weights.rows;
+		layer.outputs = weights.cols;
+		m_layers.push_back(layer);
+	}
+
+	set_default_activations(m_layers.size());
+	check_matrices_dimensions();
+	select_fixed_shape();
+}
+
+void MultilayerPerceptron::set_default_activations(size_t layers) {
+	m_activations.assign(layers, MlpActivation::RELU);
+	if (layers > 0) {
+		m_activations.back() = MlpActivation::IDENTITY;
 	}
+}
 
-	if (m_weights.size() != m_activations.size()) {
+void MultilayerPerceptron::set_activations(const std::vector<MlpActivation>& activations) {
+	if (activations.size() != m_layers.size()) {
 		throw std::logic_error("weights and activations vector sizes don't agree");
 	}
+	m_activations = activations;
+}
 
-	for (size_t i = 0; i != m_weights.size() -1; ++i) {
-		if (m_weights[i].nc() != m_weights[i+1].nr()) {
-			std::stringstream ss;
-			ss << "The dimensions of the matrices in layers: " << i << " and " << i + 1 << " don't agree: " << std::endl
-			   << "w1: " << m_weights[i].nr() << "x" << m_weights[i].nc() << std::endl
-			   << "w2: " << m_weights[i+1].nr() << "x" << m_weights[i+1].nc() << std::endl;
-			throw std::logic_error(ss.str());
+void MultilayerPerceptron::select_fixed_shape() {
+	m_fixed_forward = nullptr;
+	m_fixed_scratch = 0;
+	m_fixed_weights.clear();
+	m_fixed_biases.clear();
+	m_fixed_scratch_buffer.clear();
+
+	// the specialized code works only with the double weights
+	if (is_quantized()) {
+		return;
+	}
+
+	std::vector<long> sizes(1, m_layers[0].inputs);
+	for (const Layer& layer : m_layers) {
+		sizes.push_back(layer.outputs);
+		m_fixed_weights.push_back(layer.weights);
+		m_fixed_biases.push_back(layer.intercepts);
+	}
+
+	for (const FixedShape& shape : FIXED_SHAPES) {
+		if (shape.matches(sizes.data(), m_layers.size())) {
+			m_fixed_forward = shape.forward;
+			m_fixed_scratch = shape.scratch;
+			return;
 		}
 	}
+}
 
-	return true;
+bool MultilayerPerceptron::is_specialized() const {
+	return m_fixed_forward != nullptr;
 }
 
-MultilayerPerceptron::~MultilayerPerceptron() {
-	for (auto a : m_activations) {
-		delete a;
+size_t MultilayerPerceptron::layers() const {
+	return m_layers.size();
+}
+
+void MultilayerPerceptron::set_layers_from_matrices() {
+	// a quantized network keeps only the int8 weights
+	size_t layers = is_quantized() ? m_quantized_weights.size() : m_weights.size();
+	if (layers != m_intercepts.size()) {
+		throw std::logic_error("weights and intercepts vector sizes don't agree ");
+	}
+
+	m_layers.clear();
+	for (size_t i = 0; i != layers; ++i) {
+		Layer layer;
+		if (is_quantized()) {
+			layer.weights = nullptr;
+			layer.quantized_weights = m_quantized_weights[i].begin();
+			layer.scales = m_scales[i].begin();
+			layer.inputs = m_quantized_weights[i].nr();
+			layer.outputs = m_quantized_weights[i].nc();
+		} else {
+			layer.weights = m_weights[i].begin();
+			layer.quantized_weights = nullptr;
+			layer.scales = nullptr;
+			layer.inputs = m_weights[i].nr();
+			layer.outputs = m_weights[i].nc();
+		}
+		layer.intercepts = m_intercepts[i].begin();
+		m_layers.push_back(layer);
 	}
 }
 
-dlib::matrix<double> MultilayerPerceptron::RectifiedLinearActivationFunction::operator()(const dlib::matrix<double> &input) const {
-	dlib::matrix<double> result;
-	result = input;
-	for (int i = 0; i != result.nr(); ++i) {
-		for (int j = 0; j != result.nc(); ++j) {
-			if (result(i,j) < 0) {
-				result(i,j) = 0;
-			}
+void MultilayerPerceptron::quantize() {
+	if (is_quantized()) {
+		return;
+	}
+
+	for (Layer& layer : m_layers) {
+		dlib::matrix<signed char> quantized(layer.inputs, layer.outputs);
+		dlib::matrix<double> scales(layer.outputs, 1);
+		mlp_quantize_weights(layer.weights, layer.inputs, layer.outputs, quantized.begin(), scales.begin());
+		m_quantized_weights.push_back(quantized);
+		m_scales.push_back(scales);
+	}
+	for (size_t i = 0; i != m_layers.size(); ++i) {
+		m_layers[i].weights = nullptr;
+		m_layers[i].quantized_weights = m_quantized_weights[i].begin();
+		m_layers[i].scales = m_scales[i].begin();
+	}
+
+	// the double weights aren't needed anymore; the ones of a StagingModel
+	// belong to the shared model, so they stay
+	std::vector<dlib::matrix<double>>().swap(m_weights);
+	select_fixed_shape();
+}
+
+bool MultilayerPerceptron::is_quantized() const {
+	return !m_quantized_weights.empty();
+}
+
+bool MultilayerPerceptron::check_matrices_dimensions() {
+	if (m_layers.empty()) {
+		throw std::logic_error("the network has no layers");
+	}
+
+	if (m_layers.size() != m_activations.size()) {
+		throw std::logic_error("weights and activations vector sizes don't agree");
+	}
+
+	for (size_t i = 0; i + 1 < m_layers.size(); ++i) {
+		if (m_layers[i].outputs != m_layers[i+1].inputs) {
+			std::stringstream ss;
+			ss << "The dimensions of the matrices in layers: " << i << " and " << i + 1 << " don't agree: " << std::endl
+			   << "w1: " << m_layers[i].inputs << "x" << m_layers[i].outputs << std::endl
+			   << "w2: " << m_layers[i+1].inputs << "x" << m_layers[i+1].outputs << std::endl;
+			throw std::logic_error(ss.str());
 		}
 	}
-	return result;
+
+	return true;
 }
 
-dlib::matrix<double> MultilayerPerceptron::LinearActivationFunction::operator()(const dlib::matrix<double> &input) const {
-	dlib::matrix<double> result = input;
-	return result;
+MultilayerPerceptron::~MultilayerPerceptron() {
 }
 
-dlib::matrix<double> MultilayerPerceptron::predict(const dlib::matrix<double>& input) {
+dlib::matrix<double> MultilayerPerceptron::forward(const dlib::matrix<double>& input, MlpActivation output_activation) {
+	ScopedPerformanceTimer timer(NC_PERF_MLP);
 
-	if(input.nc() != m_weights[0].nr()) {
+	if(input.nc() != m_layers[0].inputs) {
 		std::stringstream ss;
-		ss << "This network has " << m_weights[0].nr() << " input neurons";
+		ss << "This network has " << m_layers[0].inputs << " input neurons";
 		throw std::logic_error(ss.str());
 	}
 
-	dlib::matrix<double> current_layer_output = input;
-	for (int i = 0; i != m_weights.size(); ++i) {
-		current_layer_output = current_layer_output * m_weights[i];
+	if (m_fixed_forward) {
+		m_fixed_activations.assign(m_activations.begin(), m_activations.end());
+		m_fixed_activations.back() = output_activation;
 
-		for (int j = 0; j != current_layer_output.nr(); ++j) {
-			dlib::set_rowm(current_layer_output, j) = dlib::rowm(current_layer_output, j) + dlib::trans(m_intercepts[i]);
+		size_t scratch_size = static_cast<size_t>(input.nr() * m_fixed_scratch);
+		if (m_fixed_scratch_buffer.size() < scratch_size) {
+			m_fixed_scratch_buffer.resize(scratch_size);
 		}
 
-		current_layer_output = m_activations[i]->operator()(current_layer_output);
+		dlib::matrix<double> output(input.nr(), m_layers.back().outputs);
+		m_fixed_forward(input.begin(), input.nr(), m_fixed_weights.data(), m_fixed_biases.data(),
+						m_fixed_activations.data(), m_fixed_scratch_buffer.data(), output.begin());
+		return output;
 	}
 
-	return current_layer_output;
+	// the layers write alternately to two buffers, the input of the network
+	// is read directly
+	dlib::matrix<double> buffers[2];
+	const dlib::matrix<double>* layer_input = &input;
+	for (size_t i = 0; i != m_layers.size(); ++i) {
+		const Layer& layer = m_layers[i];
+		MlpActivation activation = (i + 1 == m_layers.size()) ? output_activation : m_activations[i];
+
+		dlib::matrix<double>& layer_output = buffers[i % 2];
+		layer_output.set_size(layer_input->nr(), layer.outputs);
+		if (layer.quantized_weights) {
+			mlp_dense_layer_int8(layer_input->begin(), layer_input->nr(), layer.inputs,
+								 layer.quantized_weights, layer.scales, layer.intercepts, layer.outputs,
+								 activation, layer_output.begin());
+		} else {
+			mlp_dense_layer(layer_input->begin(), layer_input->nr(), layer.inputs,
+							layer.weights, layer.intercepts, layer.outputs,
+							activation, layer_output.begin());
+		}
+		layer_input = &layer_output;
+	}
+
+	return *layer_input;
+}
+
+dlib::matrix<double> MultilayerPerceptron::predict(const dlib::matrix<double>& input) {
+	return forward(input, m_activations.back());
+}
+
+dlib::matrix<double> MultilayerPerceptron::predict_proba(const dlib::matrix<double>& input) {
+	if (m_activations.back() != MlpActivation::IDENTITY) {
+		throw std::logic_error("predict_proba requires a linear output layer");
+	}
+	return forward(input, MlpActivation::SOFTMAX);
 }
@@ -10,6 +10,9 @@
 
 #include <vector>
 #include <dlib/matrix.h>
+#include <memory>
+#include "MlpKernels.h"
+#include "StagingModel.h"
 
 
 /**
@@ -17,33 +20,114 @@
  * artificial neural network.
  * 
  * MLP can be used as a 'backend' for classification and regression tasks
+ *
+ * The network can have any number of layers. By default every layer but
+ * the last one uses RELU and the last one is linear, see set_activations.
+ * When the layer sizes match one of the shapes compiled in with MlpFixedShape
+ * (e.g. the online staging model) the forward pass uses the specialized code.
+ *
+ * After calling quantize() (or when constructed from quantized weights)
+ * the network computes with int8 weights with per-output-channel scales,
+ * see mlp_quantize_weights and mlp_dense_layer_int8, and keeps no double
+ * weights. The intercepts and the activations stay in double precision.
+ * The weights take an eighth of the memory, but the forward pass isn't
+ * faster, for the online model it takes about 1.5 times as long as the
+ * specialized double one.
  */
 class MultilayerPerceptron {
 
-	struct ActivationFunction {
-		virtual dlib::matrix<double> operator()(const dlib::matrix<double> &input) const = 0;
-		virtual ~ActivationFunction() {}
-	};
-
-	struct RectifiedLinearActivationFunction : public ActivationFunction {
-		virtual dlib::matrix<double> operator()(const dlib::matrix<double> &input) const override ;
+	/**
+	 * A view of the parameters of a layer, they're stored either in the
+	 * matrices below or in a shared StagingModel. The weights of a quantized
+	 * layer are nullptr.
+	 */
+	struct Layer {
+		const double* weights;
+		const signed char* quantized_weights;
+		const double* scales;
+		const double* intercepts;
+		long inputs;
+		long outputs;
 	};
 
-	struct LinearActivationFunction : public ActivationFunction {
-		virtual dlib::matrix<double> operator()(const dlib::matrix<double> &input) const override;
-	};
+	std::vector<Layer> m_layers;
+	std::vector<MlpActivation> m_activations;
 
 	std::vector<dlib::matrix<double>> m_weights;
 	std::vector<dlib::matrix<double>> m_intercepts;
-	std::vector<ActivationFunction*> m_activations;
 
+	// empty unless the network is quantized
+	std::vector<dlib::matrix<signed char>> m_quantized_weights;
+	std::vector<dlib::matrix<double>> m_scales;
+
+	std::shared_ptr<const StagingModel> m_model;
+
+	// the forward pass specialized for the shape of the network, if there's one
+	typedef void (*FixedForward)(const double* input, long rows,
+								 const double* const* weights, const double* const* biases,
+								 const MlpActivation* activations, double* scratch, double* output);
+	FixedForward m_fixed_forward;
+	long m_fixed_scratch;
+	std::vector<const double*> m_fixed_weights;
+	std::vector<const double*> m_fixed_biases;
+
+	// reused by the specialized forward pass, the scratch only grows
+	std::vector<MlpActivation> m_fixed_activations;
+	std::vector<double> m_fixed_scratch_buffer;
+
+	void set_default_activations(size_t layers);
+	void set_layers_from_matrices();
+	void select_fixed_shape();
 	bool check_matrices_dimensions();
+	dlib::matrix<double> forward(const dlib::matrix<double>& input, MlpActivation output_activation);
 
 public:
 
 	MultilayerPerceptron(std::vector<dlib::matrix<double>> weights, std::vector<dlib::matrix<double>> intercepts);
+
+	/**
+	 * Creates a quantized network.
+	 * @param quantized_weights : int8 weights of the layers
+	 * @param scales : column matrices with the scale of every output of the layers
+	 * @param intercepts : the intercepts of the layers, in double precision
+	 */
+	MultilayerPerceptron(std::vector<dlib::matrix<signed char>> quantized_weights,
+						 std::vector<dlib::matrix<double>> scales,
+						 std::vector<dlib::matrix<double>> intercepts);
+
+	/**
+	 * Creates a network using the layers of the model (w<n> and i<n>) in place,
+	 * without copying them
+	 */
+	MultilayerPerceptron(std::shared_ptr<const StagingModel> model);
+
 	virtual ~MultilayerPerceptron();
 
+	// the layers point to the parameters owned by the object
+	MultilayerPerceptron(const MultilayerPerceptron&) = delete;
+	MultilayerPerceptron& operator=(const MultilayerPerceptron&) = delete;
+
+	/**
+	 * Switches the network to the int8 weights, quantized from the current ones,
+	 * and releases the double weights. Does nothing if the network is already quantized.
+	 */
+	void quantize();
+
+	bool is_quantized() const;
+
+	size_t layers() const;
+
+	/**
+	 * Sets the activations of the consecutive layers, there has to be
+	 * one for each layer
+	 */
+	void set_activations(const std::vector<MlpActivation>& activations);
+
+	/**
+	 * True if the forward pass uses the code specialized for the shape of the network
+	 */
+	bool is_specialized() const;
+
     /**
      * Return the outputs of the MLP for given inputs
      * @param input : the values of inputs for the network
@@ -53,6 +137,13 @@ public:
      */
 	dlib::matrix<double> predict(const dlib::matrix<double>& input);
 
+    /**
+     * Same as predict, but with the softmax applied to the outputs
+     * of the last layer, fused into its computation.
+     * @return a dlib matrix, each row containing the probabilities of the outputs
+     */
+	dlib::matrix<double> predict_proba(const dlib::matrix<double>& input);
+
 };
 
 #endif /* SRC_SLEEP_STAGING_MULTILAYERPERCEPTRON_H_ */
@@ -0,0 +1,208 @@
+/*
+ * StagingModel.cpp
+ */
+
+#include "StagingModel.h"
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const char StagingModel::MAGIC[8] = {'N', 'C', 'M', 'O', 'D', 'E', 'L', '\0'};
+
+namespace {
+
+const std::size_t HEADER_SIZE = 16;
+const std::size_t SECTION_SIZE = 40;
+const std::size_t NAME_SIZE = 16;
+
+template <typename T>
+T read_value(const char* data) {
+	T value;
+	std::memcpy(&value, data, sizeof(T));
+	return value;
+}
+
+}
+
+const double* StagingModel::Array::doubles() const {
+	if (type != ArrayType::DOUBLE) {
+		throw std::logic_error("StagingModel: the array doesn't contain doubles");
+	}
+	return static_cast<const double*>(data);
+}
+
+const std::int32_t* StagingModel::Array::ints() const {
+	if (type != ArrayType::INT32) {
+		throw std::logic_error("StagingModel: the array doesn't contain ints");
+	}
+	return static_cast<const std::int32_t*>(data);
+}
+
+StagingModel::StagingModel()
+: m_data(nullptr)
+, m_size(0)
+, m_mapped(false)
+{}
+
+StagingModel::~StagingModel() {
+	if (m_mapped) {
+		munmap(const_cast<char*>(m_data), m_size);
+	}
+}
+
+std::shared_ptr<const StagingModel> StagingModel::load(const std::string &filename) {
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0) {
+		throw std::runtime_error("StagingModel: could not open " + filename);
+	}
+
+	struct stat file_stat;
+	if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+		close(fd);
+		throw std::runtime_error("StagingModel: could not read " + filename);
+	}
+
+	void* mapped = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (mapped == MAP_FAILED) {
+		throw std::runtime_error("StagingModel: could not map " + filename);
+	}
+
+	std::shared_ptr<StagingModel> model(new StagingModel());
+	model->m_data = static_cast<const char*>(mapped);
+	model->m_size = file_stat.st_size;
+	model->m_mapped = true;
+	model->parse();
+	return model;
+}
+
+std::shared_ptr<const StagingModel> StagingModel::from_buffer(std::vector<char> buffer) {
+	std::shared_ptr<StagingModel> model(new StagingModel());
+	model->m_buffer.swap(buffer);
+	model->m_data = model->m_buffer.data();
+	model->m_size = model->m_buffer.size();
+	model->parse();
+	return model;
+}
+
+void StagingModel::parse() {
+	if (m_size < HEADER_SIZE || std::memcmp(m_data, MAGIC, sizeof(MAGIC)) != 0) {
+		throw std::logic_error("StagingModel: not a model file");
+	}
+
+	std::uint32_t version = read_value<std::uint32_t>(m_data + 8);
+	if (version != VERSION) {
+		std::stringstream s;
+		s << "StagingModel: unsupported version " << version << ", expected " << VERSION;
+		throw std::logic_error(s.str());
+	}
+
+	std::uint32_t sections = read_value<std::uint32_t>(m_data + 12);
+	if (HEADER_SIZE + sections * SECTION_SIZE > m_size) {
+		throw std::logic_error("StagingModel: truncated section table");
+	}
+
+	for (std::uint32_t i = 0; i != sections; ++i) {
+		const char* section = m_data + HEADER_SIZE + i * SECTION_SIZE;
+
+		std::string name(section, strnlen(section, NAME_SIZE));
+		std::uint32_t type = read_value<std::uint32_t>(section + 16);
+		std::uint32_t rows = read_value<std::uint32_t>(section + 20);
+		std::uint32_t cols = read_value<std::uint32_t>(section + 24);
+		std::uint64_t offset = read_value<std::uint64_t>(section + 32);
+
+		if (type != static_cast<std::uint32_t>(ArrayType::DOUBLE) && type != static_cast<std::uint32_t>(ArrayType::INT32)) {
+			throw std::logic_error("StagingModel: unknown type of section " + name);
+		}
+		std::size_t element_size = type == static_cast<std::uint32_t>(ArrayType::DOUBLE) ? sizeof(double) : sizeof(std::int32_t);
+		if (offset % element_size != 0 || offset + std::uint64_t(rows) * cols * element_size > m_size) {
+			throw std::logic_error("StagingModel: invalid data of section " + name);
+		}
+
+		Array array;
+		array.type = static_cast<ArrayType>(type);
+		array.rows = rows;
+		array.cols = cols;
+		array.data = m_data + offset;
+		m_names.push_back(name);
+		m_arrays.push_back(array);
+	}
+
+	for (int layer = 1; layer <= layers(); ++layer) {
+		const Array& weights = get("w" + std::to_string(layer));
+		const Array& intercepts = get("i" + std::to_string(layer));
+		if (intercepts.rows * intercepts.cols != weights.cols) {
+			throw std::logic_error("StagingModel: the intercepts don't agree with the weights in layer " + std::to_string(layer));
+		}
+	}
+	if (has("feature_config") && layers() > 0
+		&& get("w1").rows != static_cast<long>(feature_config(FEATURE_CONFIG_NUMBER_OF_FEATURES))) {
+		throw std::logic_error("StagingModel: the number of features doesn't agree with the input layer");
+	}
+}
+
+bool StagingModel::has(const std::string &name) const {
+	for (const std::string& n : m_names) {
+		if (n == name) {
+			return true;
+		}
+	}
+	return false;
+}
+
+const StagingModel::Array& StagingModel::get(const std::string &name) const {
+	for (std::size_t i = 0; i != m_names.size(); ++i) {
+		if (m_names[i] == name) {
+			return m_arrays[i];
+		}
+	}
+	throw std::logic_error("StagingModel: no section named " + name);
+}
+
+dlib::matrix<double> StagingModel::matrix(const std::string &name) const {
+	const Array& array = get(name);
+	dlib::matrix<double> result(array.rows, array.cols);
+	for (long i = 0; i != array.rows * array.cols; ++i) {
+		result(i / array.cols, i % array.cols) = array.type == ArrayType::DOUBLE
+				? array.doubles()[i] : array.ints()[i];
+	}
+	return result;
+}
+
+int StagingModel::layers() const {
+	int layers = 0;
+	while (has("w" + std::to_string(layers + 1))) {
+		++layers;
+	}
+	return layers;
+}
+
+void StagingModel::check_feature_config(const double (&expected)[FEATURE_CONFIG_SIZE]) const {
+	const char* NAMES[FEATURE_CONFIG_SIZE] = {"number of features", "rolling window", "EEG FFT window", "IR FFT window"};
+
+	if (!has("feature_config")) {
+		throw std::logic_error("StagingModel: the model has no feature_config");
+	}
+	for (int i = 0; i != FEATURE_CONFIG_SIZE; ++i) {
+		double value = feature_config(static_cast<FeatureConfig>(i));
+		if (value != expected[i]) {
+			std::stringstream s;
+			s << "StagingModel: the model was trained with the " << NAMES[i] << " " << value
+			  << ", but the features are computed with " << expected[i];
+			throw std::logic_error(s.str());
+		}
+	}
+}
+
+double StagingModel::feature_config(FeatureConfig index) const {
+	const Array& config = get("feature_config");
+	if (index >= config.rows * config.cols) {
+		throw std::logic_error("StagingModel: feature_config is too short");
+	}
+	return config.doubles()[index];
+}
@@ -0,0 +1,123 @@
+/*
+ * StagingModel.h
+ *
+ * A read-only staging model stored in the binary model format.
+ */
+
+#ifndef SRC_SLEEP_STAGING_STAGINGMODEL_H_
+#define SRC_SLEEP_STAGING_STAGINGMODEL_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <dlib/matrix.h>
+
+/**
+ * A staging model (MLP weights and intercepts, Viterbi transitions, classes
+ * and the feature configuration) in a versioned binary format, which is used
+ * in place, i.e. the arrays are read directly from the memory mapped file
+ * (or the buffer) without parsing or copying.
+ *
+ * The format (all the integers and doubles little-endian):
+ *   header:   char[8] magic "NCMODEL\0", uint32 version, uint32 number of sections
+ *   sections: char[16] name, uint32 type (0 - double, 1 - int32),
+ *             uint32 rows, uint32 cols, uint32 reserved, uint64 offset of the data
+ *   data:     every array row-major at its offset, aligned to 16 bytes
+ *
+ * Standard section names: w1, i1, w2, i2 (the MLP layers), transitions, classes
+ * and feature_config, see the FEATURE_CONFIG_* indices. The models are built
+ * by StagingModelBuilder and usually obtained from the ModelRegistry.
+ */
+class StagingModel {
+public:
+	static const std::uint32_t VERSION = 1;
+	static const char MAGIC[8];
+
+	enum class ArrayType : std::uint32_t {
+		DOUBLE = 0,
+		INT32 = 1
+	};
+
+	/**
+	 * The values stored in the feature_config section
+	 */
+	enum FeatureConfig {
+		FEATURE_CONFIG_NUMBER_OF_FEATURES = 0,
+		FEATURE_CONFIG_ROLLING_WINDOW = 1,
+		FEATURE_CONFIG_EEG_FFT_WINDOW = 2,
+		FEATURE_CONFIG_IR_FFT_WINDOW = 3,
+		FEATURE_CONFIG_SIZE = 4
+	};
+
+	/**
+	 * Describes an array stored in the model, 'data' points into the model
+	 * and is valid as long as the model exists.
+	 */
+	struct Array {
+		ArrayType type;
+		long rows;
+		long cols;
+		const void* data;
+
+		const double* doubles() const;
+		const std::int32_t* ints() const;
+	};
+
+	/**
+	 * Memory maps the model file, throws std::runtime_error if the file can't be read
+	 * and std::logic_error if it isn't a valid model
+	 */
+	static std::shared_ptr<const StagingModel> load(const std::string &filename);
+
+	/**
+	 * Uses the model serialized in 'buffer', the buffer is owned by the model
+	 */
+	static std::shared_ptr<const StagingModel> from_buffer(std::vector<char> buffer);
+
+	~StagingModel();
+
+	StagingModel(const StagingModel&) = delete;
+	StagingModel& operator=(const StagingModel&) = delete;
+
+	bool has(const std::string &name) const;
+
+	/**
+	 * Throws std::logic_error if there's no array with the given name
+	 */
+	const Array& get(const std::string &name) const;
+
+	/**
+	 * Copies an array to a dlib matrix, for the small arrays needed as matrices
+	 */
+	dlib::matrix<double> matrix(const std::string &name) const;
+
+	/**
+	 * @return the number of the layers of the MLP, i.e. of the w<n> sections
+	 */
+	int layers() const;
+
+	double feature_config(FeatureConfig index) const;
+
+	/**
+	 * Checks that the model was trained with the features computed as configured
+	 * in 'expected', i.e. by the preprocessor which is going to feed it, throws
+	 * std::logic_error if the feature_config section is missing or differs
+	 */
+	void check_feature_config(const double (&expected)[FEATURE_CONFIG_SIZE]) const;
+
+private:
+	StagingModel();
+	void parse();
+
+	// either a mapped file or an owned buffer
+	const char* m_data;
+	std::size_t m_size;
+	bool m_mapped;
+	std::vector<char> m_buffer;
+
+	std::vector<std::string> m_names;
+	std::vector<Array> m_arrays;
+};
+
+#endif /* SRC_SLEEP_STAGING_STAGINGMODEL_H_ */
@@ -0,0 +1,129 @@
+/*
+ * StagingModelBuilder.cpp
+ */
+
+#include "StagingModelBuilder.h"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include "dlib_utils.h"
+
+namespace {
+
+const std::size_t HEADER_SIZE = 16;
+const std::size_t SECTION_SIZE = 40;
+const std::size_t NAME_SIZE = 16;
+const std::size_t ALIGNMENT = 16;
+
+template <typename T>
+void write_value(std::vector<char> &buffer, std::size_t position, T value) {
+	std::memcpy(buffer.data() + position, &value, sizeof(T));
+}
+
+std::size_t aligned(std::size_t position) {
+	return (position + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+}
+
+void StagingModelBuilder::add_section(const std::string &name, StagingModel::ArrayType type, long rows, long cols,
+									  const void* data, std::size_t size) {
+	if (name.size() >= NAME_SIZE) {
+		throw std::logic_error("StagingModelBuilder: section name too long: " + name);
+	}
+
+	Section section;
+	section.name = name;
+	section.type = type;
+	section.rows = rows;
+	section.cols = cols;
+	section.data.resize(size);
+	std::memcpy(section.data.data(), data, size);
+	m_sections.push_back(section);
+}
+
+StagingModelBuilder& StagingModelBuilder::add(const std::string &name, const dlib::matrix<double> &values) {
+	std::vector<double> data(values.nr() * values.nc());
+	for (long i = 0; i != values.nr(); ++i) {
+		for (long j = 0; j != values.nc(); ++j) {
+			data[i * values.nc() + j] = values(i, j);
+		}
+	}
+	add_section(name, StagingModel::ArrayType::DOUBLE, values.nr(), values.nc(),
+				data.data(), data.size() * sizeof(double));
+	return *this;
+}
+
+StagingModelBuilder& StagingModelBuilder::add(const std::string &name, const dlib::matrix<int> &values) {
+	std::vector<std::int32_t> data(values.nr() * values.nc());
+	for (long i = 0; i != values.nr(); ++i) {
+		for (long j = 0; j != values.nc(); ++j) {
+			data[i * values.nc() + j] = values(i, j);
+		}
+	}
+	add_section(name, StagingModel::ArrayType::INT32, values.nr(), values.nc(),
+				data.data(), data.size() * sizeof(std::int32_t));
+	return *this;
+}
+
+StagingModelBuilder& StagingModelBuilder::add(const std::string &name, const double* values, long rows, long cols) {
+	add_section(name, StagingModel::ArrayType::DOUBLE, rows, cols, values, rows * cols * sizeof(double));
+	return *this;
+}
+
+StagingModelBuilder& StagingModelBuilder::add(const std::string &name, const int* values, long rows, long cols) {
+	std::vector<std::int32_t> data(values, values + rows * cols);
+	add_section(name, StagingModel::ArrayType::INT32, rows, cols, data.data(), data.size() * sizeof(std::int32_t));
+	return *this;
+}
+
+StagingModelBuilder& StagingModelBuilder::add_csv_layers(const std::string &directory) {
+	for (int layer = 1; ; ++layer) {
+		std::string weights_filename = directory + "/w" + std::to_string(layer) + ".csv";
+		if (!std::ifstream(weights_filename).good()) {
+			break;
+		}
+		add("w" + std::to_string(layer), load_matrix(weights_filename));
+		add("i" + std::to_string(layer), load_matrix(directory + "/i" + std::to_string(layer) + ".csv"));
+	}
+	return *this;
+}
+
+std::vector<char> StagingModelBuilder::serialize() const {
+	std::size_t size = aligned(HEADER_SIZE + m_sections.size() * SECTION_SIZE);
+	std::vector<std::size_t> offsets;
+	for (const Section& section : m_sections) {
+		offsets.push_back(size);
+		size = aligned(size + section.data.size());
+	}
+
+	std::vector<char> buffer(size, 0);
+	std::memcpy(buffer.data(), StagingModel::MAGIC, sizeof(StagingModel::MAGIC));
+	write_value<std::uint32_t>(buffer, 8, StagingModel::VERSION);
+	write_value<std::uint32_t>(buffer, 12, m_sections.size());
+
+	for (std::size_t i = 0; i != m_sections.size(); ++i) {
+		const Section& section = m_sections[i];
+		std::size_t position = HEADER_SIZE + i * SECTION_SIZE;
+		std::memcpy(buffer.data() + position, section.name.c_str(), section.name.size());
+		write_value<std::uint32_t>(buffer, position + 16, static_cast<std::uint32_t>(section.type));
+		write_value<std::uint32_t>(buffer, position + 20, section.rows);
+		write_value<std::uint32_t>(buffer, position + 24, section.cols);
+		write_value<std::uint64_t>(buffer, position + 32, offsets[i]);
+		std::memcpy(buffer.data() + offsets[i], section.data.data(), section.data.size());
+	}
+	return buffer;
+}
+
+void StagingModelBuilder::write(const std::string &filename) const {
+	std::vector<char> buffer = serialize();
+	std::ofstream out(filename, std::ios::binary);
+	out.write(buffer.data(), buffer.size());
+	if (!out.good()) {
+		throw std::runtime_error("StagingModelBuilder: could not write " + filename);
+	}
+}
+
+std::shared_ptr<const StagingModel> StagingModelBuilder::build() const {
+	return StagingModel::from_buffer(serialize());
+}
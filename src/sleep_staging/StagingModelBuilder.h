@@ -0,0 +1,57 @@
+/*
+ * StagingModelBuilder.h
+ */
+
+#ifndef SRC_SLEEP_STAGING_STAGINGMODELBUILDER_H_
+#define SRC_SLEEP_STAGING_STAGINGMODELBUILDER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <dlib/matrix.h>
+#include "StagingModel.h"
+
+/**
+ * Serializes the arrays of a staging model to the binary format
+ * described in StagingModel.h
+ */
+class StagingModelBuilder {
+	struct Section {
+		std::string name;
+		StagingModel::ArrayType type;
+		long rows;
+		long cols;
+		std::vector<char> data;
+	};
+
+	std::vector<Section> m_sections;
+
+	void add_section(const std::string &name, StagingModel::ArrayType type, long rows, long cols,
+					 const void* data, std::size_t size);
+
+public:
+	StagingModelBuilder& add(const std::string &name, const dlib::matrix<double> &values);
+	StagingModelBuilder& add(const std::string &name, const dlib::matrix<int> &values);
+
+	/**
+	 * Adds a row-major array of rows x cols values
+	 */
+	StagingModelBuilder& add(const std::string &name, const double* values, long rows, long cols);
+	StagingModelBuilder& add(const std::string &name, const int* values, long rows, long cols);
+
+	/**
+	 * Loads the MLP layers from the w<n>.csv and i<n>.csv files in 'directory'
+	 */
+	StagingModelBuilder& add_csv_layers(const std::string &directory);
+
+	std::vector<char> serialize() const;
+
+	/**
+	 * Writes the model to a file, throws std::runtime_error on failure
+	 */
+	void write(const std::string &filename) const;
+
+	std::shared_ptr<const StagingModel> build() const;
+};
+
+#endif /* SRC_SLEEP_STAGING_STAGINGMODELBUILDER_H_ */
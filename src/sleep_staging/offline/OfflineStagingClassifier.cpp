@@ -6,49 +6,56 @@
  */
 
 #include "MlpClassifier.h"
-#include <vector>
-#include <fstream>
-#include <istream>
-#include <sstream>
 #include "OfflineStagingClassifier.h"
-
-#include "dlib_utils.h"
-
-OfflineStagingClassifier* OfflineStagingClassifier::m_instance = nullptr;
+#include "HmmDecoder.h"
+#include "ModelRegistry.h"
+#include <algorithm>
+#include <string>
+#include <vector>
 
 OfflineStagingClassifier* OfflineStagingClassifier::get_instance() {
-	if (m_instance == nullptr) {
-		m_instance = new OfflineStagingClassifier();
-	}
-	return m_instance;
+	static OfflineStagingClassifier instance;
+	return &instance;
 }
 
 
 OfflineStagingClassifier::OfflineStagingClassifier()
-: m_mlp(nullptr)
 {
-	std::vector<dlib::matrix<double>> weights(2);
-	std::vector<dlib::matrix<double>> intercepts(2);
-
-	std::string W1_MATRIX_FILENAME(MODEL_RES_DIRECTORY "/w1.csv");
-	std::string W2_MATRIX_FILENAME(MODEL_RES_DIRECTORY "/w2.csv");
-	std::string I1_MATRIX_FILENAME(MODEL_RES_DIRECTORY "/i1.csv");
-	std::string I2_MATRIX_FILENAME(MODEL_RES_DIRECTORY "/i2.csv");
-
-	weights[0] = load_matrix(W1_MATRIX_FILENAME);
-	weights[1] = load_matrix(W2_MATRIX_FILENAME);
-
-	intercepts[0] = load_matrix(I1_MATRIX_FILENAME);
-	intercepts[1] = load_matrix(I2_MATRIX_FILENAME);
-
-	m_mlp = new MlpClassifier(weights, intercepts);
+	std::shared_ptr<const StagingModel> model = ModelRegistry::instance().offline_model();
+	m_mlp.reset(new MlpClassifier(model));
+
+	dlib::matrix<double> transitions;
+	if (model->has("transitions")) {
+		transitions = model->matrix("transitions");
+	} else {
+		const long classes = model->get("w" + std::to_string(model->layers())).cols;
+		transitions = dlib::uniform_matrix<double>(classes, classes, (1 - DEFAULT_STAY_PROBABILITY) / (classes - 1));
+		for (long i = 0; i != classes; ++i) {
+			transitions(i, i) = DEFAULT_STAY_PROBABILITY;
+		}
+	}
+	m_decoder.reset(new HmmDecoder(transitions));
 }
 
 OfflineStagingClassifier::~OfflineStagingClassifier() {
-	// TODO Auto-generated destructor stub
 }
 
 
 dlib::matrix<int> OfflineStagingClassifier::predict(const dlib::matrix<double> &input) {
 	return m_mlp->predict(input);
 }
+
+dlib::matrix<int> OfflineStagingClassifier::predict_smoothed(const dlib::matrix<double> &input) {
+	std::vector<int> path = m_decoder->viterbi(m_mlp->predict_proba(input));
+	dlib::matrix<int> result(path.size(), 1);
+	std::copy(path.begin(), path.end(), result.begin());
+	return result;
+}
+
+dlib::matrix<double> OfflineStagingClassifier::predict_posteriors(const dlib::matrix<double> &input) {
+	return m_decoder->posteriors(m_mlp->predict_proba(input));
+}
+
+const HmmDecoder& OfflineStagingClassifier::decoder() const {
+	return *m_decoder;
+}
@@ -9,7 +9,9 @@
 #define SRC_SLEEP_STAGING_OFFLINESTAGINGCLASSIFIER_H_
 
 #include <dlib/matrix.h>
+#include <memory>
 
+class HmmDecoder;
 class MlpClassifier;
 
 
@@ -23,16 +25,43 @@ class MlpClassifier;
  * You can consider removing this class.
  */ 
 class OfflineStagingClassifier {
-	OfflineStagingClassifier();
-	static OfflineStagingClassifier* m_instance;
+	std::unique_ptr<MlpClassifier> m_mlp;
+	std::unique_ptr<HmmDecoder> m_decoder;
 
-	MlpClassifier* m_mlp;
+	// used when the model has no transition matrix
+	const double DEFAULT_STAY_PROBABILITY = 0.9;
 public:
 
+	/**
+	 * Creates a classifier using the offline model shared through the ModelRegistry,
+	 * so creating many classifiers is cheap.
+	 */
+	OfflineStagingClassifier();
+
+	/**
+	 * @return a classifier shared by the whole process
+	 */
 	static OfflineStagingClassifier* get_instance();
 	virtual ~OfflineStagingClassifier();
 
+	/**
+	 * @return the most probable class of each epoch separately
+	 */
 	virtual dlib::matrix<int> predict(const dlib::matrix<double> &input);
+
+	/**
+	 * @return the classes on the most probable path through the whole night,
+	 * according to the transitions of the model (or ones favouring staying
+	 * in the same class, if the model has none), see HmmDecoder
+	 */
+	virtual dlib::matrix<int> predict_smoothed(const dlib::matrix<double> &input);
+
+	/**
+	 * @return the posterior probabilities of the classes, one row per epoch
+	 */
+	virtual dlib::matrix<double> predict_posteriors(const dlib::matrix<double> &input);
+
+	const HmmDecoder& decoder() const;
 };
 
 #endif /* SRC_SLEEP_STAGING_OFFLINESTAGINGCLASSIFIER_H_ */
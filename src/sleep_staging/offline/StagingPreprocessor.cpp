@@ -12,20 +12,78 @@
 #include "Config.h"
 #include <vector>
 #include <cassert>
-#include <iostream>
+#include "Diagnostics.h"
 #include "dlib_utils.h"
+#include "ExecutionTime.h"
+#include <functional>
+#include <sstream>
+#include <string>
 
 #include "EntropyFilter.h"
-StagingPreprocessor::StagingPreprocessor() {
-	// TODO Auto-generated constructor stub
+
+namespace {
+
+/*
+ * Calls a function when leaving the scope, also with an exception
+ */
+class ScopeGuard {
+	std::function<void()> m_on_exit;
+
+public:
+	explicit ScopeGuard(std::function<void()> on_exit)
+	: m_on_exit(on_exit)
+	{}
+
+	~ScopeGuard() {
+		m_on_exit();
+	}
+
+	ScopeGuard(const ScopeGuard&) = delete;
+	ScopeGuard& operator=(const ScopeGuard&) = delete;
+};
+
+/*
+ * Waits for a task unless its result was already taken
+ */
+template <typename T>
+void wait_for(std::future<T> &task) {
+	if (task.valid()) {
+		task.wait();
+	}
+}
 
 }
 
+const int StagingPreprocessor::EEG_FFT_WINDOW;
+const int StagingPreprocessor::IR_FFT_WINDOW;
+const int StagingPreprocessor::NUMBER_OF_FEATURES;
+const int StagingPreprocessor::ROLLING_MEAN_WINDOW;
+const int StagingPreprocessor::EEG_FFT_OVERLAP;
+const int StagingPreprocessor::IR_FFT_OVERLAP;
+
+StagingPreprocessor::StagingPreprocessor(unsigned int threads)
+: m_pool(new ThreadPool(threads))
+{
+}
+
 StagingPreprocessor::~StagingPreprocessor() {
-	// TODO Auto-generated destructor stub
 }
 
+template <typename F>
+typename std::result_of<F()>::type StagingPreprocessor::timed(const std::string &stage, F task) {
+	ExecutionTimer timer;
+	auto result = task();
+	double elapsed = timer.elapsed_ms();
+
+	std::lock_guard<std::mutex> lock(m_stage_times_mutex);
+	m_stage_times[stage] = elapsed;
+	return result;
+}
 
+std::map<std::string, double> StagingPreprocessor::get_stage_times() const {
+	std::lock_guard<std::mutex> lock(m_stage_times_mutex);
+	return m_stage_times;
+}
 
 Spectrogram StagingPreprocessor::get_eeg_spectrogram(const dlib::matrix<double> eeg_signal) {
 	Spectrogram eeg_spectrogram(eeg_signal, Config::instance().neuroon_eeg_freq(), EEG_FFT_WINDOW, EEG_FFT_OVERLAP);
@@ -39,15 +97,42 @@ Spectrogram StagingPreprocessor::get_ir_spectrogram(const dlib::matrix<double> i
 
 dlib::matrix<double> StagingPreprocessor::transform(const dlib::matrix<double>& eeg_signal,
 													const dlib::matrix<double>& ir_signal) {
+	{
+		std::lock_guard<std::mutex> lock(m_stage_times_mutex);
+		m_stage_times.clear();
+	}
 
-	Spectrogram eeg_spectrogram = get_eeg_spectrogram(eeg_signal);
-	Spectrogram pulse_spectrogram = get_ir_spectrogram(ir_signal);
-
-	dlib::matrix<double> features = transform(eeg_spectrogram, pulse_spectrogram);
-	return features;
+	return timed("total", [&]() {
+		// the IR branch doesn't depend on the EEG at all, so it runs from the signal
+		// to the features while the EEG spectrogram is being computed
+		std::future<dlib::matrix<double>> ir = m_pool->submit([this, &ir_signal]() {
+			Spectrogram pulse_spectrogram = timed("ir_spectrogram", [&]() { return get_ir_spectrogram(ir_signal); });
+			return ir_features(pulse_spectrogram);
+		});
+		// the task refers to the signal and to this object
+		ScopeGuard wait_for_ir([&ir]() { wait_for(ir); });
+
+		Spectrogram eeg_spectrogram = timed("eeg_spectrogram", [&]() { return get_eeg_spectrogram(eeg_signal); });
+		return combine(eeg_spectrogram, ir);
+	});
 }
 
 dlib::matrix<double> StagingPreprocessor::transform(const Spectrogram &eeg_spectrogram, const Spectrogram &pulse_spectrogram) {
+	{
+		std::lock_guard<std::mutex> lock(m_stage_times_mutex);
+		m_stage_times.clear();
+	}
+
+	return timed("total", [&]() {
+		std::future<dlib::matrix<double>> ir = m_pool->submit([this, &pulse_spectrogram]() {
+			return ir_features(pulse_spectrogram);
+		});
+		ScopeGuard wait_for_ir([&ir]() { wait_for(ir); });
+		return combine(eeg_spectrogram, ir);
+	});
+}
+
+dlib::matrix<double> StagingPreprocessor::eeg_band_sums(const Spectrogram &eeg_spectrogram) {
 	std::vector<double> borders({2.5, 7.5, 10, 14, 21});
 	dlib::matrix<double> eeg_sums = Features::sum_by_borders(eeg_spectrogram, borders);
 	eeg_sums = dlib::log(eeg_sums);
@@ -56,19 +141,62 @@ dlib::matrix<double> StagingPreprocessor::transform(const Spectrogram &eeg_spect
 	AmplitudeFilter f(EEG_FILTER_CRITICAL);
 
 	eeg_sums = f.transform(eeg_sums, dlib::colm(eeg_sums, EEG_FILTER_COLUMN));
+	return eeg_sums;
+}
 
-// =================== PULSE FEATURES =================================
+dlib::matrix<double> StagingPreprocessor::ir_features(const Spectrogram &pulse_spectrogram) {
+	return timed("ir_features", [&]() {
+		const int N_MAX_FOR_SPREAD = 1;
+		//TODO: filter the pulse here
+		dlib::matrix<double> pulse_band = pulse_spectrogram.get_band(0.6, 1.5625);
+		const double CRITICAL_PULSE_SPECTROGRAM_ENTROPY = 4.1;
+		EntropyFilter pulse_filter(CRITICAL_PULSE_SPECTROGRAM_ENTROPY);
+		dlib::matrix<double> n_max_to_med = Features::n_max_to_median(pulse_band, N_MAX_FOR_SPREAD);
+		set_selected_rows(n_max_to_med, pulse_filter.rejected_rows(pulse_band), NAN);
+		const int IR_ROLLING_MEAN_WINDOW = 50;
+		n_max_to_med = Features::sparse_rolling_mean(n_max_to_med, IR_ROLLING_MEAN_WINDOW);
+		n_max_to_med = Features::standardize(n_max_to_med);
+		return n_max_to_med;
+	});
+}
 
-	const int N_MAX_FOR_SPREAD = 1;
-	//TODO: filter the pulse here
-	dlib::matrix<double> pulse_band = pulse_spectrogram.get_band(0.6, 1.5625);
-	const double CRITICAL_PULSE_SPECTROGRAM_ENTROPY = 4.1;
-	EntropyFilter pulse_filter(CRITICAL_PULSE_SPECTROGRAM_ENTROPY);
-	pulse_band = pulse_filter.transform(pulse_band);
-	dlib::matrix<double> n_max_to_med = Features::n_max_to_median(pulse_band, N_MAX_FOR_SPREAD);
-	const int IR_ROLLING_MEAN_WINDOW = 50;
-	n_max_to_med = Features::sparse_rolling_mean(n_max_to_med, IR_ROLLING_MEAN_WINDOW);
-	n_max_to_med = Features::standardize(n_max_to_med);
+dlib::matrix<double> StagingPreprocessor::combine(const Spectrogram &eeg_spectrogram,
+												  std::future<dlib::matrix<double>> &ir_features) {
+	const dlib::matrix<double> eeg_sums = timed("eeg_band_sums", [&]() { return eeg_band_sums(eeg_spectrogram); });
+
+	// every EEG band column and the theta column are processed by a separate task,
+	// each of them depends only on the band sums. All the tasks have to finish
+	// before leaving the function, also with an exception, as they refer
+	// to the local variables
+	std::vector<std::future<dlib::matrix<double>>> columns;
+	ScopeGuard wait_for_columns([&columns]() {
+		for (auto &column : columns) {
+			wait_for(column);
+		}
+	});
+	for (long column = 0; column != eeg_sums.nc(); ++column) {
+		columns.push_back(m_pool->submit([this, &eeg_sums, column]() {
+			return timed("eeg_column_" + std::to_string(column), [&]() {
+				dlib::matrix<double> result = Features::sparse_rolling_mean(dlib::colm(eeg_sums, column), ROLLING_MEAN_WINDOW);
+				return Features::standardize(result);
+			});
+		}));
+	}
+
+	const int SPINDLE_BAND_INDEX = 2;
+	const int THETA_STANDARDIZATION_WINDOW_SIZE = 100;
+	columns.push_back(m_pool->submit([this, &eeg_sums, SPINDLE_BAND_INDEX, THETA_STANDARDIZATION_WINDOW_SIZE]() {
+		return timed("theta", [&]() {
+			dlib::matrix<double> result = Features::sparse_rolling_mean(dlib::colm(eeg_sums, SPINDLE_BAND_INDEX), ROLLING_MEAN_WINDOW);
+			return Features::standardize_in_window(result, THETA_STANDARDIZATION_WINDOW_SIZE);
+		});
+	}));
+
+	std::vector<dlib::matrix<double>> column_values;
+	for (auto &column : columns) {
+		column_values.push_back(column.get());
+	}
+	dlib::matrix<double> n_max_to_med = ir_features.get();
 
 	if (n_max_to_med.nr() != eeg_sums.nr()) {
 		std::stringstream s;
@@ -76,25 +204,17 @@ dlib::matrix<double> StagingPreprocessor::transform(const Spectrogram &eeg_spect
 		  << n_max_to_med.nr() << " (IR) vs. " << eeg_sums.nr() << " (EEG)" << std::endl;
 		throw std::logic_error(s.str());
 	}
-// =================== PULSE FEATURES END =============================
+
 	//TODO: standardize the bands
 
 	dlib::matrix<double> features(eeg_spectrogram.size(), NUMBER_OF_FEATURES);
 	int feature_index = 0;
 	for (; feature_index != eeg_sums.nc(); ++feature_index) {
-		dlib::set_colm(features, feature_index) = Features::sparse_rolling_mean(dlib::colm(eeg_sums, feature_index), ROLLING_MEAN_WINDOW);
-
-		dlib::set_colm(features, feature_index) = Features::standardize(dlib::colm(features, feature_index));
+		dlib::set_colm(features, feature_index) = column_values[feature_index];
 	}
-	std::cout << "after rolling and standardize: " << nan_ratio(features) << std::endl;
-
-	const int SPINDLE_BAND_INDEX = 2;
-	const int THETA_STANDARDIZATION_WINDOW_SIZE = 100;
-	dlib::set_colm(features, feature_index) = dlib::colm(eeg_sums, SPINDLE_BAND_INDEX);
-	dlib::set_colm(features, feature_index) = Features::sparse_rolling_mean(dlib::colm(features, feature_index), ROLLING_MEAN_WINDOW);
-	dlib::set_colm(features, feature_index) = Features::standardize_in_window(dlib::colm(features, feature_index),
-			THETA_STANDARDIZATION_WINDOW_SIZE);
+	DIAG_TRACE("staging_preprocessor.nan_ratio") << nan_ratio(features);
 
+	dlib::set_colm(features, feature_index) = column_values[feature_index];
 	++feature_index;
 
 	dlib::set_colm(features, feature_index) = n_max_to_med;
@@ -9,7 +9,13 @@
 #define SRC_SLEEP_STAGING_STAGINGPREPROCESSOR_H_
 
 #include <dlib/matrix.h>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
 #include "Spectrogram.h"
+#include "ThreadPool.h"
 
 
 /**
@@ -18,22 +24,48 @@
  * This class is largely deprecated since the online staging algorithm is 
  * also capable of computing offline staging. Therefore you may consider
  * dropping this code.
+ *
+ * The computation is split into a graph of independent tasks (the EEG and
+ * the IR branches, and each of the EEG feature columns) executed on a thread
+ * pool. The results don't depend on the number of threads used.
  */ 
 class StagingPreprocessor {
+public:
+	/**
+	 * The configuration of the features, the offline model has to be
+	 * trained with the same one, see ModelRegistry::offline_model
+	 */
+	static const int EEG_FFT_WINDOW = 10 * 1024;
+	static const int IR_FFT_WINDOW = EEG_FFT_WINDOW / 5;
+	static const int NUMBER_OF_FEATURES = 7;
+	static const int ROLLING_MEAN_WINDOW = 20;
 
+private:
+	static const int EEG_FFT_OVERLAP = (EEG_FFT_WINDOW * 3) / 4;
+	static const int IR_FFT_OVERLAP = EEG_FFT_OVERLAP / 5;
 
-	const int EEG_FFT_WINDOW = 10 * 1024;
-	const int EEG_FFT_OVERLAP = (EEG_FFT_WINDOW * 3) / 4;
 
-	const int IR_FFT_WINDOW = EEG_FFT_WINDOW / 5;
-	const int IR_FFT_OVERLAP = EEG_FFT_OVERLAP / 5;
+	mutable std::mutex m_stage_times_mutex;
+	std::map<std::string, double> m_stage_times;
 
-	const int NUMBER_OF_FEATURES = 7;
-	const int ROLLING_MEAN_WINDOW = 20;
+	// declared last, so that the workers are joined before the members
+	// the tasks use are destroyed
+	std::unique_ptr<ThreadPool> m_pool;
 
+	template <typename F>
+	typename std::result_of<F()>::type timed(const std::string &stage, F task);
+
+	dlib::matrix<double> eeg_band_sums(const Spectrogram &eeg_spectrogram);
+	dlib::matrix<double> ir_features(const Spectrogram &pulse_spectrogram);
+	dlib::matrix<double> combine(const Spectrogram &eeg_spectrogram,
+								 std::future<dlib::matrix<double>> &ir_features);
 
 public:
-	StagingPreprocessor();
+	/**
+	 * @param threads : the number of worker threads used for computing the features,
+	 * 0 means computing everything on the calling thread.
+	 */
+	explicit StagingPreprocessor(unsigned int threads = 0);
 	virtual ~StagingPreprocessor();
 
 	dlib::matrix<double> transform(const dlib::matrix<double>& eeg_signal, const dlib::matrix<double>& ir_signal);
@@ -41,6 +73,12 @@ public:
 
 	Spectrogram get_eeg_spectrogram(const dlib::matrix<double> eeg_signal);
 	Spectrogram get_ir_spectrogram(const dlib::matrix<double> ir_signal);
+
+	/**
+	 * @return the wall time in milliseconds of each stage of the last transform,
+	 * stages executed in parallel overlap, 'total' is the time of the whole transform
+	 */
+	std::map<std::string, double> get_stage_times() const;
 };
 
 #endif /* SRC_SLEEP_STAGING_STAGINGPREPROCESSOR_H_ */
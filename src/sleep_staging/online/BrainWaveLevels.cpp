@@ -6,6 +6,7 @@
  */
 
 #include "BrainWaveLevels.h"
+#include "Diagnostics.h"
 #include "Features.h"
 #include "NeuroonSignalStreamApi.h"
 #include <stdexcept>
@@ -29,8 +30,7 @@ std::vector<ncBrainWaveLevels> BrainWaveLevels::predict(const Spectrogram &spect
 
 	dlib::matrix<double> sums = Features::sum_in_bands(spectrogram, bands);
 	dlib::matrix<double> sum = dlib::sum_cols(sums);
-	std::cout << "sum " << sum << std::endl;
-	std::cout << "bands: " << sums << std::endl;
+	DIAG_TRACE("brain_waves.band_sums") << "sum " << sum << "; bands: " << sums;
 	for (int i = 0; i != sums.nc(); ++i) {
 		dlib::set_colm(sums, i) = dlib::pointwise_multiply(dlib::colm(sums, i), 1 / sum);
 	}
@@ -40,7 +40,7 @@ std::vector<ncBrainWaveLevels> BrainWaveLevels::predict(const Spectrogram &spect
 		dlib::matrix<double> row = dlib::rowm(sums, i);
 		m_smoother.feed(row);
 		row = m_smoother.value();
-		std::cout << "after filter: " << row << std::endl;
+		DIAG_TRACE("brain_waves.smoothed") << row;
 
 		ncBrainWaveLevels levels;
 		levels.delta = row(0, 0);
@@ -0,0 +1,112 @@
+#include "EegBandFeatures.h"
+#include <cmath>
+#include <stdexcept>
+
+EegBandFeatures::EegBandFeatures(int rolling_window, bool partial_window)
+: m_rolling_window(rolling_window)
+, m_partial_window(partial_window)
+, m_band_starts(NUMBER_OF_FEATURES + 1)
+, m_filter_first_band(static_cast<int>(FILTER_LOW - LOWEST_BORDER))
+, m_filter_last_band(static_cast<int>(FILTER_HIGH - LOWEST_BORDER) - 1)
+, m_indexed_bins(0)
+, m_indexed_resolution(0)
+, m_history(rolling_window, NUMBER_OF_FEATURES)
+, m_row(1, NUMBER_OF_FEATURES)
+, m_mean(1, NUMBER_OF_FEATURES)
+{
+	reset();
+}
+
+void EegBandFeatures::reset() {
+	m_history_next = 0;
+	m_history_size = 0;
+	m_mean.reset();
+}
+
+void EegBandFeatures::update_band_indices(const Spectrogram& eeg_spectrogram) {
+	const dlib::matrix<double>& frequencies = eeg_spectrogram.get_frequencies();
+	double resolution = frequencies.nr() > 1 ? frequencies(1, 0) : 0;
+	if (frequencies.nr() == m_indexed_bins && resolution == m_indexed_resolution) {
+		return;
+	}
+
+	// the bands are adjacent, so a band ends where the next one starts,
+	// exactly as when computing them with Features::sum_by_borders
+	for (int i = 0; i != NUMBER_OF_FEATURES; ++i) {
+		auto indices = eeg_spectrogram.freq_indices(LOWEST_BORDER + i, LOWEST_BORDER + i + 1);
+		m_band_starts[i] = static_cast<int>(indices.first);
+		m_band_starts[i + 1] = static_cast<int>(indices.second);
+	}
+
+	m_indexed_bins = frequencies.nr();
+	m_indexed_resolution = resolution;
+}
+
+void EegBandFeatures::transform(const Spectrogram& eeg_spectrogram, double* out) {
+	if (eeg_spectrogram.size() != 1) {
+		throw std::logic_error("EegBandFeatures: only single-row spectrograms are supported");
+	}
+	update_band_indices(eeg_spectrogram);
+
+	const dlib::matrix<double>& spectrum = eeg_spectrogram.data();
+	const double* bins = &spectrum(0, 0);
+	double* sums = &m_history(m_history_next, 0);
+
+	double filter_sum = 0;
+	for (int band = 0; band != NUMBER_OF_FEATURES; ++band) {
+		double sum = 0;
+		for (int bin = m_band_starts[band]; bin != m_band_starts[band + 1]; ++bin) {
+			sum += bins[bin];
+		}
+		if (band >= m_filter_first_band && band <= m_filter_last_band) {
+			filter_sum += sum;
+		}
+		sums[band] = (1. / (m_band_starts[band + 1] - m_band_starts[band])) * sum;
+	}
+
+	push_step(std::log(filter_sum) > FILTER_CRITICAL, out);
+}
+
+void EegBandFeatures::transform_rejected(double* out) {
+	double* sums = &m_history(m_history_next, 0);
+	for (int band = 0; band != NUMBER_OF_FEATURES; ++band) {
+		sums[band] = NAN;
+	}
+	push_step(true, out);
+}
+
+void EegBandFeatures::push_step(bool rejected, double* out) {
+	m_history_next = (m_history_next + 1) % m_rolling_window;
+	if (m_history_size < m_rolling_window) {
+		++m_history_size;
+	}
+
+	bool filled = m_history_size == m_rolling_window || m_partial_window;
+	if (rejected || !filled) {
+		for (int band = 0; band != NUMBER_OF_FEATURES; ++band) {
+			m_row(0, band) = NAN;
+		}
+	} else {
+		// summing from the oldest step to keep the order of the RollingMean
+		const int oldest = (m_history_next + m_rolling_window - m_history_size) % m_rolling_window;
+		for (int band = 0; band != NUMBER_OF_FEATURES; ++band) {
+			double sum = 0;
+			for (int i = 0; i != m_history_size; ++i) {
+				sum += m_history((oldest + i) % m_rolling_window, band);
+			}
+			m_row(0, band) = std::log((1. / m_history_size) * sum);
+		}
+	}
+
+	m_mean.consume(m_row);
+	const dlib::matrix<double>& mean = m_mean.value();
+	for (int band = 0; band != NUMBER_OF_FEATURES; ++band) {
+		out[band] = (m_row(0, band) - mean(0, band)) * (1. / FEATURE_STD);
+	}
+}
+
+dlib::matrix<double> EegBandFeatures::transform(const Spectrogram& eeg_spectrogram) {
+	dlib::matrix<double> result(1, NUMBER_OF_FEATURES);
+	transform(eeg_spectrogram, &result(0, 0));
+	return result;
+}
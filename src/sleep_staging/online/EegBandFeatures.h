@@ -0,0 +1,93 @@
+#ifndef SRC_SLEEP_STAGING_ONLINE_EEGBANDFEATURES_H_
+#define SRC_SLEEP_STAGING_ONLINE_EEGBANDFEATURES_H_
+
+#include <dlib/matrix.h>
+#include <vector>
+#include "ExpandingMean.h"
+#include "Spectrogram.h"
+
+/**
+ * Computes the EEG features of the online staging algorithm, i.e. the
+ * standardized logarithms of the rolling mean amplitudes in the 1 Hz bands
+ * between 1 and 21 Hz, with the noisy samples rejected by the amplitude
+ * in the 10-14 Hz band.
+ *
+ * This is a fused equivalent of the chain:
+ * Features::sum_by_borders -> RollingMean -> dlib::log -> AmplitudeFilter
+ * -> ExpandingMean -> standardize. All the band sums are computed in a single
+ * pass over the spectral row and the running state is updated in place, so
+ * no temporary matrices are created for each step.
+ */
+class EegBandFeatures {
+public:
+	static const int NUMBER_OF_FEATURES = 20;
+
+	/**
+	 * @param rolling_window : the number of steps averaged by the rolling mean.
+	 * The features are NaN until that many steps are seen.
+	 * @param partial_window : if true, the available steps are averaged
+	 * until the rolling window is filled, instead of returning NaN
+	 */
+	EegBandFeatures(int rolling_window, bool partial_window = false);
+
+	/**
+	 * Resets the rolling and the expanding state to the original values.
+	 */
+	void reset();
+
+	/**
+	 * Computes the features for a spectrogram consisting of a single row
+	 * (one time window) and writes them to 'out', which has to have room
+	 * for NUMBER_OF_FEATURES values.
+	 */
+	void transform(const Spectrogram& eeg_spectrogram, double* out);
+
+	/**
+	 * Same as above, but returns the features as a 1 x NUMBER_OF_FEATURES matrix
+	 */
+	dlib::matrix<double> transform(const Spectrogram& eeg_spectrogram);
+
+	/**
+	 * Adds a step without a spectrogram, e.g. when the EEG wasn't analyzed.
+	 * Its band sums are NaN, so the features are NaN until the step leaves
+	 * the rolling window, as for any NaN in the signal, and the whole-night
+	 * means ignore it. Writes the (NaN) features of the step to 'out'.
+	 */
+	void transform_rejected(double* out);
+
+private:
+	const double FEATURE_STD = 0.3;
+	const double FILTER_CRITICAL = 19;
+	const double FILTER_LOW = 10;
+	const double FILTER_HIGH = 14;
+	const double LOWEST_BORDER = 1;
+
+	void update_band_indices(const Spectrogram& eeg_spectrogram);
+
+	/**
+	 * Adds the band sums written to the next row of m_history
+	 * as a step, computes its features
+	 */
+	void push_step(bool rejected, double* out);
+
+	int m_rolling_window;
+	bool m_partial_window;
+
+	// spectrogram columns at which the consecutive bands begin; the last
+	// element is the end of the last band
+	std::vector<int> m_band_starts;
+	int m_filter_first_band;
+	int m_filter_last_band;
+	long m_indexed_bins;
+	double m_indexed_resolution;
+
+	// rolling window of the band sums, one row per step, used as a ring
+	dlib::matrix<double> m_history;
+	int m_history_next;
+	int m_history_size;
+
+	dlib::matrix<double> m_row;
+	ExpandingMean m_mean;
+};
+
+#endif /* SRC_SLEEP_STAGING_ONLINE_EEGBANDFEATURES_H_ */
@@ -1,22 +1,33 @@
-#include <dlib/matrix.h>
-
+/*
+ * The compiled-in online staging model. The arrays are plain constants, so
+ * nothing is constructed at startup; ModelRegistry turns them into a shared
+ * StagingModel on first use.
+ */
 namespace online_model{
 
-  const static dlib::matrix<int, 1, 4> Classes = {-4, -3, -1, 0};
+  const long Classes_ROWS = 1;
+  const long Classes_COLS = 4;
+  const int Classes[Classes_ROWS * Classes_COLS] = {-4, -3, -1, 0};
 
-  const static dlib::matrix<double, 4, 4> Transitions = {
+  const long Transitions_ROWS = 4;
+  const long Transitions_COLS = 4;
+  const double Transitions[Transitions_ROWS * Transitions_COLS] = {
     0.974069, 0.147042, 0.000000, 0.000000,
     0.223577, 0.982803, 0.160835, 0.225494,
     0.030587, 0.103293, 0.986280, 0.049207,
     0.016350, 0.042503, 0.037193, 0.973001};
 
-  const static dlib::matrix<double, 4, 1> I2 = {
+  const long I2_ROWS = 4;
+  const long I2_COLS = 1;
+  const double I2[I2_ROWS * I2_COLS] = {
     -4.806459984292044824e-02,
     2.947488353646933734e-01,
     4.471083917312634534e-03,
     -1.636372334154529984e-01};
 
-  const static dlib::matrix<double, 100, 1> I1 = {
+  const long I1_ROWS = 100;
+  const long I1_COLS = 1;
+  const double I1[I1_ROWS * I1_COLS] = {
     2.761867043283987022e-01,
     -3.470662656325610995e-01,
     2.359257024056806706e-01,
@@ -1,8 +1,8 @@
-#include <dlib/matrix.h>
-
 namespace online_model{
 
-const static dlib::matrix<double, 22, 100> W1 ={-1.755871764480908537e-01,2.485328392815914500e-01,1.413448227578643045e-02,-1.468942090135853529e-01,3.078388249454112793e-03,-7.832277687636494956e-03,-3.018914974971037002e-01,1.121627874040130313e-01,1.442100486465022757e-01,2.016933179970570589e-01,-1.271855546401117198e-01,4.265658959566696051e-01,9.690259608427333193e-02,7.821614037875780634e-02,2.269567445890154772e-02,-1.410370865834880416e-01,-1.593085323327652902e-01,1.723060080678010531e-01,4.252814218065042312e-02,-4.068386208107230284e-02,5.597476156546925957e-02,-2.463861274833114012e-01,5.912118301068937376e-02,6.276200889315541355e-03,-3.460955505632181545e-02,2.593041486717196364e-01,-6.893902615580019266e-02,-4.993007504045198636e-02,-2.093741821403889702e-02,-7.962287350206899428e-02,3.688521444185589859e-02,-2.814230265696436306e-01,-4.810550845195655789e-01,4.062480094335226832e-01,3.151498124772880716e-01,7.058624303409083423e-02,-4.717501988285340703e-02,-2.028486265179102466e-01,1.994826998526195438e-01,-1.191599237744565658e-02,-1.613595726887554205e-01,1.832741421203263887e-01,-5.414326496162228386e-01,2.373060630497715040e-01,-4.830461652787875620e-02,1.966311542741505103e-01,-2.327802436974209521e-01,-9.463012476280430185e-02,-1.999253315177235701e-01,-2.378129365751459334e-02,2.506089803046783748e-01,3.172844327415437482e-02,2.878532636146777790e-01,2.291841694998291989e-01,4.002028657773863407e-01,1.997304253259515605e-01,-3.357966931069836791e-01,-2.468737035961556248e-01,-2.680353531092473651e-01,-6.052576145267873908e-02,9.393958719175153627e-02,-3.593597183153778296e-01,1.207930835230149186e-01,3.692136130623056844e-02,-1.178817586457209937e-01,-4.342631737951212212e-02,5.141388859191384914e-03,1.281648979305470004e-01,-2.491534034510677412e-02,1.920325349721046515e-01,-4.825476135471661043e-02,-1.002051007876479244e-01,-2.689448233850073589e-01,3.680014597652062763e-02,-7.138163807572944775e-02,1.145486114392280791e-01,9.238943199579607857e-02,-5.834813655936123972e-02,-2.765336621725274502e-01,-1.899512190922911792e-01,1.321099203211117401e-01,-1.319241657754396946e-01,1.954422535415287557e-02,-3.094495913224056260e-01,1.756709530494671989e-01,9.538608299847319005e-02,-6.697401898610773341e-02,2.515638330147012547e-01,-5.205532744826609631e-02,-1.987155460218811009e-01,-1.371372134989646552e-01,6.414933942379597021e-02,2.050709063730684900e-01,1.142009870277934935e-01,1.893572403564030560e-01,-1.019493963981201595e-01,4.833258774338408670e-02,3.694538151533219295e-02,-2.715857673546466233e-01,-1.544338901853992974e-01,
+const long W1_ROWS = 22;
+const long W1_COLS = 100;
+const double W1[W1_ROWS * W1_COLS] ={-1.755871764480908537e-01,2.485328392815914500e-01,1.413448227578643045e-02,-1.468942090135853529e-01,3.078388249454112793e-03,-7.832277687636494956e-03,-3.018914974971037002e-01,1.121627874040130313e-01,1.442100486465022757e-01,2.016933179970570589e-01,-1.271855546401117198e-01,4.265658959566696051e-01,9.690259608427333193e-02,7.821614037875780634e-02,2.269567445890154772e-02,-1.410370865834880416e-01,-1.593085323327652902e-01,1.723060080678010531e-01,4.252814218065042312e-02,-4.068386208107230284e-02,5.597476156546925957e-02,-2.463861274833114012e-01,5.912118301068937376e-02,6.276200889315541355e-03,-3.460955505632181545e-02,2.593041486717196364e-01,-6.893902615580019266e-02,-4.993007504045198636e-02,-2.093741821403889702e-02,-7.962287350206899428e-02,3.688521444185589859e-02,-2.814230265696436306e-01,-4.810550845195655789e-01,4.062480094335226832e-01,3.151498124772880716e-01,7.058624303409083423e-02,-4.717501988285340703e-02,-2.028486265179102466e-01,1.994826998526195438e-01,-1.191599237744565658e-02,-1.613595726887554205e-01,1.832741421203263887e-01,-5.414326496162228386e-01,2.373060630497715040e-01,-4.830461652787875620e-02,1.966311542741505103e-01,-2.327802436974209521e-01,-9.463012476280430185e-02,-1.999253315177235701e-01,-2.378129365751459334e-02,2.506089803046783748e-01,3.172844327415437482e-02,2.878532636146777790e-01,2.291841694998291989e-01,4.002028657773863407e-01,1.997304253259515605e-01,-3.357966931069836791e-01,-2.468737035961556248e-01,-2.680353531092473651e-01,-6.052576145267873908e-02,9.393958719175153627e-02,-3.593597183153778296e-01,1.207930835230149186e-01,3.692136130623056844e-02,-1.178817586457209937e-01,-4.342631737951212212e-02,5.141388859191384914e-03,1.281648979305470004e-01,-2.491534034510677412e-02,1.920325349721046515e-01,-4.825476135471661043e-02,-1.002051007876479244e-01,-2.689448233850073589e-01,3.680014597652062763e-02,-7.138163807572944775e-02,1.145486114392280791e-01,9.238943199579607857e-02,-5.834813655936123972e-02,-2.765336621725274502e-01,-1.899512190922911792e-01,1.321099203211117401e-01,-1.319241657754396946e-01,1.954422535415287557e-02,-3.094495913224056260e-01,1.756709530494671989e-01,9.538608299847319005e-02,-6.697401898610773341e-02,2.515638330147012547e-01,-5.205532744826609631e-02,-1.987155460218811009e-01,-1.371372134989646552e-01,6.414933942379597021e-02,2.050709063730684900e-01,1.142009870277934935e-01,1.893572403564030560e-01,-1.019493963981201595e-01,4.833258774338408670e-02,3.694538151533219295e-02,-2.715857673546466233e-01,-1.544338901853992974e-01,
   -1.690845676000395370e-01,3.003315215809321259e-01,-1.047058352226574729e-01,-9.959615652507206041e-02,5.214997785576057365e-02,2.282752901652429847e-02,-3.562004021001154153e-02,1.266225171012317352e-01,5.960848613497662755e-03,-3.025371786672029217e-01,-2.697410868143619300e-01,-3.287226319811810127e-01,2.480417485287357282e-01,-1.182390967438473085e-02,2.568565051279902978e-02,-2.202605340202137135e-03,-1.559654696973445664e-01,-2.014262195006351341e-01,1.883427264359986697e-01,-8.180246982589824134e-02,1.044178938523932995e-02,4.438223809694009647e-01,-1.050368635839180192e-01,-2.350665940460376635e-01,-7.980833429990992142e-03,-1.741094730990164208e-01,-3.991922204718047380e-03,2.927383269592341575e-02,-1.677077970883396885e-01,-3.293223841819105380e-02,-2.756547293692780676e-02,-2.490695868433027704e-01,-9.617479001287768114e-02,-1.281235197627141886e-01,2.397517367140377942e-01,-9.800052987122234716e-02,-1.640946968241880910e-01,7.876040423266106316e-02,-8.498427140321994713e-03,2.415297800585191890e-01,9.825967180378538182e-03,4.026623251806648457e-02,1.935682194219421337e-01,1.223685024902428781e-02,1.223730657892987093e-02,-4.096956232897767114e-01,2.264197202437650269e-01,-3.934095709955932607e-01,-1.008476368000996715e-01,-1.325027748267828577e-02,1.828191873369068299e-01,-1.576653896591651352e-02,5.788552993042983541e-02,1.511559348544704584e-01,3.260424107352884460e-01,-1.149630097254687872e-01,3.340842037514980128e-02,1.503661562368749094e-01,-1.334201992426300443e-01,7.356449509718207547e-02,3.568903705042898028e-02,1.173501939832830160e-01,3.156552760961753648e-03,1.435113838517493856e-01,-4.897685936133493179e-02,6.535622713995360711e-02,3.735629699482072297e-02,-2.309730075108621938e-01,1.821360365582659277e-02,2.994580126798150957e-02,-6.362034835159006974e-02,-1.805931937179906799e-01,-6.476510390955533825e-02,-9.796376149694017987e-02,4.922109279906065199e-02,-2.175183187509710514e-01,7.988484721460671623e-02,-1.194094886109390262e-02,1.889993170082522600e-01,-1.774421134689261048e-01,-4.776018286195254058e-03,-1.374224278446748992e-01,3.281635147456034574e-01,1.713115686600665266e-01,-1.221329451959769080e-01,8.745773150624766568e-02,1.830788095196060339e-01,4.696203560990754727e-02,8.081721441838508532e-03,-2.506793603492829536e-01,1.387387519325045636e-02,1.077816427029531648e-01,2.507447035588933892e-01,-3.095953451667003004e-02,-6.149693171514418466e-03,1.178688603588236988e-02,4.954248773215883753e-04,2.828760761578025251e-01,2.535917242634256816e-02,-9.876158253914879906e-03,
   -5.759654923989750847e-02,1.580464446927202365e-02,-1.066250316424822292e-02,1.446201215845264731e-01,-5.754756960426787166e-02,-3.430943505828222290e-03,-1.027734584869765544e-01,9.718700486289365281e-02,-4.920026690906510042e-02,-1.924536580288124521e-01,1.132641808982552539e-01,-6.121480018158293596e-02,1.225032538319759251e-01,-5.873299067614410479e-02,2.000150045455053108e-02,-8.936903536086755750e-02,-5.373715567817755751e-02,-1.342426638653087048e-02,2.187778012659577498e-02,1.176408812141231386e-01,3.038282828904465471e-04,5.060615583064198564e-02,-1.013267703413363446e-01,-1.055425702362464691e-01,9.726152982178956283e-03,-1.403297102155973419e-01,1.279186215322004050e-01,5.140988428335421107e-02,1.662095615709106577e-01,-2.305401455091538390e-02,-1.171833241624965077e-02,-2.186740278852125803e-03,-4.986369632380971417e-02,-1.703408490820524090e-01,-2.253341361175566215e-01,8.250904737167689962e-02,1.747362912458551298e-02,-1.795592679374380107e-01,-8.070720001096026719e-02,-7.250524478751900481e-02,1.143006878172147661e-01,2.883376962398165877e-01,4.208437327358883762e-01,1.045617190493655785e-01,-1.557208976969185754e-01,2.464763050452750126e-01,-1.369031676314856338e-01,9.491836950665423142e-03,2.315321615435629587e-02,-2.189501570216106224e-02,5.415039813641842753e-02,3.460081791081175140e-02,2.385225557167862664e-01,4.354390111978293648e-02,-5.157081048432107240e-01,-1.549297503734869789e-02,3.279126808863536136e-01,8.020850894031029965e-02,1.005855173811783521e-01,-1.740651284527895970e-01,8.474478155712341157e-03,4.535977371002357095e-01,-2.464481444674818458e-02,2.100658076313444145e-02,1.797188675756448695e-01,-6.685855494281370270e-02,5.164646327501395268e-02,1.987897776777840797e-01,5.889910986544477645e-02,-2.554648176030275830e-01,1.020150063998852413e-01,8.409318038977452170e-02,8.861927959284126438e-03,9.194571620846517246e-02,-4.999191230203933745e-02,-2.693109452082395050e-01,8.564469962969445405e-02,-5.148776136488291549e-02,1.429551663578096099e-01,-6.515957412768771939e-02,-9.116380580809636813e-02,-1.109294939595376478e-01,2.064195514875935902e-02,-3.523108137235345660e-01,-2.087310785543776762e-02,-7.952674585274037422e-02,-1.156596665435333376e-01,-8.393101589163690091e-02,4.860898673676743165e-02,1.046441398415415003e-01,-1.091794760077287041e-01,-9.817613225824319001e-02,1.805816288662441260e-01,-1.164260477398520316e-01,-4.339466634818926749e-02,1.660476623139589269e-01,4.536628966380039374e-02,-6.430378974535158609e-02,-4.474560643468614846e-02,-2.119572277189997189e-01,
   -1.597679191232798390e-01,5.715779375458834161e-02,2.346193900936290738e-02,-2.773731174467557788e-03,-1.068242366703224186e-02,4.054876321772009351e-02,-3.448458324387106838e-02,4.701231117078441719e-03,1.347988843799549641e-01,-1.587044974932370622e-01,5.000094237231891316e-03,-9.149136391325426998e-02,-1.521908520649317975e-01,-5.326512061990810315e-02,-3.919923760742508728e-02,-9.787188045975326461e-03,-1.240427713631818279e-01,-1.876133244911275255e-01,-2.174682946869614317e-02,5.889161381787508948e-02,-6.449199761466811731e-02,1.928128805353163805e-02,8.966821697658222678e-03,-5.657639516817570408e-02,2.054563000431235409e-01,-7.921842208891438988e-03,1.835564229642568101e-01,4.411430454087023750e-02,6.882393634252492731e-02,1.066927082887903465e-02,-1.369288688420834503e-02,1.749082505654316055e-01,4.516286598483189307e-02,-3.238501024590643707e-01,-1.974117325209954199e-01,-1.180186895567598149e-01,7.793043079741200641e-02,-8.135726833321428597e-02,-2.624702530233316566e-02,-2.826020854050938502e-01,1.723640501190183347e-02,-5.141448319319086996e-02,1.680529824214254120e-01,5.490924466748337007e-02,1.902658806447088680e-01,1.401434386693155842e-01,2.725126174491186368e-02,-1.602015287229456575e-01,5.234168438671209234e-02,-1.272641871431482163e-01,7.269055609224031600e-02,1.146431324918887051e-01,-8.287139395745321546e-02,5.552380377024251218e-02,-3.097046394387424351e-01,3.584376456256718746e-02,-5.012241884169094108e-02,1.631825916066747262e-01,7.122927291073344325e-02,5.730315009058382925e-02,-1.178512816375747695e-02,2.162890167354641208e-02,-4.430589732434282030e-02,8.287497085138492703e-02,3.480247389237309807e-01,-1.301321257564670014e-02,3.187869876030178379e-02,2.594831703514066668e-01,-1.125595405553532352e-01,-4.111609502059809795e-01,-5.588035971460031393e-02,-2.030259439079626915e-01,-8.337178380315625470e-02,3.941930891930097228e-03,3.723964088789299964e-02,-2.833175418564788939e-01,4.638505430405653884e-02,-3.160217570339270837e-02,1.381865562119707069e-01,4.035908919792883381e-02,-3.784709038788307001e-01,8.209450340890613040e-02,-3.141426297561760589e-02,2.388995279639802988e-02,-8.492597826946426953e-02,-4.848223183220660981e-02,6.882411166815283199e-02,-4.073153425288831841e-01,1.336832754456799000e-01,2.692484523593114965e-01,5.961676959486596900e-02,-3.577247732214343390e-02,2.772214485316306168e-02,-8.370905656237119519e-02,-1.268873418349449889e-01,1.488928344353024069e-01,2.390775091649070469e-02,9.873876086566590882e-02,-3.287735144306263430e-02,2.802900914955335290e-02,
@@ -1,7 +1,7 @@
-#include <dlib/matrix.h>
-
 namespace online_model{
-  const static dlib::matrix<double, 100, 4> W2 = {
+  const long W2_ROWS = 100;
+  const long W2_COLS = 4;
+  const double W2[W2_ROWS * W2_COLS] = {
     -3.057768555940984512e-01, 3.482024031367754735e-01, 8.225567968223167908e-03, 8.536674551732897909e-02,
     -3.774721359839471324e-01, -2.400051557102914849e-03, -1.411209994933813883e-01, 2.559224031353649620e-01,
     1.715995497872155329e-01, 1.740084409194233295e-01, -4.823582997521346227e-01, 1.535927698364841776e-01,
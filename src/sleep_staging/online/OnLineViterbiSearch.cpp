@@ -8,115 +8,195 @@
 #include "OnLineViterbiSearch.h"
 #include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include "PerformanceCounters.h"
 #include "logger.h"
 OnLineViterbiSearch::OnLineViterbiSearch(const std::vector<int>& states, const dlib::matrix<double>& start_probabilities,
 				     	 	 	 	 	 const dlib::matrix<double>& final_probabilities, const dlib::matrix<double> transition_matrix,
-										 double viterbi_weight)
-: m_states(states),
+										 double viterbi_weight, int max_lag)
+: m_steps(0),
+  m_committed(0),
+  m_first_changed(0),
+  m_max_lag(max_lag),
+  m_log_probs(states.size(), -std::numeric_limits<double>::infinity()),
+  m_next_log_probs(states.size()),
+  m_log_emissions(states.size()),
+  m_log_transitions(states.size() * states.size()),
+  m_log_start_p(states.size()),
+  m_log_final_p(states.size()),
+  m_states(states),
   m_start_p(start_probabilities),
   m_final_p(final_probabilities),
   m_transition_matrix(transition_matrix),
   m_viterbi_weight(viterbi_weight)
 {
-	m_current_step = -1;
+	if (max_lag < 1) {
+		throw std::logic_error("the maximal lag of the Viterbi search has to be positive");
+	}
+	if (states.empty() || states.size() > std::numeric_limits<uint8_t>::max()) {
+		throw std::logic_error("the Viterbi search supports from 1 to 255 states");
+	}
+
+	// the ring holds the back pointers of up to max_lag uncommitted steps
+	// and the one being added
+	m_backpointers.resize((max_lag + 1) * states.size());
+	m_survivors.reserve(states.size());
 
 	m_transition_matrix = dlib::pow(m_transition_matrix, viterbi_weight);
+
+	const size_t n_states = states.size();
+	for (size_t state = 0; state != n_states; ++state) {
+		for (size_t next_state = 0; next_state != n_states; ++next_state) {
+			m_log_transitions[state * n_states + next_state] = std::log(m_transition_matrix(state, next_state));
+		}
+		m_log_start_p[state] = std::log(m_start_p(state, 0));
+		m_log_final_p[state] = std::log(m_final_p(state, 0));
+	}
 }
 
-void OnLineViterbiSearch::appendNewStep() {
-	m_paths.push_back(std::vector<OnLineViterbiSearch::PathElement>(m_states.size()));
-	++m_current_step;
+uint8_t* OnLineViterbiSearch::backpointers(size_t step) {
+	return &m_backpointers[(step % (m_max_lag + 1)) * m_states.size()];
 }
 
-// debug only
-void OnLineViterbiSearch::print_path_matrix() const {
-	for (int i = 0; i != m_paths.size(); ++i) {
-		std::cout << i << ". ";
-		for (int j = 0; j != m_states.size(); ++j) {
-			OnLineViterbiSearch::PathElement e = m_paths[i][j];
-			std::cout << e.previous_state << "->" << e.state <<": " << e.log_prob << '\t';
-		}
-		std::cout << std::endl;
-	}
+const uint8_t* OnLineViterbiSearch::backpointers(size_t step) const {
+	return &m_backpointers[(step % (m_max_lag + 1)) * m_states.size()];
 }
 
 void OnLineViterbiSearch::step(const dlib::matrix<double>& emission_probabilities) {
+	ScopedPerformanceTimer timer(NC_PERF_VITERBI);
 
 	assert(dlib::is_finite(emission_probabilities));
 	LOG(INFO) << emission_probabilities;
-	appendNewStep();
 
 	assert(dlib::sum(emission_probabilities) != 0);
 
-	for (int state = 0; state != m_states.size(); ++state) {
-		m_paths[m_current_step][state].state = state;
+	const int n_states = m_states.size();
+	for (int state = 0; state != n_states; ++state) {
+		m_log_emissions[state] = std::log(emission_probabilities(state, 0));
+	}
 
-		double emit_p = emission_probabilities(state, 0);
-		if (m_current_step == 0) {
-			m_paths[m_current_step][state].log_prob = std::log(emit_p) + std::log(m_start_p(state, 0));
-			m_paths[m_current_step][state].previous_state = INVALID_STATE_INDEX;
-			continue;
+	if (m_steps == 0) {
+		for (int state = 0; state != n_states; ++state) {
+			m_log_probs[state] = m_log_emissions[state] + m_log_start_p[state];
 		}
+	} else {
+		uint8_t* previous_states = backpointers(m_steps);
+		for (int next_state = 0; next_state != n_states; ++next_state) {
+			// a state unreachable from all the others points to the first one,
+			// its path has zero probability, so it's never followed
+			int best_state = 0;
+			double best_log_prob = -std::numeric_limits<double>::infinity();
+			const double* log_transitions = &m_log_transitions[next_state];
+			for (int state = 0; state != n_states; ++state) {
+				double log_prob = m_log_probs[state] + log_transitions[state * n_states];
+				if (log_prob > best_log_prob) {
+					best_log_prob = log_prob;
+					best_state = state;
+				}
+			}
+			m_next_log_probs[next_state] = best_log_prob + m_log_emissions[next_state];
+			previous_states[next_state] = static_cast<uint8_t>(best_state);
+		}
+		m_log_probs.swap(m_next_log_probs);
+	}
 
-		std::pair<int, double> origin = find_path_leading_here(state);
-		int previous_state = origin.first;
-		double log_prob = origin.second;
-		m_paths[m_current_step][state].log_prob = log_prob + std::log(emit_p);
-		m_paths[m_current_step][state].previous_state = previous_state;
+	++m_steps;
+	update_sequence();
+	commit();
+}
+
+void OnLineViterbiSearch::stop() {
+	if (m_steps == 0) {
+		LOG(WARNING) << "Tried to stop a Viterbi search without executing any steps";
+		return;
+	}
 
-//		std::cout << "step: " << m_current_step << ", state: " << state << "," << m_paths[m_current_step][state].state
-//				  << ", previous state: " << m_paths[m_current_step][state].previous_state << std::endl;
+	for (size_t state = 0; state != m_states.size(); ++state) {
+		m_log_probs[state] += m_log_final_p[state];
 	}
 
-	//print_path_matrix();
+	update_sequence();
 }
 
-std::pair<int, double> OnLineViterbiSearch::find_path_leading_here(int next_state) const {
-	int result_state = -1;
-	double best_log_prob = -std::numeric_limits<double>::infinity();
-	for (int state = 0; state != m_states.size(); ++state) {
-		double log_prob =  m_paths[m_current_step - 1][state].log_prob + std::log(m_transition_matrix(state, next_state));
-		if (log_prob > best_log_prob) {
-			best_log_prob = log_prob;
-			result_state = state;
+int OnLineViterbiSearch::most_probable_final() const {
+	auto it_to_max = std::max_element(m_log_probs.begin(), m_log_probs.end());
+	return std::distance(m_log_probs.begin(), it_to_max);
+}
+
+/*
+ * Backtracks the best path through the uncommitted steps and writes it
+ * to the sequence, remembering the first element that changed.
+ */
+void OnLineViterbiSearch::update_sequence() {
+	const size_t previous_size = m_sequence.size();
+	m_sequence.resize(m_steps);
+	m_first_changed = previous_size;
+
+	int state = most_probable_final();
+	for (size_t step = m_steps; step-- > m_committed; ) {
+		if (step >= previous_size || m_sequence[step] != m_states[state]) {
+			m_sequence[step] = m_states[state];
+			m_first_changed = step;
+		}
+		if (step > m_committed) {
+			state = backpointers(step)[state];
 		}
 	}
-
-	return std::make_pair(result_state, best_log_prob);
 }
 
-void OnLineViterbiSearch::stop() {
-	if (m_current_step == INVALID_STATE_INDEX) {
-		LOG(WARNING) << "Tried to stop a Viterbi search without executing any steps";
-		return;
+/*
+ * Commits the steps up to the point where the survivor paths of all
+ * the states converge, or the oldest ones if the tail is too long.
+ */
+void OnLineViterbiSearch::commit() {
+	// the paths with zero probability can't become a part of the best path
+	// later, so they don't have to converge
+	m_survivors.clear();
+	for (size_t state = 0; state != m_states.size(); ++state) {
+		if (m_log_probs[state] > -std::numeric_limits<double>::infinity()) {
+			m_survivors.push_back(state);
+		}
 	}
 
-	for (int state = 0; state != m_states.size(); ++state) {
-		m_paths[m_current_step][state].log_prob += std::log(m_final_p(state, 0));
+	for (size_t step = m_steps - 1; step > m_committed && !m_survivors.empty(); --step) {
+		const uint8_t* previous_states = backpointers(step);
+		bool converged = true;
+		for (int& state : m_survivors) {
+			state = previous_states[state];
+			converged = converged && state == m_survivors[0];
+		}
+		if (converged) {
+			// all the paths go through the same state at step - 1
+			m_committed = step;
+			break;
+		}
 	}
 
-	//print_path_matrix();
+	if (m_steps - m_committed > static_cast<size_t>(m_max_lag)) {
+		m_committed = m_steps - m_max_lag;
+	}
 }
 
-int OnLineViterbiSearch::most_probable_final() const {
-	auto it_to_max = std::max_element(m_paths[m_current_step].begin(), m_paths[m_current_step].end());
-	int index_of_max= std::distance(m_paths[m_current_step].begin(), it_to_max);
-	return index_of_max;
+const std::vector<int>& OnLineViterbiSearch::sequence() const {
+	return m_sequence;
+}
+
+size_t OnLineViterbiSearch::first_changed() const {
+	return m_first_changed;
+}
+
+size_t OnLineViterbiSearch::committed() const {
+	return m_committed;
 }
 
 std::vector<int> OnLineViterbiSearch::best_sequence() const {
-	std::vector<int> best_sequence;
-	if (m_current_step == INVALID_STATE_INDEX) {
-		return best_sequence;
-	}
+	return m_sequence;
+}
 
-	int state = most_probable_final();
-	int step = m_current_step;
-	while (state != INVALID_STATE_INDEX) {
-		best_sequence.push_back(m_states[state]);
-		state = m_paths[step][state].previous_state;
-		--step;
+double OnLineViterbiSearch::log_prob() const {
+	if (m_steps == 0) {
+		return -std::numeric_limits<double>::infinity();
 	}
-	std::reverse(best_sequence.begin(), best_sequence.end());
-	return best_sequence;
+	return m_log_probs[most_probable_final()];
 }
@@ -9,6 +9,7 @@
 #define SRC_SLEEP_STAGING_ONLINEVITERBISEARCH_H_
 
 #include <vector>
+#include <cstdint>
 #include <dlib/matrix.h>
 #include <limits>
 #include <utility>
@@ -19,31 +20,22 @@
  * used for smoothing the hypnogram as a post-processing stage of the online
  * staging algorithm.
  *
- * Each call to the step method results in returning the most probable sequence
- * of sleep stages up to this point.
+ * After each call to the step method the most probable sequence of sleep
+ * stages up to this point is available from sequence(). Only the scores of
+ * the current step and the back pointers of the uncommitted tail are kept:
+ * once the survivor paths of all the states converge, the stages before
+ * that point can't change anymore and are committed. If they don't converge
+ * within max_lag steps, the oldest stage of the best path is committed anyway,
+ * so the work per step is O(states^2 + max_lag) regardless of the night length.
  *
  * Calling the stop method causes to take the probabilities of the final state
  * into account
  */ 
 class OnLineViterbiSearch {
 
-struct PathElement {
-	double log_prob;
-	int previous_state;
-	int state;
-
-	PathElement() {
-		state = -1;
-		previous_state = -1;
-		log_prob = -std::numeric_limits<double>::infinity();
-	}
-
-	bool operator < (const PathElement& other) const {
-		return log_prob < other.log_prob;
-	}
-};
-
 public:
+	static const int DEFAULT_MAX_LAG = 256;
+
 /**
  * The constructor.
  *
@@ -61,34 +53,80 @@ public:
  than the transition matrix, thus making the hypnogram more 'dynamic'. Values
  greater than 1 make the transition matrix more and more important thus making
  the hypnogram look more smooth.
+ * @param max_lag : the maximal number of the most recent steps which can still
+ be changed by the following ones.
  */ 
 	OnLineViterbiSearch(const std::vector<int>& states, const dlib::matrix<double>& start_probabilities,
 				  const dlib::matrix<double>& final_probabilities, const dlib::matrix<double> transition_matrix,
-				  double viterbi_weight = 1
+				  double viterbi_weight = 1, int max_lag = DEFAULT_MAX_LAG
 				  );
 
 	void step(const dlib::matrix<double>& emission_probabilities);
 	void stop();
 
+	/**
+	 * The most probable sequence of states up to the last step
+	 */
+	const std::vector<int>& sequence() const;
+
+	/**
+	 * The index of the first element of sequence() changed by the last call
+	 * to step or stop, i.e. the elements before it stayed the same.
+	 */
+	size_t first_changed() const;
+
+	/**
+	 * The number of elements at the beginning of sequence() which won't change anymore
+	 */
+	size_t committed() const;
+
+	/**
+	 * Same as sequence(), returns a copy
+	 */
 	std::vector<int> best_sequence() const;
-	double log_prob();
+
+	/**
+	 * The log probability of the most probable sequence
+	 */
+	double log_prob() const;
 
 private:
-	std::pair<int, double> find_path_leading_here(int next_state) const;
 	int most_probable_final() const;
-	void appendNewStep();
-	void print_path_matrix() const; //for debug only
+	uint8_t* backpointers(size_t step);
+	const uint8_t* backpointers(size_t step) const;
+	void update_sequence();
+	void commit();
 
-	std::vector<std::vector<PathElement>> m_paths;
-	int m_current_step;
-	double m_viterbi_weight;
+	size_t m_steps;
+	size_t m_committed;
+	size_t m_first_changed;
+	int m_max_lag;
+
+	// the log probabilities of the best paths ending in each of the states
+	std::vector<double> m_log_probs;
+	std::vector<double> m_next_log_probs;
+	std::vector<double> m_log_emissions;
+
+	// the logarithms of the weighted transition matrix, row-major,
+	// and of the start and final probabilities
+	std::vector<double> m_log_transitions;
+	std::vector<double> m_log_start_p;
+	std::vector<double> m_log_final_p;
+
+	// ring buffer with the back pointers of the uncommitted steps,
+	// one byte per state and step
+	std::vector<uint8_t> m_backpointers;
+
+	// the states on the survivor paths, followed backwards when committing
+	std::vector<int> m_survivors;
+
+	std::vector<int> m_sequence;
 
 	std::vector<int> m_states;
 	dlib::matrix<double> m_start_p;
 	dlib::matrix<double> m_final_p;
 	dlib::matrix<double> m_transition_matrix;
-
-	const int INVALID_STATE_INDEX = -1;
+	double m_viterbi_weight;
 };
 
 #endif /* SRC_SLEEP_STAGING_ONLINEVITERBISEARCH_H_ */
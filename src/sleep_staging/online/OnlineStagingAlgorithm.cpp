@@ -12,15 +12,24 @@
 #include <cassert>
 #include "dlib_utils.h"
 #include "logger.h"
+#include "Config.h"
 #include <iostream>
 
-OnlineStagingAlgorithm::OnlineStagingAlgorithm(const std::vector<OnlineStagingAlgorithm::sink_t*> & sinks)
+OnlineStagingAlgorithm::OnlineStagingAlgorithm(const std::vector<OnlineStagingAlgorithm::sink_t*> & sinks,
+											   bool progressive)
 : SinkStreamingAlgorithmSp<SleepStagingResult>(sinks)
+, m_model(progressive)
+, m_heart_rate(Config::instance().neuroon_ir_freq())
 {
 	m_last_eeg_index = 0;
 	m_last_ir_index = 0;
 
+	m_progressive = progressive;
+	m_last_eeg_window = 0;
+
 	m_first_timestamp = 0;
+	m_tracked_ir_samples = 0;
+	m_last_movement_totals = {0, 0, 0};
 }
 
 OnlineStagingAlgorithm::~OnlineStagingAlgorithm() {
@@ -29,24 +38,51 @@ OnlineStagingAlgorithm::~OnlineStagingAlgorithm() {
 
 void OnlineStagingAlgorithm::reset_state() {
 	m_model.reset();
+
+	// the deltas index the staging from the beginning of the night
+	m_timestamps.clear();
+	m_first_timestamp = 0;
+	m_last_eeg_window = 0;
+
+	m_heart_rate.reset();
+	m_tracked_ir_samples = 0;
+	m_heart_rates.clear();
+
+	m_last_movement_totals = {0, 0, 0};
+	m_movements.clear();
 }
 
 void OnlineStagingAlgorithm::process_input(const INeuroonSignals & input) {
+	track_heart_rate(input);
+
 	ullong eeg_sample_index = input.total_signal_samples(EEG);
 	ullong ir_sample_index = input.total_signal_samples(IR_LED);
 
-	if (m_last_eeg_index + EEG_INTERVAL > eeg_sample_index
-		&& m_last_ir_index + IR_INTERVAL > ir_sample_index) {
+	bool interval_passed = m_last_eeg_index + EEG_INTERVAL <= eeg_sample_index
+						   || m_last_ir_index + IR_INTERVAL <= ir_sample_index;
 
-		//nothing to be done yet -- not enough data
-		return;
+	int eeg_window = EEG_WINDOW;
+	int ir_window = IR_WINDOW;
+	if (input.eeg_signal().size() < EEG_WINDOW || input.ir_led_signal().size() < IR_WINDOW) {
+		eeg_window = m_progressive ? warm_up_eeg_window(input) : 0;
+		if (eeg_window == 0) {
+			return;
+		}
+		ir_window = eeg_window * IR_WINDOW / EEG_WINDOW;
+
+		// during the warm-up a longer window is used as soon as it's available
+		interval_passed = interval_passed || eeg_window > m_last_eeg_window;
 	}
 
-	if (input.eeg_signal().size() < EEG_WINDOW || input.ir_led_signal().size() < IR_WINDOW) {
+	if (!interval_passed) {
+		//nothing to be done yet -- not enough data
 		return;
 	}
+	m_last_eeg_window = eeg_window;
 
 	m_timestamps.push_back(input.last_timestamp(EEG));
+	m_heart_rates.push_back(m_heart_rate.heart_rate());
+	m_movements.push_back(describe_movement(input));
 
 	LOG(INFO) << "computing the online staging...";
 
@@ -60,25 +96,81 @@ void OnlineStagingAlgorithm::process_input(const INeuroonSignals & input) {
 	ullong current_ts = input.last_timestamp(EEG);
 	int seconds_since_start = static_cast<int> (current_ts - m_first_timestamp);
 	LOG(INFO) << "seconds since start: " << seconds_since_start << ", first ts: " << m_first_timestamp << ", current_ts: " << current_ts;
-	dlib::matrix<double> eeg_signal = range_to_dlib_matrix(input.eeg_signal().end() - EEG_WINDOW, input.eeg_signal().end());
-	dlib::matrix<double> ir_signal = range_to_dlib_matrix(input.ir_led_signal().end() - IR_WINDOW, input.ir_led_signal().end());
+	dlib::matrix<double> eeg_signal = range_to_dlib_matrix(input.eeg_signal().end() - eeg_window, input.eeg_signal().end());
+	dlib::matrix<double> ir_signal = range_to_dlib_matrix(input.ir_led_signal().end() - ir_window, input.ir_led_signal().end());
 
 	assert(eeg_signal.nc() == 1);
 	assert(ir_signal.nc() == 1);
 
 
-	m_model.step(eeg_signal, ir_signal, seconds_since_start);
-	std::vector<int> staging_from_model = m_model.current_staging();
-	SleepStagingResult result(staging_from_model, m_model.current_quality(), m_model.current_brain_waves() ,m_timestamps);
+	if (m_movements.back().gross_movement) {
+		LOG(INFO) << "gross movement, skipping the EEG analysis";
+		m_model.skip_step(seconds_since_start);
+	} else {
+		m_model.step(eeg_signal, ir_signal, seconds_since_start);
+	}
 
 	LOG(INFO) << "computed! feeding the sinks...";
-	feed_all_sinks(std::make_shared<SleepStagingResult>(result));
+	feed_all_sinks(make_result());
+}
+
+/*
+ * The longest power-of-2 EEG window (and the corresponding IR window)
+ * available in the signals, 0 if even the shortest one isn't.
+ */
+int OnlineStagingAlgorithm::warm_up_eeg_window(const INeuroonSignals & input) const {
+	int result = 0;
+	for (int window = MIN_WARM_UP_EEG_WINDOW; window < EEG_WINDOW; window *= 2) {
+		int ir_window = window * IR_WINDOW / EEG_WINDOW;
+		if (window > input.eeg_signal().size() || ir_window > input.ir_led_signal().size()) {
+			break;
+		}
+		result = window;
+	}
+	return result;
+}
+
+/*
+ * Feeds the IR samples which arrived since the last call to the heart rate tracker
+ */
+void OnlineStagingAlgorithm::track_heart_rate(const INeuroonSignals & input) {
+	const std::vector<double>& ir = input.ir_led_signal();
+	std::size_t total_samples = input.total_signal_samples(IR_LED);
+	std::size_t new_samples = std::min<std::size_t>(total_samples - std::min(m_tracked_ir_samples, total_samples), ir.size());
+	m_tracked_ir_samples = total_samples;
+
+	for (auto it = ir.end() - new_samples; it != ir.end(); ++it) {
+		m_heart_rate.consume(*it);
+	}
+}
+
+/*
+ * The movement since the previous step
+ */
+ncMovementDescription OnlineStagingAlgorithm::describe_movement(const INeuroonSignals & input) {
+	const Actigraphy::Totals& totals = input.movement_totals();
+	// the totals start over when the signals are reset
+	if (totals.samples < m_last_movement_totals.samples) {
+		m_last_movement_totals = {0, 0, 0};
+	}
+
+	ncMovementDescription movement;
+	movement.activity = Actigraphy::activity_between(m_last_movement_totals, totals);
+	movement.posture_changes = static_cast<int>(totals.posture_changes - m_last_movement_totals.posture_changes);
+	movement.gross_movement = movement.activity > GROSS_MOVEMENT_ACTIVITY
+							  || (movement.posture_changes > 0 && movement.activity > POSTURE_CHANGE_ACTIVITY);
+
+	m_last_movement_totals = totals;
+	return movement;
+}
+
+std::shared_ptr<SleepStagingResult> OnlineStagingAlgorithm::make_result() const {
+	return std::make_shared<SleepStagingResult>(m_model.current_staging(), m_model.current_quality(),
+			m_model.current_brain_waves(), m_timestamps, m_heart_rates, m_movements,
+			m_model.staging_first_changed(), m_model.staging_committed());
 }
 
 void OnlineStagingAlgorithm::end_streaming(const INeuroonSignals & input) {
 	m_model.stop();
-	std::vector<int> staging_from_model = m_model.current_staging();
-	SleepStagingResult result(staging_from_model, m_model.current_quality(),
-			m_model.current_brain_waves(), m_timestamps);
-	feed_all_sinks(std::make_shared<SleepStagingResult>(result));
+	feed_all_sinks(make_result());
 }
@@ -10,7 +10,10 @@
 
 #include "StreamingAlgorithm.h"
 #include "OnlineStagingClassifier.h"
+#include "StreamingHeartRate.h"
+#include "Actigraphy.h"
 #include "CommonTypes.h"
+#include <algorithm>
 #include <vector>
 #include <stdexcept>
 
@@ -18,26 +21,55 @@
 
 /**
  * Represents the results of the sleep staging algorithm. The objects of this
- * class are returned in the sinks of the online staging algorithm
+ * class are returned in the sinks of the online staging algorithm.
+ *
+ * Each result is a delta: it holds only the elements of the staging starting
+ * from m_first_index, i.e. the ones appended or revised by the last step,
+ * the elements before it are the same as in the previous result.
+ * Use apply_to to keep the whole staging.
  */
 class SleepStagingResult {
 public:
 	SleepStagingResult() {}
 
+	/**
+	 * @param first_index : the index of the first element that changed
+	 * @param committed : the number of elements at the beginning of the staging which won't change anymore
+	 */
 	SleepStagingResult(const std::vector<int> &stages, const std::vector<int> &quality,
-			const std::vector<ncBrainWaveLevels> &brain_waves, const std::vector<ullong> &timestamps) {
-
-		m_stages.resize(stages.size());
-
-		for (int i = 0; i != stages.size(); ++i) {
-			m_stages[i].stage = static_cast<ncSleepStage>(stages[i]);
-			m_stages[i].timestamp = timestamps[i];
-			m_stages[i].signal_quality = static_cast<ncSignalQuality> (quality[i]);
-			m_stages[i].brain_waves = brain_waves[i];
+			const std::vector<ncBrainWaveLevels> &brain_waves, const std::vector<ullong> &timestamps,
+			const std::vector<double> &heart_rates, const std::vector<ncMovementDescription> &movements,
+			std::size_t first_index = 0, std::size_t committed = 0)
+	: m_first_index(std::min(first_index, stages.size()))
+	, m_total_size(stages.size())
+	, m_committed(committed) {
+
+		m_stages.resize(m_total_size - m_first_index);
+
+		for (std::size_t i = m_first_index; i != stages.size(); ++i) {
+			ncStagingElement& element = m_stages[i - m_first_index];
+			element.stage = static_cast<ncSleepStage>(stages[i]);
+			element.timestamp = timestamps[i];
+			element.signal_quality = static_cast<ncSignalQuality> (quality[i]);
+			element.brain_waves = brain_waves[i];
+			element.heart_rate = heart_rates[i];
+			element.movement = movements[i];
 		}
 	}
 
+	/**
+	 * Updates the whole staging kept by the receiver with this delta
+	 */
+	void apply_to(std::vector<ncStagingElement> &staging) const {
+		staging.resize(m_total_size);
+		std::copy(m_stages.begin(), m_stages.end(), staging.begin() + m_first_index);
+	}
+
+	// the changed elements, i.e. the elements [m_first_index, m_total_size) of the staging
 	std::vector<ncStagingElement> m_stages;
+	std::size_t m_first_index = 0;
+	std::size_t m_total_size = 0;
+	std::size_t m_committed = 0;
 };
 
 /**
@@ -46,16 +78,36 @@ public:
  */
 class OnlineStagingAlgorithm : public SinkStreamingAlgorithmSp<SleepStagingResult> {
 
-	const int EEG_WINDOW = 2048 * 5;
-	const int IR_WINDOW = EEG_WINDOW / 5;
+	const int EEG_WINDOW = OnlineStagingClassifier::FULL_EEG_WINDOW;
+	const int IR_WINDOW = OnlineStagingClassifier::FULL_IR_WINDOW;
 
 	const int EEG_INTERVAL = EEG_WINDOW / 4;
 	const int IR_INTERVAL = IR_WINDOW / 4;
+
+	// the shortest EEG window used during the progressive warm-up, ~8 s
+	const int MIN_WARM_UP_EEG_WINDOW = 1024;
+
+	// the activity (in g) above which the EEG of a step is skipped, as it
+	// would be dominated by the movement artifacts anyway
+	const double GROSS_MOVEMENT_ACTIVITY = 0.05;
+
+	// the activity above which a step with a posture change is skipped too:
+	// turning over takes only a few seconds of the step, so its mean activity
+	// is lower, while a slow drift of the head position is no gross movement
+	const double POSTURE_CHANGE_ACTIVITY = GROSS_MOVEMENT_ACTIVITY / 2;
 public:
 
   using sink_t = IDataSinkSp<SleepStagingResult>;
 
-	OnlineStagingAlgorithm(const std::vector<sink_t*> & sinks);
+	/**
+	 * @param progressive : if true, the staging starts as soon as
+	 * MIN_WARM_UP_EEG_WINDOW samples are available. Until the full windows are
+	 * available, the steps use the longest power-of-2 windows which fit in the
+	 * data, and a step is made also whenever the window grows, so there are
+	 * only a few extra (and short) FFTs during the warm-up. Otherwise nothing is
+	 * computed until the full windows are available.
+	 */
+	OnlineStagingAlgorithm(const std::vector<sink_t*> & sinks, bool progressive = false);
 	virtual ~OnlineStagingAlgorithm();
 
 	virtual void reset_state() override;
@@ -63,13 +115,32 @@ public:
 	virtual void end_streaming(const INeuroonSignals & input) override;
 
 private:
+	std::shared_ptr<SleepStagingResult> make_result() const;
+	int warm_up_eeg_window(const INeuroonSignals & input) const;
+	void track_heart_rate(const INeuroonSignals & input);
+	ncMovementDescription describe_movement(const INeuroonSignals & input);
+
 	OnlineStagingClassifier m_model;
 
 	int m_last_eeg_index;
 	int m_last_ir_index;
 
+	bool m_progressive;
+	int m_last_eeg_window;
+
 	ullong m_first_timestamp;
 	std::vector<ullong> m_timestamps;
+
+	// the heart rate is tracked on every IR sample, and its value
+	// is remembered at each step of the staging
+	StreamingHeartRate m_heart_rate;
+	std::size_t m_tracked_ir_samples;
+	std::vector<double> m_heart_rates;
+
+	// the movement totals at the previous step, the movement of a step
+	// is the difference from them
+	Actigraphy::Totals m_last_movement_totals;
+	std::vector<ncMovementDescription> m_movements;
 };
 
 #endif /* SRC_SLEEP_STAGING_ONLINESTAGINGALGORITHM_H_ */
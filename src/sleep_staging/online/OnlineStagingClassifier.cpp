@@ -6,43 +6,34 @@
  */
 
 #include "OnlineStagingClassifier.h"
+#include <algorithm>
+#include <cmath>
 #include <vector>
 #include "dlib_utils.h"
 #include "logger.h"
 #include "MlpClassifier.h"
 #include "OnLineViterbiSearch.h"
-#include "ModelOnline.h"
-#include "ModelOnlineW1.h"
-#include "ModelOnlineW2.h"
+#include "ModelRegistry.h"
 #include "Config.h"
 #include "BrainWaveLevels.h"
 #include "EegSignalQuality.h"
+#include "Spectrogram.h"
 
-OnlineStagingClassifier::OnlineStagingClassifier() {
+OnlineStagingClassifier::OnlineStagingClassifier(bool progressive)
+: m_model(ModelRegistry::instance().online_model())
+, m_preprocessor(progressive)
+{
+	m_model->check_feature_config(ModelRegistry::ONLINE_FEATURE_CONFIG);
 
-	dlib::matrix<int> c = online_model::Classes;
-	m_classes = dlib_matrix_to_vector<int>(dlib::trans(c));
+	const StagingModel::Array& classes = m_model->get("classes");
+	m_classes.assign(classes.ints(), classes.ints() + classes.rows * classes.cols);
 
 	initialize_mlp();
 	initialize_viterbi(m_classes);
 }
 
 void OnlineStagingClassifier::initialize_mlp() {
-	std::vector<dlib::matrix<double>> weights(2);
-	std::vector<dlib::matrix<double>> intercepts(2);
-
-	// std::string W1_MATRIX_FILENAME(ONLINE_MODEL_RES_DIRECTORY "/w1.csv");
-	// std::string W2_MATRIX_FILENAME(ONLINE_MODEL_RES_DIRECTORY "/w2.csv");
-	// std::string I1_MATRIX_FILENAME(ONLINE_MODEL_RES_DIRECTORY "/i1.csv");
-	// std::string I2_MATRIX_FILENAME(ONLINE_MODEL_RES_DIRECTORY "/i2.csv");
-
-	weights[0] = online_model::W1;
-	weights[1] = online_model::W2;
-
-	intercepts[0] = online_model::I1;
-	intercepts[1] = online_model::I2;
-
-	m_mlp = new MlpClassifier(weights, intercepts);
+	m_mlp = new MlpClassifier(m_model);
 }
 
 void OnlineStagingClassifier::initialize_viterbi(const std::vector<int> classes) {
@@ -54,8 +45,7 @@ void OnlineStagingClassifier::initialize_viterbi(const std::vector<int> classes)
 	dlib::set_all_elements(final_p, 0);
 	final_p(3, 0) = 1;
 
-	// dlib::matrix<double> transition_matrix = load_matrix(ONLINE_MODEL_RES_DIRECTORY "/transitions.csv");
-	dlib::matrix<double> transition_matrix = online_model::Transitions;
+	dlib::matrix<double> transition_matrix = m_model->matrix("transitions");
   // LOG(INFO) << transition_matrix;
 	assert(transition_matrix.nc() != 0);
 	assert(transition_matrix.nr() != 0);
@@ -64,7 +54,7 @@ void OnlineStagingClassifier::initialize_viterbi(const std::vector<int> classes)
 	m_viterbi = new OnLineViterbiSearch(classes, start_p, final_p, transition_matrix, VITERBI_WEIGHT);
 }
 
-std::vector<int> OnlineStagingClassifier::predict(const dlib::matrix<double> &features) {
+const std::vector<int>& OnlineStagingClassifier::predict(const dlib::matrix<double> &features) {
 	dlib::matrix<double> probabilities;
 	LOG(INFO) << "features: " << features;
 	if (dlib::is_finite(features)) {
@@ -75,9 +65,18 @@ std::vector<int> OnlineStagingClassifier::predict(const dlib::matrix<double> &fe
 		probabilities = get_probability_when_nan(beginning);
 	}
 	m_viterbi->step(dlib::trans(probabilities));
-	auto result = m_viterbi->best_sequence();
-	LOG(INFO) << "staging length: " << result.size();
-	return result;
+	update_staging();
+	LOG(INFO) << "staging length: " << m_current_staging.size();
+	return m_current_staging;
+}
+
+void OnlineStagingClassifier::update_staging() {
+	// only the suffix changed by the last Viterbi step is copied
+	const std::vector<int>& sequence = m_viterbi->sequence();
+	size_t first_changed = std::min(m_viterbi->first_changed(), m_current_staging.size());
+	m_current_staging.resize(sequence.size());
+	std::copy(sequence.begin() + first_changed, sequence.end(), m_current_staging.begin() + first_changed);
+	m_staging_first_changed = first_changed;
 }
 
 dlib::matrix<double> OnlineStagingClassifier::get_probability_when_nan(bool beginning) {
@@ -99,13 +98,15 @@ OnlineStagingClassifier::~OnlineStagingClassifier() {
 
 void OnlineStagingClassifier::stop() {
 	m_viterbi->stop();
-	m_current_staging = m_viterbi->best_sequence();
+	update_staging();
 }
 
 void OnlineStagingClassifier::reset() {
 	delete m_viterbi;
 	m_current_quality.clear();
 	m_current_staging.clear();
+	m_current_brain_waves.clear();
+	m_staging_first_changed = 0;
 	initialize_viterbi(m_classes);
 }
 
@@ -113,7 +114,7 @@ void OnlineStagingClassifier::compute_staging(const Spectrogram& eeg_spectrogram
 											  double seconds_since_start) {
 
 	auto preprocessed = m_preprocessor.transform(eeg_spectrogram, ir_spectrogram, seconds_since_start);
-	m_current_staging = predict(preprocessed.features);
+	predict(preprocessed.features);
 }
 
 void OnlineStagingClassifier::compute_quality(const Spectrogram& eeg_spectrogram) {
@@ -133,23 +134,45 @@ void OnlineStagingClassifier::step(const dlib::matrix<double> eeg_signal,
 											  double seconds_since_start) {
 
 	const int overlap = 0;
-	const int EEG_FFT_WINDOW = 10 * 1024;
-	//const int EEG_FFT_OVERLAP = (EEG_FFT_WINDOW * 3) / 4;
-	const int IR_FFT_WINDOW = 2048;
-	//const int IR_FFT_OVERLAP = (2048 *3) / 4;
 
-	Spectrogram eeg_spectrogram(eeg_signal, Config::instance().neuroon_eeg_freq(), EEG_FFT_WINDOW, overlap);
-	Spectrogram ir_spectrogram(ir_signal, Config::instance().neuroon_ir_freq(), IR_FFT_WINDOW, overlap);
+	// the whole windows passed are transformed. The magnitude spectrum of
+	// a noise-like signal such as EEG grows with the square root of the FFT length,
+	// so the shorter warm-up windows are scaled up to the level of the full one.
+	dlib::matrix<double> eeg = eeg_signal;
+	if (eeg_signal.nr() < FULL_EEG_WINDOW) {
+		eeg *= noise_magnitude_scale(eeg_signal.nr(), FULL_EEG_WINDOW);
+	}
+
+	Spectrogram eeg_spectrogram(eeg, Config::instance().neuroon_eeg_freq(), eeg.nr(), overlap);
+	Spectrogram ir_spectrogram(ir_signal, Config::instance().neuroon_ir_freq(), ir_signal.nr(), overlap);
 
 	compute_quality(eeg_spectrogram);
 	compute_staging(eeg_spectrogram, ir_spectrogram, seconds_since_start);
 	compute_brain_waves(eeg_spectrogram);
 }
 
+void OnlineStagingClassifier::skip_step(double seconds_since_start) {
+	auto preprocessed = m_preprocessor.transform_rejected(seconds_since_start);
+	predict(preprocessed.features);
+
+	m_current_quality.push_back(NO_SIGNAL);
+	ncBrainWaveLevels levels;
+	levels.alpha = levels.beta = levels.delta = levels.theta = NAN;
+	m_current_brain_waves.push_back(levels);
+}
+
 const std::vector<int>& OnlineStagingClassifier::current_staging() const {
 	return m_current_staging;
 }
 
+std::size_t OnlineStagingClassifier::staging_first_changed() const {
+	return m_staging_first_changed;
+}
+
+std::size_t OnlineStagingClassifier::staging_committed() const {
+	return m_viterbi->committed();
+}
+
 const std::vector<int>& OnlineStagingClassifier::current_quality() const {
 	return m_current_quality;
 }
@@ -7,6 +7,7 @@
 
 #ifndef SRC_SLEEP_STAGING_ONLINESTAGINGCLASSIFIER_H_
 #define SRC_SLEEP_STAGING_ONLINESTAGINGCLASSIFIER_H_
+#include <memory>
 #include <vector>
 
 #include "OnlineStagingFeaturePreprocessor.h"
@@ -15,6 +16,7 @@
 
 class MlpClassifier;
 class OnLineViterbiSearch;
+class StagingModel;
 
 /**
  * Aggregates all tasks and logic for online processing of sleep
@@ -25,6 +27,8 @@ class OnLineViterbiSearch;
  */
 class OnlineStagingClassifier {
 
+	// shared by all the instances, see ModelRegistry
+	std::shared_ptr<const StagingModel> m_model;
 	MlpClassifier* m_mlp = nullptr;
 	OnLineViterbiSearch* m_viterbi = nullptr;
 	BrainWaveLevels m_bw;
@@ -38,27 +42,70 @@ class OnlineStagingClassifier {
 	dlib::matrix<double> get_probability_when_nan(bool beginning);
 
 	std::vector<int> m_current_staging;
+	std::size_t m_staging_first_changed = 0;
 	std::vector<int> m_current_quality;
 	std::vector<ncBrainWaveLevels> m_current_brain_waves;
 
+	void update_staging();
 	void compute_quality(const Spectrogram& eeg_spectrogram);
 	void compute_staging(const Spectrogram& eeg_spectrogram, const Spectrogram &ir_spectrogram, double seconds_since_start);
 	void compute_brain_waves(const Spectrogram& eeg_spectrogram);
 
 
 public:
-	OnlineStagingClassifier();
+	/**
+	 * @param progressive : see OnlineStagingFeaturePreprocessor
+	 */
+	OnlineStagingClassifier(bool progressive = false);
 	~OnlineStagingClassifier();
 
-	std::vector<int> predict(const dlib::matrix<double> &features);
-
+	/**
+	 * Adds a step to the staging, returns the whole staging so far
+	 */
+	const std::vector<int>& predict(const dlib::matrix<double> &features);
+
+	/**
+	 * Computes the next step from the last windows of the signals. The windows
+	 * are normally FULL_EEG_WINDOW and FULL_IR_WINDOW samples long, shorter
+	 * ones can be passed during the warm-up, at the beginning of the night.
+	 *
+	 * The EEG of a shorter window is scaled to the spectral level of the full
+	 * one (see noise_magnitude_scale), as the warm-up steps are included in the
+	 * whole-night means and deviations which standardize the features.
+	 * The IR features of a shorter window are NaN and don't enter the IR
+	 * statistics, so the warm-up steps are staged with the probabilities
+	 * used for the rejected features until a full IR window is available.
+	 */
 	void step(const dlib::matrix<double> eeg_signal,
 						  const dlib::matrix<double> ir_signal,
 						  double seconds_since_start);
+
+	/**
+	 * Adds a step without analyzing the signals, e.g. during a gross movement,
+	 * when the EEG would be rejected by the amplitude filter anyway. The step
+	 * passes through the preprocessor as a rejected row, the stage is estimated
+	 * as for the rejected features, the quality is NO_SIGNAL and the brain wave
+	 * levels are NaN.
+	 */
+	void skip_step(double seconds_since_start);
+
+	static const int FULL_EEG_WINDOW = 10 * 1024;
+	static const int FULL_IR_WINDOW = 2048;
 	void stop();
 	void reset();
 
 	const std::vector<int>& current_staging() const;
+
+	/**
+	 * The index of the first element of the staging changed by the last step
+	 */
+	std::size_t staging_first_changed() const;
+
+	/**
+	 * The number of elements at the beginning of the staging which won't change anymore
+	 */
+	std::size_t staging_committed() const;
+
 	const std::vector<int>& current_quality() const;
 	const std::vector<ncBrainWaveLevels>& current_brain_waves() const;
 
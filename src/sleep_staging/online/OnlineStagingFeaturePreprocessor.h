@@ -13,18 +13,21 @@
 #include "ExpandingStd.h"
 #include "RollingMean.h"
 #include "Spectrogram.h"
+#include "EegBandFeatures.h"
 #include <tuple>
 
 /**
  * Performs feature extraction for the online staging algorithm
  */
 class OnlineStagingFeaturePreprocessor {
-
+public:
   /**
    * The total number of features. To be updated manually. Has to agree with
    * the number of input neurons of the MLP classifier
    */
-    const int NUMBER_OF_FEATURES = 22;
+    static const int NUMBER_OF_FEATURES = 22;
+
+private:
 
     /**
      * Computes the EEG features, i.e. the sums of amplitudes 
@@ -37,24 +40,6 @@ class OnlineStagingFeaturePreprocessor {
      */ 
     dlib::matrix<double> compute_ir_features(const dlib::matrix<double>& ir_signal);
     
-    /**
-     * Private helper class for computing EEG features. Can be refactored to 
-     * a separate file if grows too large.
-     */
-    class EegSumsFeatures {
-		const int EEG_FFT_WINDOW = 10 * 1024;
-		const int EEG_FFT_OVERLAP = (EEG_FFT_WINDOW * 3) / 4;
-
-    	const int NUMBER_OF_EEG_FEATURES = 20;
-    	ExpandingMean m_mean;
-    	RollingMean m_rolling;
-    	dlib::matrix<double> m_feature_stds;
-    public:
-    	EegSumsFeatures();
-    	void reset();
-    	dlib::matrix<double> transform(const Spectrogram& eeg_spectrogram);
-    };
-
     /**
      * Private helper class for computing IR LED features. Can be refactored
      * to a separate file if grows too large.
@@ -68,17 +53,29 @@ class OnlineStagingFeaturePreprocessor {
     	RollingMean m_rolling;
 
     public:
-    	IrFeatures();
+    	IrFeatures(bool partial_window);
       virtual ~IrFeatures(){}
     	void reset();
     	dlib::matrix<double> transform(const Spectrogram& ir_spectrogram);
+    	dlib::matrix<double> transform_rejected();
     };
 
-    EegSumsFeatures m_eeg_features;
+    /**
+     * Sets the feature computed from the time since the beginning of sleep
+     */
+    void set_time_feature(dlib::matrix<double>& features, double seconds_since_start);
+
+    EegBandFeatures m_eeg_features;
     IrFeatures m_ir_features;
 
 public:
-	OnlineStagingFeaturePreprocessor();
+	/**
+	 * @param progressive : if true, the rolling means use the available steps
+	 * until their windows are filled, so the EEG features are defined from the
+	 * first step. The IR feature is NaN while the IR spectrogram is shorter than
+	 * the full IR window, and the warm-up steps don't enter its statistics.
+	 */
+	OnlineStagingFeaturePreprocessor(bool progressive = false);
 
     struct preprocessing_result_t {
     	dlib::matrix<double> features;
@@ -104,6 +101,14 @@ public:
      */
 	preprocessing_result_t transform(const Spectrogram& eeg_spectrogram, const Spectrogram& ir_spectrogram,
 								   double seconds_since_start);
+
+    /**
+     * Adds a step whose signals weren't analyzed, e.g. during a gross movement,
+     * as a rejected row: the EEG and IR features are NaN, and the rolling
+     * and the expanding state advance by the step as they would for any NaN
+     * in the signals, so the following steps stay aligned.
+     */
+	preprocessing_result_t transform_rejected(double seconds_since_start);
 };
 
 #endif /* SRC_SLEEP_STAGING_ONLINESTAGINGFEATUREPREPROCESSOR_H_ */
@@ -0,0 +1,93 @@
+/*
+ * StreamingHeartRate.cpp
+ */
+
+#include "StreamingHeartRate.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+	const double SECONDS_IN_A_MINUTE = 60;
+
+	// the part of the pulse amplitude the signal has to fall below
+	// before the next upward crossing counts as a beat
+	const double HYSTERESIS = 0.3;
+
+	// the time constant of the pulse amplitude, in seconds
+	const double AMPLITUDE_TIME = 2;
+}
+
+constexpr double StreamingHeartRate::MIN_BPM;
+constexpr double StreamingHeartRate::MAX_BPM;
+const int StreamingHeartRate::BEATS_REMEMBERED;
+const int StreamingHeartRate::MIN_BEATS;
+
+StreamingHeartRate::StreamingHeartRate(double fs)
+: m_fs(fs)
+, m_high_pass(Biquad::high_pass(fs, MIN_BPM / SECONDS_IN_A_MINUTE))
+, m_low_pass(Biquad::low_pass(fs, std::min(MAX_BPM / SECONDS_IN_A_MINUTE, 0.45 * fs)))
+, m_amplitude_decay(1. / (AMPLITUDE_TIME * fs))
+, m_intervals(BEATS_REMEMBERED)
+{
+	reset();
+}
+
+void StreamingHeartRate::reset() {
+	m_high_pass.reset();
+	m_low_pass.reset();
+	m_offset = NAN;
+	m_samples = 0;
+	m_previous = 0;
+	m_amplitude = 0;
+	m_armed = false;
+	m_last_beat = -1;
+	m_next_interval = 0;
+	m_intervals_size = 0;
+	m_heart_rate = 0;
+}
+
+void StreamingHeartRate::consume(double sample) {
+	if (std::isnan(m_offset)) {
+		m_offset = sample;
+	}
+	double value = m_low_pass.filter(m_high_pass.filter(sample - m_offset));
+	m_amplitude += m_amplitude_decay * (std::abs(value) - m_amplitude);
+
+	if (value < -HYSTERESIS * m_amplitude) {
+		m_armed = true;
+	} else if (m_armed && m_previous < 0 && value >= 0) {
+		// the crossing between the previous and the current sample
+		beat(m_samples - 1 + m_previous / (m_previous - value));
+		m_armed = false;
+	}
+
+	m_previous = value;
+	++m_samples;
+}
+
+void StreamingHeartRate::beat(double time) {
+	double interval = time - m_last_beat;
+	bool first = m_last_beat < 0;
+	m_last_beat = time;
+
+	// the intervals out of the range come from the artifacts or the missed beats
+	double bpm = SECONDS_IN_A_MINUTE * m_fs / interval;
+	if (first || bpm < MIN_BPM || bpm > MAX_BPM) {
+		return;
+	}
+
+	m_intervals[m_next_interval] = interval;
+	m_next_interval = (m_next_interval + 1) % BEATS_REMEMBERED;
+	m_intervals_size = std::min(m_intervals_size + 1, BEATS_REMEMBERED);
+	if (m_intervals_size < MIN_BEATS) {
+		return;
+	}
+
+	double sorted[BEATS_REMEMBERED];
+	std::copy(m_intervals.begin(), m_intervals.begin() + m_intervals_size, sorted);
+	std::sort(sorted, sorted + m_intervals_size);
+	int middle = m_intervals_size / 2;
+	double median = m_intervals_size % 2 ? sorted[middle] : (sorted[middle - 1] + sorted[middle]) / 2;
+
+	m_heart_rate = SECONDS_IN_A_MINUTE * m_fs / median;
+}
@@ -0,0 +1,74 @@
+/*
+ * StreamingHeartRate.h
+ */
+
+#ifndef SRC_SLEEP_STAGING_ONLINE_STREAMINGHEARTRATE_H_
+#define SRC_SLEEP_STAGING_ONLINE_STREAMINGHEARTRATE_H_
+
+#include <vector>
+#include "Biquad.h"
+
+/**
+ * Tracks the subject's heart rate in the IR LED signal, sample by sample.
+ *
+ * The signal is band-passed to the range of the possible heart rates and
+ * the beats are found as the upward zero crossings of the filtered signal,
+ * with a hysteresis relative to the amplitude of the pulse, so the noise
+ * around zero doesn't produce false beats. The times of the crossings are
+ * interpolated between the samples, and the heart rate is computed from the
+ * median of the last BEATS_REMEMBERED beat-to-beat intervals.
+ *
+ * Unlike SpectrogramHeartRate, which is limited by the resolution of the
+ * spectrogram (about 12 BPM for 128 samples at 25 Hz), each sample costs O(1).
+ */
+class StreamingHeartRate {
+public:
+	// the range of the heart rates which are tracked
+	static constexpr double MIN_BPM = 30;
+	static constexpr double MAX_BPM = 210;
+
+	static const int BEATS_REMEMBERED = 8;
+	static const int MIN_BEATS = 3;
+
+	/**
+	 * @param fs : the sampling frequency of the IR LED signal
+	 */
+	StreamingHeartRate(double fs);
+
+	void consume(double sample);
+
+	/**
+	 * @return the heart rate in beats per minute,
+	 * 0 until MIN_BEATS beat-to-beat intervals are found
+	 */
+	double heart_rate() const {
+		return m_heart_rate;
+	}
+
+	void reset();
+
+private:
+	void beat(double time);
+
+	double m_fs;
+	// the band-pass, a high-pass followed by a low-pass
+	Biquad m_high_pass;
+	Biquad m_low_pass;
+	double m_amplitude_decay;
+
+	// subtracted from the signal, so the filters don't ring after the first sample
+	double m_offset;
+	long m_samples;
+	double m_previous;
+	double m_amplitude;
+	bool m_armed;
+	double m_last_beat;
+
+	// the last beat-to-beat intervals in samples, a ring
+	std::vector<double> m_intervals;
+	int m_next_interval;
+	int m_intervals_size;
+	double m_heart_rate;
+};
+
+#endif /* SRC_SLEEP_STAGING_ONLINE_STREAMINGHEARTRATE_H_ */
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include <dlib/matrix.h>
+#include "functional_tests_data.h"
+#include "EegSignalQuality.h"
+#include "StreamingEegQuality.h"
+#include "Features.h"
+#include "Spectrogram.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+/*
+ * The streaming estimator follows the last second, while EegSignalQuality
+ * grades the whole staging window, so the running band power is averaged
+ * over that window before comparing
+ */
+TEST(EegQualityFunctional, streaming_quality_calibrated_against_eeg_signal_quality) {
+	const int FS = 125;
+	const int EEG_WINDOW = 10240;
+	const int STEP = EEG_WINDOW / 4;
+
+	dlib::matrix<double> eeg(get_eeg_data());
+	StreamingEegQuality streaming(FS);
+	EegSignalQuality reference;
+
+	std::vector<double> band_squares;
+	std::vector<double> differences;
+	int compared = 0;
+	int within_one_grade = 0;
+	for (long i = 0; i != eeg.nr(); ++i) {
+		streaming.consume(eeg(i, 0));
+		band_squares.push_back(streaming.band_rms() * streaming.band_rms());
+
+		if (i + 1 < EEG_WINDOW || (i + 1) % STEP != 0) {
+			continue;
+		}
+
+		dlib::matrix<double> window = dlib::rowm(eeg, dlib::range(i + 1 - EEG_WINDOW, i));
+		if (!dlib::is_finite(window)) {
+			continue;
+		}
+		Spectrogram spectrogram(window, FS, EEG_WINDOW);
+		double power = std::log(Features::sum_in_band(spectrogram, 10, 14)(0, 0));
+		int expected = reference.predict(spectrogram);
+
+		double mean_square = 0;
+		for (auto it = band_squares.end() - EEG_WINDOW; it != band_squares.end(); ++it) {
+			mean_square += *it;
+		}
+		mean_square /= EEG_WINDOW;
+		double offset = streaming.band_power() - std::log(streaming.band_rms());
+		double streaming_power = offset + 0.5 * std::log(mean_square);
+
+		differences.push_back(std::abs(streaming_power - power));
+		++compared;
+		// the grade of the mean power, with the borders of EegSignalQuality
+		std::vector<double> borders({19, 18, 17.25, 16.5});
+		int grade = std::find_if(borders.begin(), borders.end(),
+				[streaming_power](double border) { return streaming_power >= border; }) - borders.begin();
+		if (std::abs(grade - expected) <= 1) {
+			++within_one_grade;
+		}
+	}
+
+	ASSERT_GT(compared, 0);
+	std::nth_element(differences.begin(), differences.begin() + differences.size() / 2, differences.end());
+	double median_difference = differences[differences.size() / 2];
+	std::cout << "compared windows: " << compared << ", median power difference: " << median_difference
+			  << ", within one grade: " << within_one_grade << std::endl;
+
+	EXPECT_LT(median_difference, 0.5);
+	EXPECT_GE(within_one_grade, 0.9 * compared);
+}
@@ -7,18 +7,20 @@
 #include <iostream>
 #include <vector>
 struct test_sink : public OnlineStagingAlgorithm::sink_t {
-  std::shared_ptr<SleepStagingResult> m_last_staging;
+  std::vector<ncStagingElement> m_staging;
 
   void setDataSourceDelegate(SinkSetDelegateKey,
                              std::weak_ptr<IDataSourceDelegate>) override {}
   void consume(std::shared_ptr<SleepStagingResult> res) {
-    std::cout << "staging len: " << res->m_stages.size() << std::endl;
-    m_last_staging = res;
+    EXPECT_LE(res->m_first_index, m_staging.size());
+    EXPECT_LE(res->m_committed, res->m_total_size);
+    res->apply_to(m_staging);
+    std::cout << "staging len: " << m_staging.size() << ", changed: " << res->m_stages.size() << std::endl;
 
     std::ofstream out("./functional_test_results/online_stages_to_plot.csv");
 
-    for (int i = 0; i != res->m_stages.size(); ++i) {
-      out << res->m_stages[i].stage << std::endl;
+    for (int i = 0; i != m_staging.size(); ++i) {
+      out << m_staging[i].stage << std::endl;
     }
 
     out << std::endl;
@@ -101,8 +103,8 @@ TEST(OnlineStagingAlgorithmTest, basic_testcase) {
   }
   a.end_streaming(mock_signals);
 
-  for (int i = 0; i != s.m_last_staging->m_stages.size(); ++i) {
-    std::cout << s.m_last_staging->m_stages[i].stage << " ";
+  for (int i = 0; i != s.m_staging.size(); ++i) {
+    std::cout << s.m_staging[i].stage << " ";
   }
   std::cout << std::endl;
 }
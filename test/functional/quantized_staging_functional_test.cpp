@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include <dlib/matrix.h>
+#include <vector>
+#include "MlpClassifier.h"
+#include "StagingPreprocessor.h"
+#include "dlib_utils.h"
+
+#include "functional_tests_data.h"
+
+namespace {
+
+const double MINIMAL_STAGE_AGREEMENT = 0.98;
+
+void load_offline_model(std::vector<dlib::matrix<double>> &weights, std::vector<dlib::matrix<double>> &intercepts) {
+	weights.push_back(load_matrix(MODEL_RES_DIRECTORY "/w1.csv"));
+	weights.push_back(load_matrix(MODEL_RES_DIRECTORY "/w2.csv"));
+	intercepts.push_back(load_matrix(MODEL_RES_DIRECTORY "/i1.csv"));
+	intercepts.push_back(load_matrix(MODEL_RES_DIRECTORY "/i2.csv"));
+}
+
+double stage_agreement(const dlib::matrix<double> &features) {
+	std::vector<dlib::matrix<double>> weights;
+	std::vector<dlib::matrix<double>> intercepts;
+	load_offline_model(weights, intercepts);
+
+	MlpClassifier original(weights, intercepts);
+	MlpClassifier quantized(weights, intercepts, true);
+
+	dlib::matrix<int> expected = original.predict(features);
+	dlib::matrix<int> actual = quantized.predict(features);
+
+	long agreeing = 0;
+	for (long i = 0; i != expected.nr(); ++i) {
+		agreeing += expected(i, 0) == actual(i, 0);
+	}
+	std::cout << "quantized stage agreement: " << agreeing << " / " << expected.nr() << std::endl;
+	return double(agreeing) / expected.nr();
+}
+
+}
+
+TEST(QuantizedStagingFunctionalTest, python_features_stage_agreement) {
+	dlib::matrix<double> features = get_python_features();
+	ASSERT_TRUE(features.nr() > 100);
+	EXPECT_GE(stage_agreement(features), MINIMAL_STAGE_AGREEMENT);
+}
+
+TEST(QuantizedStagingFunctionalTest, full_offline_staging_stage_agreement) {
+	dlib::matrix<double> eeg = get_eeg_data();
+	dlib::matrix<double> ir = get_ir_data();
+
+	StagingPreprocessor pre;
+	dlib::matrix<double> features = pre.transform(eeg, ir);
+	ASSERT_TRUE(features.nr() > 100);
+	EXPECT_GE(stage_agreement(features), MINIMAL_STAGE_AGREEMENT);
+}
@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "AcCouplingFilter.h"
+
+TEST(AcCouplingFilterTest, subtracts_the_mean_of_the_window) {
+	const int WINDOW = 40;
+	std::mt19937 generator(2);
+	std::normal_distribution<double> noise(1e4, 50);
+
+	AcCouplingFilter filter(WINDOW);
+	std::vector<double> signal;
+	for (int i = 0; i != 100000; ++i) {
+		signal.push_back(noise(generator));
+
+		auto begin = signal.end() - std::min<int>(signal.size(), WINDOW);
+		double mean = 0;
+		for (auto it = begin; it != signal.end(); ++it) {
+			mean += *it;
+		}
+		mean /= signal.end() - begin;
+
+		ASSERT_NEAR(filter.filter(signal.back()), signal.back() - mean, 1e-8) << "sample " << i;
+	}
+}
+
+TEST(AcCouplingFilterTest, reset_and_invalid_window) {
+	AcCouplingFilter filter(3);
+	filter.filter(10);
+	filter.filter(20);
+	filter.reset();
+	EXPECT_EQ(filter.filter(5), 0);
+	EXPECT_EQ(filter.filter(7), 1);
+
+	EXPECT_THROW(AcCouplingFilter(0), std::logic_error);
+}
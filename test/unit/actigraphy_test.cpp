@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+
+#include "Actigraphy.h"
+
+namespace {
+
+const int FS = 25;
+
+void feed(Actigraphy& actigraphy, const Double3d& sample, int seconds) {
+	for (int i = 0; i != seconds * FS; ++i) {
+		actigraphy.consume(sample);
+	}
+}
+
+}
+
+TEST(ActigraphyTest, still_subject_has_no_activity) {
+	Actigraphy actigraphy(FS);
+	feed(actigraphy, {0, 0, 1}, 60);
+
+	Actigraphy::Totals settled = actigraphy.totals();
+	feed(actigraphy, {0, 0, 1}, 30);
+
+	EXPECT_EQ(actigraphy.totals().samples, 90 * FS);
+	EXPECT_NEAR(Actigraphy::activity_between(settled, actigraphy.totals()), 0, 1e-3);
+	EXPECT_EQ(actigraphy.totals().posture_changes, 0);
+}
+
+TEST(ActigraphyTest, shaking_is_measured_in_g) {
+	std::mt19937 generator(7);
+	std::normal_distribution<double> shaking(0, 0.2);
+
+	Actigraphy actigraphy(FS);
+	feed(actigraphy, {0, 0, 1}, 60);
+	Actigraphy::Totals before = actigraphy.totals();
+
+	for (int i = 0; i != 30 * FS; ++i) {
+		actigraphy.consume({shaking(generator), shaking(generator), 1 + shaking(generator)});
+	}
+
+	// the white noise of 0.2 g on each axis, slightly reduced by the high-pass
+	double activity = Actigraphy::activity_between(before, actigraphy.totals());
+	EXPECT_NEAR(activity, 0.2 * std::sqrt(3.), 0.05);
+	EXPECT_EQ(actigraphy.totals().posture_changes, 0);
+	EXPECT_EQ(Actigraphy::activity_between(actigraphy.totals(), actigraphy.totals()), 0);
+}
+
+TEST(ActigraphyTest, turning_over_is_a_posture_change) {
+	Actigraphy actigraphy(FS);
+	feed(actigraphy, {0, 0, 1}, 60);
+	EXPECT_EQ(actigraphy.totals().posture_changes, 0);
+
+	// lying on the side
+	feed(actigraphy, {1, 0, 0}, 60);
+	EXPECT_EQ(actigraphy.totals().posture_changes, 1);
+
+	// and on the back again
+	feed(actigraphy, {0, 0, 1}, 60);
+	EXPECT_EQ(actigraphy.totals().posture_changes, 2);
+}
+
+TEST(ActigraphyTest, reset_starts_over) {
+	Actigraphy actigraphy(FS);
+	feed(actigraphy, {0, 0, 1}, 30);
+	feed(actigraphy, {1, 0, 0}, 30);
+	ASSERT_GT(actigraphy.totals().energy, 0);
+
+	actigraphy.reset();
+	EXPECT_EQ(actigraphy.totals().samples, 0);
+	EXPECT_EQ(actigraphy.totals().energy, 0);
+	EXPECT_EQ(actigraphy.totals().posture_changes, 0);
+
+	// the first posture after the reset isn't a change
+	feed(actigraphy, {1, 0, 0}, 30);
+	EXPECT_EQ(actigraphy.totals().posture_changes, 0);
+}
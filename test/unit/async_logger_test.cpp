@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AsyncLogger.h"
+#include "LogRateLimiter.h"
+#include "LogRecordRing.h"
+
+namespace {
+
+LogRecord record_with_line(unsigned long line) {
+	LogRecord record = LogRecord();
+	record.level_name = "INFO";
+	record.line = line;
+	return record;
+}
+
+}
+
+TEST(LogRecordRingTest, fifo_and_drops_when_full) {
+	LogRecordRing ring(3);
+	ASSERT_EQ(ring.capacity(), 4);
+
+	for (unsigned long i = 0; i != 4; ++i) {
+		EXPECT_TRUE(ring.try_push(record_with_line(i)));
+	}
+	EXPECT_FALSE(ring.try_push(record_with_line(4)));
+	EXPECT_EQ(ring.dropped(), 1);
+
+	LogRecord record;
+	for (unsigned long i = 0; i != 4; ++i) {
+		ASSERT_TRUE(ring.try_pop(record));
+		EXPECT_EQ(record.line, i);
+	}
+	EXPECT_FALSE(ring.try_pop(record));
+
+	// the cells are reused on the next lap
+	EXPECT_TRUE(ring.try_push(record_with_line(5)));
+	ASSERT_TRUE(ring.try_pop(record));
+	EXPECT_EQ(record.line, 5);
+}
+
+TEST(LogRecordRingTest, concurrent_producers) {
+	const int PRODUCERS = 4;
+	const unsigned long RECORDS = 10000;
+	LogRecordRing ring(64);
+
+	std::vector<std::thread> producers;
+	for (int p = 0; p != PRODUCERS; ++p) {
+		producers.emplace_back([&ring, p, RECORDS]() {
+			for (unsigned long i = 0; i != RECORDS; ++i) {
+				while (!ring.try_push(record_with_line(p * RECORDS + i))) {
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+
+	// the records of each producer arrive in order, none is lost
+	std::vector<unsigned long> next(PRODUCERS, 0);
+	unsigned long popped = 0;
+	LogRecord record;
+	while (popped != PRODUCERS * RECORDS) {
+		if (ring.try_pop(record)) {
+			int p = static_cast<int>(record.line / RECORDS);
+			ASSERT_EQ(record.line % RECORDS, next[p]);
+			++next[p];
+			++popped;
+		}
+	}
+	for (std::thread& producer : producers) {
+		producer.join();
+	}
+}
+
+TEST(LogRateLimiterTest, limits_each_module_per_second) {
+	LogRateLimiter limiter(2);
+	std::size_t suppressed = 99;
+
+	EXPECT_TRUE(limiter.admit("A.cpp", 1000, &suppressed));
+	EXPECT_EQ(suppressed, 0);
+	EXPECT_TRUE(limiter.admit("A.cpp", 1100, &suppressed));
+	EXPECT_FALSE(limiter.admit("A.cpp", 1200, &suppressed));
+	EXPECT_FALSE(limiter.admit("A.cpp", 1999, &suppressed));
+
+	// another module has its own limit
+	EXPECT_TRUE(limiter.admit("B.cpp", 1500, &suppressed));
+
+	// the next second reports the suppressed records
+	EXPECT_TRUE(limiter.admit("A.cpp", 2000, &suppressed));
+	EXPECT_EQ(suppressed, 2);
+	EXPECT_TRUE(limiter.admit("A.cpp", 2001, &suppressed));
+	EXPECT_EQ(suppressed, 0);
+
+	limiter.set_max_per_second(0);
+	for (int i = 0; i != 100; ++i) {
+		EXPECT_TRUE(limiter.admit("A.cpp", 2002, &suppressed));
+	}
+}
+
+TEST(AsyncLoggerTest, formats_and_dispatches_on_flush) {
+	std::vector<std::string> lines;
+	AsyncLogger logger([&lines](int, const std::string& line) { lines.push_back(line); }, false, 16, 3);
+
+	for (int i = 0; i != 5; ++i) {
+		logger.capture(1, "INFO", "default", "/path/to/Module.cpp", 42, "message " + std::to_string(i));
+	}
+	EXPECT_TRUE(lines.empty());
+
+	EXPECT_EQ(logger.flush(), 3);
+	ASSERT_EQ(lines.size(), 3);
+	const std::string suffix = " INFO [default] Module.cpp:42: message 0";
+	ASSERT_GT(lines[0].size(), suffix.size());
+	EXPECT_EQ(lines[0].substr(lines[0].size() - suffix.size()), suffix);
+
+	// a too long message is truncated instead of allocated
+	logger.set_max_records_per_second(0);
+	logger.capture(1, "INFO", "default", "Module.cpp", 1, std::string(10000, 'x'));
+	EXPECT_EQ(logger.flush(), 1);
+	EXPECT_EQ(lines.back().find(std::string(LogRecord::MESSAGE_CAPACITY, 'x')), std::string::npos);
+	EXPECT_NE(lines.back().find(std::string(LogRecord::MESSAGE_CAPACITY - 1, 'x')), std::string::npos);
+}
+
+TEST(AsyncLoggerTest, background_thread_dispatches) {
+	std::atomic<int> dispatched(0);
+	{
+		AsyncLogger logger([&dispatched](int, const std::string&) { ++dispatched; });
+		logger.capture(2, "WARNING", "default", "Module.cpp", 1, "first");
+
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+		while (dispatched == 0 && std::chrono::steady_clock::now() < deadline) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		EXPECT_EQ(dispatched, 1);
+
+		// the pending records are flushed when the logger is destroyed
+		logger.capture(2, "WARNING", "default", "Module.cpp", 2, "second");
+	}
+	EXPECT_EQ(dispatched, 2);
+}
@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include "Biquad.h"
+
+namespace {
+
+/*
+ * The amplitude of the filtered sine after the transient dies out,
+ * from the mean square of the last 10 s
+ */
+double sine_gain(Biquad filter, double fs, double frequency) {
+	double sum_of_squares = 0;
+	const int SAMPLES = 20 * static_cast<int>(fs);
+	for (int i = 0; i != SAMPLES; ++i) {
+		double value = filter.filter(std::sin(2 * M_PI * frequency * i / fs));
+		if (i >= SAMPLES / 2) {
+			sum_of_squares += value * value;
+		}
+	}
+	return std::sqrt(2 * sum_of_squares / (SAMPLES / 2));
+}
+
+}
+
+TEST(BiquadTest, low_pass) {
+	const double FS = 25;
+	Biquad filter = Biquad::low_pass(FS, 3);
+
+	EXPECT_NEAR(sine_gain(filter, FS, 0.1), 1, 1e-2);
+	EXPECT_NEAR(sine_gain(filter, FS, 3), std::sqrt(0.5), 1e-2);
+	EXPECT_LT(sine_gain(filter, FS, 10), 0.1);
+}
+
+TEST(BiquadTest, high_pass) {
+	const double FS = 25;
+	Biquad filter = Biquad::high_pass(FS, 0.5);
+
+	EXPECT_LT(sine_gain(filter, FS, 0.05), 0.02);
+	EXPECT_NEAR(sine_gain(filter, FS, 0.5), std::sqrt(0.5), 1e-2);
+	EXPECT_NEAR(sine_gain(filter, FS, 5), 1, 1e-2);
+}
+
+TEST(BiquadTest, band_pass) {
+	const double FS = 125;
+	Biquad filter = Biquad::band_pass(FS, 10, 2);
+
+	EXPECT_NEAR(sine_gain(filter, FS, 10), 1, 1e-2);
+	EXPECT_LT(sine_gain(filter, FS, 1), 0.1);
+	EXPECT_LT(sine_gain(filter, FS, 50), 0.1);
+	EXPECT_NEAR(sine_gain(Biquad::identity(), FS, 20), 1, 1e-2);
+}
+
+TEST(BiquadTest, reset_clears_the_state) {
+	Biquad filter = Biquad::low_pass(25, 3);
+	double first = filter.filter(1);
+	filter.filter(5);
+	filter.reset();
+	EXPECT_EQ(filter.filter(1), first);
+}
+
+TEST(BiquadTest, invalid_cutoff) {
+	EXPECT_THROW(Biquad::low_pass(25, 13), std::logic_error);
+	EXPECT_THROW(Biquad::high_pass(25, 0), std::logic_error);
+}
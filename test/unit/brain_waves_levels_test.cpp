@@ -1,6 +1,9 @@
 #include <dlib/matrix.h>
 #include "BrainWaveLevels.h"
 #include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include "PolyphaseDecimator.h"
 #include "Spectrogram.h"
 
 TEST(BrainWaveLevelsTest, basic_case) {
@@ -21,3 +24,67 @@ TEST(BrainWaveLevelsTest, multiple_windows) {
 	std::vector<ncBrainWaveLevels> result = bw.predict(dummy_spectrogram);
 	ASSERT_EQ(result.size(), dummy_spectrogram.size());
 }
+
+namespace {
+
+/*
+ * The mean beta level of the presentation computed from the 125 Hz EEG
+ * (256 sample windows) and from the EEG decimated by 2 (128 sample windows)
+ */
+std::pair<double, double> beta_levels(const std::vector<double>& eeg) {
+	PolyphaseDecimator decimator(2);
+	std::vector<double> decimated;
+	decimator.process(eeg.data(), eeg.size(), decimated);
+
+	BrainWaveLevels full_levels;
+	BrainWaveLevels decimated_levels;
+	double full_sum = 0;
+	double decimated_sum = 0;
+	int count = 0;
+	// skipping the transient of the decimator and the smoothing
+	for (std::size_t w = 10; (w + 1) * 256 <= eeg.size(); ++w) {
+		dlib::matrix<double> full(256, 1);
+		dlib::matrix<double> half(128, 1);
+		for (int i = 0; i != 256; ++i) {
+			full(i, 0) = eeg[w * 256 + i];
+		}
+		for (int i = 0; i != 128; ++i) {
+			half(i, 0) = decimated[w * 128 + i];
+		}
+		double full_beta = full_levels.predict(Spectrogram(full, 125, 256, 0)).front().beta;
+		double decimated_beta = decimated_levels.predict(Spectrogram(half, 62.5, 128, 0)).front().beta;
+		if (w >= 14) {
+			full_sum += full_beta;
+			decimated_sum += decimated_beta;
+			++count;
+		}
+	}
+	return std::make_pair(full_sum / count, decimated_sum / count);
+}
+
+}
+
+TEST(BrainWaveLevelsTest, decimated_beta_close_to_the_full_rate) {
+	std::mt19937 generator(1);
+	std::normal_distribution<double> noise(0, 1);
+	std::vector<double> white(125 * 300);
+	std::vector<double> pink(white.size());
+
+	// pink noise from white noise filtered by a sum of one-pole low-passes
+	double b0 = 0, b1 = 0, b2 = 0;
+	for (std::size_t i = 0; i != white.size(); ++i) {
+		white[i] = noise(generator);
+		b0 = 0.99765 * b0 + white[i] * 0.0990460;
+		b1 = 0.96300 * b1 + white[i] * 0.2965164;
+		b2 = 0.57000 * b2 + white[i] * 1.0526913;
+		pink[i] = b0 + b1 + b2 + white[i] * 0.1848;
+	}
+
+	// the beta band reaches 31 Hz, close to the 31.25 Hz Nyquist frequency of
+	// the decimated EEG, so its top is attenuated by the decimation filter
+	for (const std::vector<double>* eeg : {&white, &pink}) {
+		std::pair<double, double> beta = beta_levels(*eeg);
+		EXPECT_NEAR(beta.second, beta.first, 0.05 * beta.first);
+		EXPECT_LE(beta.second, beta.first);
+	}
+}
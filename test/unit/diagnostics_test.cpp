@@ -0,0 +1,98 @@
+#define NC_DIAGNOSTICS
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Diagnostics.h"
+
+namespace {
+
+unsigned long counter(const std::string& name) {
+	for (const auto& c : Diagnostics::counters()) {
+		if (c.first == name) {
+			return c.second;
+		}
+	}
+	return 0;
+}
+
+int traced_value(int value, int* evaluations) {
+	++*evaluations;
+	return value;
+}
+
+}
+
+TEST(DiagnosticsTest, nothing_counted_until_enabled) {
+	Diagnostics::set_enabled(false);
+	for (int i = 0; i != 10; ++i) {
+		DIAG_COUNT("diagnostics_test.disabled");
+	}
+	EXPECT_EQ(counter("diagnostics_test.disabled"), 0);
+}
+
+TEST(DiagnosticsTest, counts_the_calls) {
+	Diagnostics::set_enabled(true);
+	Diagnostics::reset();
+	for (int i = 0; i != 10; ++i) {
+		DIAG_COUNT("diagnostics_test.count");
+	}
+	// the sites with the same name are summed
+	DIAG_COUNT("diagnostics_test.count");
+	EXPECT_EQ(counter("diagnostics_test.count"), 11);
+
+	Diagnostics::reset();
+	EXPECT_EQ(counter("diagnostics_test.count"), 0);
+	Diagnostics::set_enabled(false);
+}
+
+TEST(DiagnosticsTest, traces_are_sampled) {
+	Diagnostics::set_enabled(true);
+	Diagnostics::reset();
+	Diagnostics::set_sample_every(4);
+
+	int evaluations = 0;
+	for (int i = 0; i != 10; ++i) {
+		DIAG_TRACE("diagnostics_test.trace") << "value " << traced_value(i, &evaluations);
+	}
+
+	// the values are evaluated for the calls 0, 4 and 8 only
+	EXPECT_EQ(evaluations, 3);
+	EXPECT_EQ(counter("diagnostics_test.trace"), 10);
+
+	// a trace is a single statement
+	if (evaluations == 0)
+		DIAG_TRACE("diagnostics_test.else") << "never";
+	else
+		++evaluations;
+	EXPECT_EQ(evaluations, 4);
+
+	Diagnostics::set_sample_every(Diagnostics::DEFAULT_SAMPLE_EVERY);
+	Diagnostics::set_enabled(false);
+}
+
+TEST(DiagnosticsTest, traces_from_many_threads) {
+	Diagnostics::set_enabled(true);
+	Diagnostics::reset();
+	Diagnostics::set_sample_every(1);
+
+	// every trace is logged, e.g. as in the tasks of StagingPreprocessor
+	const int THREADS = 4;
+	const int TRACES = 200;
+	std::vector<std::thread> threads;
+	for (int t = 0; t != THREADS; ++t) {
+		threads.emplace_back([t]() {
+			for (int i = 0; i != TRACES; ++i) {
+				DIAG_TRACE("diagnostics_test.threads") << "thread " << t << ", value " << i;
+			}
+		});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	EXPECT_EQ(counter("diagnostics_test.threads"), THREADS * TRACES);
+
+	Diagnostics::set_sample_every(Diagnostics::DEFAULT_SAMPLE_EVERY);
+	Diagnostics::set_enabled(false);
+}
@@ -0,0 +1,222 @@
+#include <gtest/gtest.h>
+#include <dlib/matrix.h>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "EegBandFeatures.h"
+#include "AmplitudeFilter.h"
+#include "ExpandingMean.h"
+#include "Features.h"
+#include "RollingMean.h"
+#include "Spectrogram.h"
+#include "dlib_utils.h"
+
+namespace {
+
+/*
+ * The original, unfused chain of operations computing the EEG features
+ * of the online staging algorithm. EegBandFeatures has to give the same results.
+ */
+class ReferenceEegChain {
+	RollingMean m_rolling;
+	ExpandingMean m_mean;
+	dlib::matrix<double> m_stds;
+
+public:
+	ReferenceEegChain(int rolling_window)
+	: m_rolling(rolling_window, EegBandFeatures::NUMBER_OF_FEATURES)
+	, m_mean(1, EegBandFeatures::NUMBER_OF_FEATURES)
+	, m_stds(1, EegBandFeatures::NUMBER_OF_FEATURES)
+	{
+		dlib::set_all_elements(m_stds, 0.3);
+	}
+
+	dlib::matrix<double> transform(const Spectrogram& s) {
+		std::vector<double> borders({ 1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15, 16, 17,
+									 18, 19, 20, 21});
+		dlib::matrix<double> band_sums = Features::sum_by_borders(s, borders, true);
+		m_rolling.feed(band_sums);
+		band_sums = m_rolling.value();
+		band_sums = dlib::log(band_sums);
+
+		dlib::matrix<double> filter_band = Features::sum_in_band(s, 10, 14, false);
+		filter_band = dlib::log(filter_band);
+		AmplitudeFilter f(19);
+		band_sums = f.transform(band_sums, filter_band);
+
+		m_mean.consume(band_sums);
+		return standardize(band_sums, m_mean.value(), m_stds);
+	}
+};
+
+void expect_same_features(const dlib::matrix<double>& expected, const dlib::matrix<double>& actual) {
+	ASSERT_EQ(expected.nr(), actual.nr());
+	ASSERT_EQ(expected.nc(), actual.nc());
+	for (int j = 0; j != expected.nc(); ++j) {
+		double e = expected(0, j);
+		double a = actual(0, j);
+		if (std::isnan(e)) {
+			EXPECT_TRUE(std::isnan(a)) << "column " << j;
+		} else {
+			EXPECT_NEAR(e, a, 1e-9 * std::max(1., std::abs(e))) << "column " << j;
+		}
+	}
+}
+
+}
+
+TEST(EegBandFeaturesTest, equivalent_to_the_unfused_chain) {
+	const int ROLLING_WINDOW = 3;
+	const int EEG_WINDOW = 10 * 1024;
+	const double FS = 125;
+
+	std::mt19937 generator(42);
+	std::normal_distribution<double> noise(0, 1);
+
+	EegBandFeatures fused(ROLLING_WINDOW);
+	ReferenceEegChain reference(ROLLING_WINDOW);
+
+	// the amplitudes change from step to step, the loud ones
+	// get rejected by the amplitude filter
+	std::vector<double> amplitudes({100, 120, 80, 1e6, 90, 110, 1e6, 1e6, 70, 100, 130, 95});
+	for (double amplitude : amplitudes) {
+		dlib::matrix<double> signal(EEG_WINDOW, 1);
+		for (int i = 0; i != EEG_WINDOW; ++i) {
+			signal(i, 0) = amplitude * (noise(generator) + std::sin(2 * M_PI * 11.5 * i / FS));
+		}
+
+		Spectrogram spectrogram(signal, FS, EEG_WINDOW);
+		expect_same_features(reference.transform(spectrogram), fused.transform(spectrogram));
+	}
+}
+
+TEST(EegBandFeaturesTest, nan_until_the_rolling_window_is_filled) {
+	const int ROLLING_WINDOW = 3;
+	const int EEG_WINDOW = 1024;
+
+	EegBandFeatures features(ROLLING_WINDOW);
+	dlib::matrix<double> signal = dlib::ones_matrix<double>(EEG_WINDOW, 1);
+	Spectrogram spectrogram(signal, 125, EEG_WINDOW);
+
+	for (int i = 0; i != ROLLING_WINDOW - 1; ++i) {
+		EXPECT_FALSE(dlib::is_finite(features.transform(spectrogram)));
+	}
+
+	features.reset();
+	EXPECT_FALSE(dlib::is_finite(features.transform(spectrogram)));
+}
+
+TEST(EegBandFeaturesTest, partial_window_defined_from_the_first_step) {
+	const int ROLLING_WINDOW = 3;
+	const int EEG_WINDOW = 1024;
+	const double FS = 125;
+
+	std::mt19937 generator(1);
+	std::normal_distribution<double> noise(0, 100);
+
+	EegBandFeatures partial(ROLLING_WINDOW, true);
+	EegBandFeatures full(ROLLING_WINDOW);
+	std::vector<dlib::matrix<double>> rows;
+	for (int step = 0; step != 5; ++step) {
+		dlib::matrix<double> signal(EEG_WINDOW, 1);
+		for (int i = 0; i != EEG_WINDOW; ++i) {
+			signal(i, 0) = noise(generator);
+		}
+		Spectrogram spectrogram(signal, FS, EEG_WINDOW);
+
+		dlib::matrix<double> partial_features = partial.transform(spectrogram);
+		dlib::matrix<double> full_features = full.transform(spectrogram);
+		EXPECT_TRUE(dlib::is_finite(partial_features)) << "step " << step;
+		EXPECT_EQ(dlib::is_finite(full_features), step >= ROLLING_WINDOW - 1) << "step " << step;
+	}
+
+	// the first step is the only one seen, so it's equal to the mean
+	partial.reset();
+	dlib::matrix<double> signal(EEG_WINDOW, 1);
+	for (int i = 0; i != EEG_WINDOW; ++i) {
+		signal(i, 0) = noise(generator);
+	}
+	dlib::matrix<double> first = partial.transform(Spectrogram(signal, FS, EEG_WINDOW));
+	for (long j = 0; j != first.nc(); ++j) {
+		EXPECT_EQ(first(0, j), 0);
+	}
+}
+
+TEST(EegBandFeaturesTest, scaled_short_windows_match_the_full_ones_on_noise) {
+	const int FULL_WINDOW = 10 * 1024;
+	const int SHORT_WINDOW = 1024;
+	const double FS = 125;
+
+	std::mt19937 generator(7);
+	std::normal_distribution<double> noise(0, 100);
+	auto noise_signal = [&](int samples) {
+		dlib::matrix<double> signal(samples, 1);
+		for (int i = 0; i != samples; ++i) {
+			signal(i, 0) = noise(generator);
+		}
+		return signal;
+	};
+
+	// the features are standardized by the mean of the full windows seen
+	EegBandFeatures features(1);
+	for (int step = 0; step != 10; ++step) {
+		features.transform(Spectrogram(noise_signal(FULL_WINDOW), FS, FULL_WINDOW));
+	}
+
+	// a short window has only ~8 bins in each band, so the bands of a single
+	// one are noisy, the features of a few windows are averaged
+	const int SHORT_WINDOWS = 8;
+	dlib::matrix<double> scaled = dlib::zeros_matrix<double>(1, EegBandFeatures::NUMBER_OF_FEATURES);
+	dlib::matrix<double> unscaled = scaled;
+	for (int i = 0; i != SHORT_WINDOWS; ++i) {
+		dlib::matrix<double> signal = noise_signal(SHORT_WINDOW);
+
+		// copies, so that the mean of the full windows stays the same
+		EegBandFeatures scaled_features = features;
+		EegBandFeatures unscaled_features = features;
+		scaled += scaled_features.transform(
+				Spectrogram(signal * noise_magnitude_scale(SHORT_WINDOW, FULL_WINDOW), FS, SHORT_WINDOW));
+		unscaled += unscaled_features.transform(Spectrogram(signal, FS, SHORT_WINDOW));
+	}
+	scaled /= SHORT_WINDOWS;
+	unscaled /= SHORT_WINDOWS;
+
+	EXPECT_NEAR(dlib::mean(scaled), 0, 0.2);
+	EXPECT_LT(dlib::mean(unscaled), -3);
+	for (long j = 0; j != scaled.nc(); ++j) {
+		EXPECT_NEAR(scaled(0, j), 0, 1) << "band " << j;
+	}
+}
+
+TEST(EegBandFeaturesTest, rejected_step_stays_in_the_rolling_window) {
+	const int ROLLING_WINDOW = 3;
+	const int EEG_WINDOW = 1024;
+	const double FS = 125;
+
+	std::mt19937 generator(3);
+	std::normal_distribution<double> noise(0, 100);
+	auto spectrogram = [&]() {
+		dlib::matrix<double> signal(EEG_WINDOW, 1);
+		for (int i = 0; i != EEG_WINDOW; ++i) {
+			signal(i, 0) = noise(generator);
+		}
+		return Spectrogram(signal, FS, EEG_WINDOW);
+	};
+
+	EegBandFeatures features(ROLLING_WINDOW);
+	for (int step = 0; step != ROLLING_WINDOW; ++step) {
+		features.transform(spectrogram());
+	}
+	EXPECT_TRUE(dlib::is_finite(features.transform(spectrogram())));
+
+	dlib::matrix<double> rejected(1, EegBandFeatures::NUMBER_OF_FEATURES);
+	features.transform_rejected(&rejected(0, 0));
+	EXPECT_FALSE(dlib::is_finite(rejected));
+
+	// the rejected step is averaged with the next ones until it leaves the window
+	for (int step = 1; step != ROLLING_WINDOW; ++step) {
+		EXPECT_FALSE(dlib::is_finite(features.transform(spectrogram()))) << "step " << step;
+	}
+	EXPECT_TRUE(dlib::is_finite(features.transform(spectrogram())));
+}
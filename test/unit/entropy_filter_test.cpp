@@ -44,3 +44,18 @@ TEST_F(EntropyFilterTest, basic_entropy_filter_test) {
 		}
 	}
 }
+
+TEST_F(EntropyFilterTest, rejected_rows_mask_test) {
+	dlib::matrix<double> data(3, 4);
+	dlib::set_all_elements(data, 1);
+	data(1, 0) = 100;
+
+	// the entropy of the uniform rows is ln(4) ~ 1.386
+	EntropyFilter f(1.3);
+	dlib::matrix<unsigned char> rejected = f.rejected_rows(data);
+
+	ASSERT_EQ(rejected.nr(), data.nr());
+	EXPECT_EQ(rejected(0, 0), 1);
+	EXPECT_EQ(rejected(1, 0), 0);
+	EXPECT_EQ(rejected(2, 0), 1);
+}
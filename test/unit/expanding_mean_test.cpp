@@ -61,3 +61,27 @@ TEST(ExpandingMeanTest, ignores_matrix_with_nans) {
 	em.consume(nan_row);
 	EXPECT_EQ(em.value(), 2 * mat);
 }
+
+TEST(ExpandingMeanTest, merge_equals_consuming_everything) {
+	ExpandingMean all(1, 2), first(1, 2), second(1, 2);
+	dlib::matrix<double> x(1, 2);
+	for (int i = 0; i != 10; ++i) {
+		x(0, 0) = i;
+		x(0, 1) = i * i;
+		all.consume(x);
+		if (i < 3) {
+			first.consume(x);
+		} else {
+			second.consume(x);
+		}
+	}
+
+	first.merge(second);
+	EXPECT_EQ(first.count(), 10);
+	EXPECT_DOUBLE_EQ(first.value()(0, 0), all.value()(0, 0));
+	EXPECT_DOUBLE_EQ(first.value()(0, 1), all.value()(0, 1));
+
+	ExpandingMean empty(1, 2);
+	empty.merge(all);
+	EXPECT_DOUBLE_EQ(empty.value()(0, 1), all.value()(0, 1));
+}
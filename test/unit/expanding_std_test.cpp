@@ -18,3 +18,34 @@ TEST(ExpandingStdTest, basic_test1_1on1_matrix) {
 	es.consume(NAN * one);
 	EXPECT_DOUBLE_EQ(es.value(), dlib::sqrt_2 / dlib::sqrt_3);
 }
+
+TEST(ExpandingStdTest, stable_for_big_offsets) {
+	// a night of values with a big offset and small spread, E[x^2] - E[x]^2
+	// loses all the significant digits here
+	ExpandingStd es(1, 1);
+	dlib::matrix<double> x(1, 1);
+	const int N = 3 * 60 * 8;
+	for (int i = 0; i != N; ++i) {
+		x(0, 0) = 1e9 + (i % 2 == 0 ? 1 : -1);
+		es.consume(x);
+	}
+	EXPECT_NEAR(es.value()(0, 0), 1, 1e-6);
+}
+
+TEST(ExpandingStdTest, merge_equals_consuming_everything) {
+	ExpandingStd all(1, 1), first(1, 1), second(1, 1);
+	dlib::matrix<double> x(1, 1);
+	for (int i = 0; i != 100; ++i) {
+		x(0, 0) = std::sin(i) * 10 + i * 0.1;
+		all.consume(x);
+		if (i < 37) {
+			first.consume(x);
+		} else {
+			second.consume(x);
+		}
+	}
+
+	first.merge(second);
+	EXPECT_EQ(first.count(), 100);
+	EXPECT_NEAR(first.value()(0, 0), all.value()(0, 0), 1e-12);
+}
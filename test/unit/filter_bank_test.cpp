@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "FilterBank.h"
+
+namespace {
+
+std::vector<std::vector<Biquad>> cascades() {
+	const double FS = 125;
+	return {
+		{Biquad::high_pass(FS, 0.5), Biquad::low_pass(FS, 30)},
+		{Biquad::band_pass(FS, 10, 2)},
+		{Biquad::low_pass(FS, 4), Biquad::low_pass(FS, 4, 1.3)},
+	};
+}
+
+}
+
+TEST(FilterBankTest, same_as_the_biquads_of_each_channel) {
+	const int FRAMES = 500;
+	std::vector<std::vector<Biquad>> filters = cascades();
+	const int CHANNELS = filters.size();
+	FilterBank bank(filters);
+	EXPECT_EQ(bank.channels(), CHANNELS);
+	EXPECT_EQ(bank.sections(), 2);
+
+	std::mt19937 generator(11);
+	std::normal_distribution<double> noise(0, 10);
+	std::vector<double> input(FRAMES * CHANNELS);
+	for (double& x : input) {
+		x = noise(generator);
+	}
+
+	// in two chunks, the second one in place
+	std::vector<double> output(input.size());
+	bank.process(input.data(), 200, output.data());
+	std::copy(input.begin() + 200 * CHANNELS, input.end(), output.begin() + 200 * CHANNELS);
+	bank.process(output.data() + 200 * CHANNELS, FRAMES - 200, output.data() + 200 * CHANNELS);
+
+	for (int c = 0; c != CHANNELS; ++c) {
+		for (int t = 0; t != FRAMES; ++t) {
+			double expected = input[t * CHANNELS + c];
+			for (Biquad& biquad : filters[c]) {
+				expected = biquad.filter(expected);
+			}
+			ASSERT_NEAR(output[t * CHANNELS + c], expected, 1e-12) << "channel " << c << ", frame " << t;
+		}
+	}
+}
+
+TEST(FilterBankTest, broadcast_and_reset) {
+	const int FRAMES = 300;
+	std::vector<std::vector<Biquad>> filters = cascades();
+	const int CHANNELS = filters.size();
+	FilterBank bank(filters);
+
+	std::mt19937 generator(12);
+	std::normal_distribution<double> noise(0, 10);
+	std::vector<double> input(FRAMES);
+	for (double& x : input) {
+		x = noise(generator);
+	}
+
+	std::vector<double> first(FRAMES * CHANNELS);
+	bank.process_broadcast(input.data(), FRAMES, first.data());
+	for (int c = 0; c != CHANNELS; ++c) {
+		for (int t = 0; t != FRAMES; ++t) {
+			double expected = input[t];
+			for (Biquad& biquad : filters[c]) {
+				expected = biquad.filter(expected);
+			}
+			ASSERT_NEAR(first[t * CHANNELS + c], expected, 1e-12) << "channel " << c << ", frame " << t;
+		}
+	}
+
+	bank.reset();
+	std::vector<double> second(FRAMES * CHANNELS);
+	bank.process_broadcast(input.data(), FRAMES, second.data());
+	EXPECT_EQ(first, second);
+
+	EXPECT_THROW(FilterBank(std::vector<std::vector<Biquad>>()), std::logic_error);
+}
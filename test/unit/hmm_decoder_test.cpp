@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include <dlib/matrix.h>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "HmmDecoder.h"
+#include "OnLineViterbiSearch.h"
+#include "ThreadPool.h"
+
+namespace {
+
+const long STATES = 3;
+
+dlib::matrix<double> sticky_transitions() {
+	dlib::matrix<double> transitions(STATES, STATES);
+	dlib::set_all_elements(transitions, 0.1);
+	for (long i = 0; i != STATES; ++i) {
+		transitions(i, i) = 0.8;
+	}
+	transitions(0, 2) = 0.05;
+	transitions(0, 1) = 0.15;
+	return transitions;
+}
+
+dlib::matrix<double> random_emissions(long epochs, std::mt19937& generator) {
+	std::uniform_real_distribution<double> uniform(0.01, 1);
+	dlib::matrix<double> emissions(epochs, STATES);
+	for (long i = 0; i != epochs; ++i) {
+		double sum = 0;
+		for (long j = 0; j != STATES; ++j) {
+			emissions(i, j) = uniform(generator);
+			sum += emissions(i, j);
+		}
+		for (long j = 0; j != STATES; ++j) {
+			emissions(i, j) /= sum;
+		}
+	}
+	return emissions;
+}
+
+}
+
+TEST(HmmDecoderTest, viterbi_equals_online_search) {
+	std::mt19937 generator(5);
+	dlib::matrix<double> emissions = random_emissions(500, generator);
+	dlib::matrix<double> start_p = dlib::uniform_matrix<double>(STATES, 1, 1. / STATES);
+	dlib::matrix<double> final_p(STATES, 1);
+	final_p = 0.2, 0.3, 0.5;
+
+	HmmDecoder decoder(sticky_transitions(), start_p, final_p);
+	OnLineViterbiSearch online({0, 1, 2}, start_p, final_p, sticky_transitions());
+	for (long i = 0; i != emissions.nr(); ++i) {
+		online.step(dlib::trans(dlib::rowm(emissions, i)));
+	}
+	online.stop();
+
+	EXPECT_EQ(decoder.viterbi(emissions), online.sequence());
+}
+
+namespace {
+
+void expect_posteriors_equal_path_enumeration(const dlib::matrix<double>& start_p,
+											  const dlib::matrix<double>& final_p) {
+	std::mt19937 generator(9);
+	const long EPOCHS = 5;
+	dlib::matrix<double> emissions = random_emissions(EPOCHS, generator);
+	dlib::matrix<double> transitions = sticky_transitions();
+	HmmDecoder decoder(transitions, start_p, final_p);
+
+	// sums the probabilities of all the STATES^EPOCHS paths
+	dlib::matrix<double> expected(EPOCHS, STATES);
+	dlib::set_all_elements(expected, 0);
+	long paths = 1;
+	for (long i = 0; i != EPOCHS; ++i) {
+		paths *= STATES;
+	}
+	for (long code = 0; code != paths; ++code) {
+		std::vector<long> path;
+		for (long i = 0, rest = code; i != EPOCHS; ++i, rest /= STATES) {
+			path.push_back(rest % STATES);
+		}
+		double p = start_p(path[0]) * emissions(0, path[0]) * final_p(path[EPOCHS - 1]);
+		for (long i = 1; i != EPOCHS; ++i) {
+			p *= transitions(path[i - 1], path[i]) * emissions(i, path[i]);
+		}
+		for (long i = 0; i != EPOCHS; ++i) {
+			expected(i, path[i]) += p;
+		}
+	}
+
+	dlib::matrix<double> actual = decoder.posteriors(emissions);
+	for (long i = 0; i != EPOCHS; ++i) {
+		const double total = dlib::sum(dlib::rowm(expected, i));
+		for (long j = 0; j != STATES; ++j) {
+			EXPECT_NEAR(expected(i, j) / total, actual(i, j), 1e-12);
+		}
+	}
+}
+
+}
+
+TEST(HmmDecoderTest, posteriors_equal_path_enumeration) {
+	dlib::matrix<double> uniform = dlib::uniform_matrix<double>(STATES, 1, 1. / STATES);
+	expect_posteriors_equal_path_enumeration(uniform, uniform);
+
+	dlib::matrix<double> start_p(STATES, 1);
+	start_p = 0.6, 0.3, 0.1;
+	dlib::matrix<double> final_p(STATES, 1);
+	final_p = 0.2, 0.3, 0.5;
+	expect_posteriors_equal_path_enumeration(start_p, final_p);
+}
+
+TEST(HmmDecoderTest, long_nights_and_rejected_epochs) {
+	std::mt19937 generator(13);
+	dlib::matrix<double> emissions = random_emissions(20000, generator);
+	for (long i = 100; i != 200; ++i) {
+		emissions(i, 1) = NAN;
+	}
+
+	HmmDecoder decoder(sticky_transitions());
+	dlib::matrix<double> posteriors = decoder.posteriors(emissions);
+	ASSERT_TRUE(dlib::is_finite(posteriors));
+	for (long i = 0; i != posteriors.nr(); ++i) {
+		ASSERT_NEAR(dlib::sum(dlib::rowm(posteriors, i)), 1, 1e-9);
+	}
+	EXPECT_EQ(decoder.viterbi(emissions).size(), emissions.nr());
+
+	EXPECT_THROW(decoder.viterbi(dlib::matrix<double>(10, STATES + 1)), std::logic_error);
+}
+
+TEST(HmmDecoderTest, parallel_nights_equal_serial) {
+	std::mt19937 generator(17);
+	std::vector<dlib::matrix<double>> nights;
+	for (int i = 0; i != 8; ++i) {
+		nights.push_back(random_emissions(300 + 50 * i, generator));
+	}
+
+	HmmDecoder decoder(sticky_transitions());
+	ThreadPool pool(4);
+	std::vector<std::vector<int>> paths = decoder.viterbi(nights, pool);
+	std::vector<dlib::matrix<double>> posteriors = decoder.posteriors(nights, pool);
+	ASSERT_EQ(paths.size(), nights.size());
+	for (size_t i = 0; i != nights.size(); ++i) {
+		EXPECT_EQ(paths[i], decoder.viterbi(nights[i]));
+		EXPECT_TRUE(posteriors[i] == decoder.posteriors(nights[i]));
+	}
+}
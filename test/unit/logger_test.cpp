@@ -1,7 +1,68 @@
 #include <gtest/gtest.h>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 #include "logger.h"
 
 TEST(LoggerTest, basic_log_test) {
 	LOG(INFO) << "LOGGING TEST!";}
 
+namespace {
 
+// the callback is called on the background thread of the logger too
+std::mutex received_logs_mutex;
+std::vector<std::string> received_logs;
+std::vector<std::thread::id> receiving_threads;
+
+void receive_log(const char* message) {
+	std::lock_guard<std::mutex> lock(received_logs_mutex);
+	received_logs.push_back(message);
+	receiving_threads.push_back(std::this_thread::get_id());
+}
+
+}
+
+TEST(LoggerTest, callback_receives_the_flushed_logs) {
+	configure_logger(receive_log);
+	flush_logs();
+	{
+		std::lock_guard<std::mutex> lock(received_logs_mutex);
+		received_logs.clear();
+	}
+
+	LOG(WARNING) << "CALLBACK TEST " << 42;
+	flush_logs();
+
+	// restoring the synchronous logging for the other tests
+	configure_logger();
+
+	std::lock_guard<std::mutex> lock(received_logs_mutex);
+	ASSERT_EQ(received_logs.size(), 1);
+	EXPECT_NE(received_logs[0].find("WARNING [default] logger_test.cpp:"), std::string::npos);
+	EXPECT_NE(received_logs[0].find(": CALLBACK TEST 42"), std::string::npos);
+}
+
+TEST(LoggerTest, synchronous_callback_on_the_logging_thread) {
+	configure_logger(receive_log, true);
+	{
+		std::lock_guard<std::mutex> lock(received_logs_mutex);
+		received_logs.clear();
+		receiving_threads.clear();
+	}
+
+	// neither rate limited nor truncated
+	const std::string long_message(2000, 'x');
+	for (int i = 0; i != 50; ++i) {
+		LOG(WARNING) << "SYNCHRONOUS TEST " << long_message;
+	}
+
+	configure_logger();
+
+	std::lock_guard<std::mutex> lock(received_logs_mutex);
+	ASSERT_EQ(received_logs.size(), 50);
+	EXPECT_NE(received_logs[0].find(long_message), std::string::npos);
+	for (std::thread::id id : receiving_threads) {
+		EXPECT_EQ(id, std::this_thread::get_id());
+	}
+}
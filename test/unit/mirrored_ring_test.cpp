@@ -0,0 +1,34 @@
+#include <gtest/gtest.h>
+#include "MirroredRing.h"
+
+TEST(MirroredRingTest, last_elements_are_contiguous) {
+	MirroredRing<int> ring(4);
+	EXPECT_EQ(ring.size(), 0);
+
+	for (int pushed = 1; pushed != 20; ++pushed) {
+		ring.push(pushed);
+		ASSERT_EQ(ring.size(), std::min(pushed, 4));
+
+		const int* data = ring.data();
+		for (int i = 0; i != static_cast<int>(ring.size()); ++i) {
+			EXPECT_EQ(data[i], pushed - static_cast<int>(ring.size()) + 1 + i);
+		}
+	}
+
+	ring.clear();
+	EXPECT_EQ(ring.size(), 0);
+	ring.push(7);
+	EXPECT_EQ(ring.data()[0], 7);
+}
+
+TEST(MirroredRingTest, filled_ring) {
+	MirroredRing<int> ring(3);
+	ring.fill(-1);
+	ASSERT_EQ(ring.size(), 3);
+
+	ring.push(5);
+	EXPECT_EQ(ring.data()[0], -1);
+	EXPECT_EQ(ring.data()[1], -1);
+	EXPECT_EQ(ring.data()[2], 5);
+	EXPECT_EQ(ring.capacity(), 3);
+}
@@ -2,7 +2,15 @@
 #include <gtest/gtest.h>
 #include <dlib/matrix.h>
 #include "dlib_utils.h"
+#include "MlpKernels.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <unistd.h>
 
 
 /**
@@ -94,3 +102,96 @@ TEST(MlpClassifierTest, basic_predict_proba_test) {
 		EXPECT_DOUBLE_EQ(classes_from_proba(r,0), output_classes(r, 0));
 	}
 }
+
+TEST(MlpClassifierTest, load_quantized_files) {
+	// the example classifier as saved by the mlp_quantizer tool
+	std::vector<dlib::matrix<double>> weights({dlib::reshape(vector_to_dlib_matrix(std::vector<double>(
+			{2.03, 2.95, -0.01, -3.68, 1.13})), 1, 5)});
+	std::vector<dlib::matrix<double>> intercepts({dlib::reshape(vector_to_dlib_matrix(std::vector<double>(
+			{2.86, -2.78, -0.64, 2.05, 3.02})), 5, 1)});
+	dlib::matrix<signed char> quantized(1, 5);
+	dlib::matrix<double> scales(5, 1);
+	mlp_quantize_weights(weights[0].begin(), 1, 5, quantized.begin(), scales.begin());
+
+	char directory_template[] = "/tmp/mlp_classifier_testXXXXXX";
+	ASSERT_TRUE(mkdtemp(directory_template) != nullptr);
+	const std::string directory(directory_template);
+	const std::string w1_int8 = directory + "/w1_int8.csv";
+	const std::string w1_scales = directory + "/w1_scales.csv";
+	const std::string i1 = directory + "/i1.csv";
+
+	dump_matrix<int>(dlib::matrix_cast<int>(quantized), w1_int8);
+	dump_matrix<double>(scales, w1_scales);
+	dump_matrix<double>(intercepts[0], i1);
+
+	std::unique_ptr<MlpClassifier> loaded = MlpClassifier::load_quantized(directory);
+	MlpClassifier expected(weights, intercepts, true);
+
+	dlib::matrix<double> input = dlib::trans(dlib::linspace(-5, 5, 20));
+	dlib::matrix<double> loaded_proba = loaded->predict_proba(input);
+	dlib::matrix<double> expected_proba = expected.predict_proba(input);
+	for (long i = 0; i != input.nr(); ++i) {
+		for (long j = 0; j != 5; ++j) {
+			EXPECT_NEAR(loaded_proba(i, j), expected_proba(i, j), 1e-4);
+		}
+	}
+
+	// a value which isn't an int8 weight
+	dlib::matrix<int> wrong = dlib::matrix_cast<int>(quantized);
+	wrong(0, 2) = 300;
+	dump_matrix<int>(wrong, w1_int8);
+	EXPECT_THROW(MlpClassifier::load_quantized(directory), std::logic_error);
+
+	std::remove(w1_int8.c_str());
+	std::remove(w1_scales.c_str());
+	std::remove(i1.c_str());
+	EXPECT_THROW(MlpClassifier::load_quantized(directory), std::logic_error);
+	rmdir(directory.c_str());
+}
+
+TEST(MlpClassifierTest, quantized_online_model_agrees_with_double) {
+	std::vector<dlib::matrix<double>> weights({load_matrix(ONLINE_MODEL_RES_DIRECTORY "/w1.csv"),
+											   load_matrix(ONLINE_MODEL_RES_DIRECTORY "/w2.csv")});
+	std::vector<dlib::matrix<double>> intercepts({load_matrix(ONLINE_MODEL_RES_DIRECTORY "/i1.csv"),
+												  load_matrix(ONLINE_MODEL_RES_DIRECTORY "/i2.csv")});
+	ASSERT_EQ(weights[0].nr(), 22);
+	ASSERT_EQ(weights[0].nc(), 100);
+	ASSERT_EQ(weights[1].nc(), 4);
+
+	// the online features are standardized, a night of them
+	const long ROWS = 1000;
+	std::mt19937 generator(3);
+	std::normal_distribution<double> distribution(0, 1);
+	dlib::matrix<double> features(ROWS, 22);
+	for (long i = 0; i != ROWS; ++i) {
+		for (long j = 0; j != 22; ++j) {
+			features(i, j) = distribution(generator);
+		}
+	}
+
+	MlpClassifier original(weights, intercepts);
+	MlpClassifier quantized(weights, intercepts, true);
+
+	auto start = std::chrono::steady_clock::now();
+	dlib::matrix<double> expected = original.predict_proba(features);
+	auto middle = std::chrono::steady_clock::now();
+	dlib::matrix<double> actual = quantized.predict_proba(features);
+	auto end = std::chrono::steady_clock::now();
+	std::cout << "online model, double: "
+			  << std::chrono::duration_cast<std::chrono::microseconds>(middle - start).count()
+			  << " us, quantized: "
+			  << std::chrono::duration_cast<std::chrono::microseconds>(end - middle).count()
+			  << " us for " << ROWS << " rows" << std::endl;
+
+	long agreeing = 0;
+	dlib::matrix<int> expected_stages = argmax(expected);
+	dlib::matrix<int> actual_stages = argmax(actual);
+	for (long i = 0; i != ROWS; ++i) {
+		agreeing += expected_stages(i, 0) == actual_stages(i, 0);
+		for (long j = 0; j != 4; ++j) {
+			EXPECT_NEAR(expected(i, j), actual(i, j), 0.02);
+		}
+	}
+	std::cout << "quantized stage agreement: " << agreeing << " / " << ROWS << std::endl;
+	EXPECT_GE(agreeing, 0.98 * ROWS);
+}
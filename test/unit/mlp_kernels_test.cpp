@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "MlpKernels.h"
+
+namespace {
+
+std::vector<double> random_vector(std::mt19937 &generator, long size) {
+	std::normal_distribution<double> normal(0, 1);
+	std::vector<double> result(size);
+	for (double &v : result) {
+		v = normal(generator);
+	}
+	return result;
+}
+
+}
+
+TEST(MlpKernelsTest, dense_layer_equals_naive_product) {
+	std::mt19937 generator(11);
+
+	// the sizes aren't multiples of the block sizes on purpose
+	const long shapes[][3] = {{1, 22, 100}, {7, 22, 100}, {13, 100, 4}, {5, 3, 37}};
+	for (const auto &shape : shapes) {
+		const long rows = shape[0], inputs = shape[1], outputs = shape[2];
+		std::vector<double> input = random_vector(generator, rows * inputs);
+		std::vector<double> weights = random_vector(generator, inputs * outputs);
+		std::vector<double> bias = random_vector(generator, outputs);
+
+		std::vector<double> relu(rows * outputs), identity(rows * outputs), softmax(rows * outputs);
+		mlp_dense_layer(input.data(), rows, inputs, weights.data(), bias.data(), outputs, MlpActivation::RELU, relu.data());
+		mlp_dense_layer(input.data(), rows, inputs, weights.data(), bias.data(), outputs, MlpActivation::IDENTITY, identity.data());
+		mlp_dense_layer(input.data(), rows, inputs, weights.data(), bias.data(), outputs, MlpActivation::SOFTMAX, softmax.data());
+
+		for (long i = 0; i != rows; ++i) {
+			double exp_sum = 0;
+			for (long j = 0; j != outputs; ++j) {
+				double expected = bias[j];
+				for (long k = 0; k != inputs; ++k) {
+					expected += input[i * inputs + k] * weights[k * outputs + j];
+				}
+				exp_sum += std::exp(expected);
+				EXPECT_NEAR(identity[i * outputs + j], expected, 1e-12);
+				EXPECT_NEAR(relu[i * outputs + j], expected < 0 ? 0 : expected, 1e-12);
+			}
+			for (long j = 0; j != outputs; ++j) {
+				EXPECT_NEAR(softmax[i * outputs + j], std::exp(identity[i * outputs + j]) / exp_sum, 1e-12);
+			}
+		}
+	}
+}
+
+TEST(MlpKernelsTest, nans_are_propagated) {
+	std::vector<double> input({NAN, 1});
+	std::vector<double> weights({1, -1, 1, -1});
+	std::vector<double> bias({0, 0});
+	std::vector<double> output(2);
+
+	mlp_dense_layer(input.data(), 1, 2, weights.data(), bias.data(), 2, MlpActivation::RELU, output.data());
+	EXPECT_TRUE(std::isnan(output[0]));
+	EXPECT_TRUE(std::isnan(output[1]));
+}
+
+TEST(MlpKernelsTest, quantized_layer_close_to_double) {
+	std::mt19937 generator(5);
+	const long rows = 9, inputs = 22, outputs = 100;
+	std::vector<double> input = random_vector(generator, rows * inputs);
+	std::vector<double> weights = random_vector(generator, inputs * outputs);
+	std::vector<double> bias = random_vector(generator, outputs);
+
+	std::vector<signed char> quantized(inputs * outputs);
+	std::vector<double> scales(outputs);
+	mlp_quantize_weights(weights.data(), inputs, outputs, quantized.data(), scales.data());
+
+	for (long i = 0; i != inputs * outputs; ++i) {
+		EXPECT_LE(std::abs(quantized[i] * scales[i % outputs] - weights[i]), scales[i % outputs] / 2 + 1e-12);
+	}
+
+	std::vector<double> expected(rows * outputs), actual(rows * outputs);
+	mlp_dense_layer(input.data(), rows, inputs, weights.data(), bias.data(), outputs, MlpActivation::IDENTITY, expected.data());
+	mlp_dense_layer_int8(input.data(), rows, inputs, quantized.data(), scales.data(), bias.data(), outputs,
+						 MlpActivation::IDENTITY, actual.data());
+	for (long i = 0; i != rows * outputs; ++i) {
+		EXPECT_NEAR(actual[i], expected[i], 0.1);
+	}
+}
+
+TEST(MlpKernelsTest, quantized_layer_with_many_inputs) {
+	// more inputs than the products accumulated at once in int32
+	std::mt19937 generator(3);
+	const long rows = 6, inputs = 700, outputs = 40;
+	std::vector<double> input = random_vector(generator, rows * inputs);
+	std::vector<double> weights = random_vector(generator, inputs * outputs);
+	std::vector<double> bias = random_vector(generator, outputs);
+	for (long k = 0; k != inputs; ++k) {
+		// the largest possible products in the first row
+		input[k] = 5;
+		weights[k * outputs] = 4;
+	}
+
+	std::vector<signed char> quantized(inputs * outputs);
+	std::vector<double> scales(outputs);
+	mlp_quantize_weights(weights.data(), inputs, outputs, quantized.data(), scales.data());
+
+	// the weights as they are after the quantization
+	std::vector<double> dequantized(inputs * outputs);
+	for (long i = 0; i != inputs * outputs; ++i) {
+		dequantized[i] = quantized[i] * scales[i % outputs];
+	}
+
+	std::vector<double> expected(rows * outputs), actual(rows * outputs);
+	mlp_dense_layer(input.data(), rows, inputs, dequantized.data(), bias.data(), outputs, MlpActivation::IDENTITY, expected.data());
+	mlp_dense_layer_int8(input.data(), rows, inputs, quantized.data(), scales.data(), bias.data(), outputs,
+						 MlpActivation::IDENTITY, actual.data());
+	EXPECT_NEAR(actual[0], bias[0] + inputs * 5 * 4, 1e-6);
+	for (long i = 0; i != rows * outputs; ++i) {
+		// only the error of the int16 inputs is left
+		EXPECT_NEAR(actual[i], expected[i], 1e-2);
+	}
+}
+
+TEST(MlpKernelsTest, quantized_layer_propagates_nans) {
+	std::vector<double> input({NAN, 1, 0, 0, 2, -1});
+	std::vector<signed char> weights({1, -1, 1, -1});
+	std::vector<double> scales({0.5, 0.25});
+	std::vector<double> bias({0, 1});
+	std::vector<double> output(6);
+
+	mlp_dense_layer_int8(input.data(), 3, 2, weights.data(), scales.data(), bias.data(), 2,
+						 MlpActivation::RELU, output.data());
+	EXPECT_TRUE(std::isnan(output[0]));
+	EXPECT_TRUE(std::isnan(output[1]));
+	// a zero row gives the bias
+	EXPECT_EQ(output[2], 0);
+	EXPECT_EQ(output[3], 1);
+	EXPECT_NEAR(output[4], 0.5, 1e-4);
+	EXPECT_NEAR(output[5], 0.75, 1e-4);
+}
@@ -2,7 +2,9 @@
 #include <gtest/gtest.h>
 #include "x_cube_neural_network.h"
 #include <dlib/matrix.h>
+#include <cmath>
 #include <iostream>
+#include <random>
 
 TEST(MultilayerPerceptronTest, basic_predict_test1) {
 	dlib::matrix<double> input(10, 2);
@@ -120,3 +122,109 @@ TEST(MultilayerPerceptronTest, x_cube_network_test) {
 	delete mlp;
 
 }
+
+namespace {
+
+dlib::matrix<double> random_matrix(long rows, long cols, std::mt19937& generator) {
+	std::normal_distribution<double> distribution(0, 1);
+	dlib::matrix<double> result(rows, cols);
+	for (long i = 0; i != rows; ++i) {
+		for (long j = 0; j != cols; ++j) {
+			result(i, j) = distribution(generator);
+		}
+	}
+	return result;
+}
+
+/*
+ * Computes the network layer by layer with the generic kernel.
+ */
+dlib::matrix<double> generic_forward(const std::vector<dlib::matrix<double>>& weights,
+									 const std::vector<dlib::matrix<double>>& intercepts,
+									 const std::vector<MlpActivation>& activations,
+									 dlib::matrix<double> input) {
+	for (size_t i = 0; i != weights.size(); ++i) {
+		dlib::matrix<double> output(input.nr(), weights[i].nc());
+		mlp_dense_layer(input.begin(), input.nr(), input.nc(), weights[i].begin(), intercepts[i].begin(),
+						weights[i].nc(), activations[i], output.begin());
+		input = output;
+	}
+	return input;
+}
+
+}
+
+TEST(MultilayerPerceptronTest, specialized_shape_equals_generic_kernels) {
+	std::mt19937 generator(7);
+	std::vector<dlib::matrix<double>> weights({random_matrix(22, 100, generator), random_matrix(100, 4, generator)});
+	std::vector<dlib::matrix<double>> intercepts({random_matrix(100, 1, generator), random_matrix(4, 1, generator)});
+	dlib::matrix<double> input = random_matrix(13, 22, generator);
+	input(5, 3) = NAN;
+
+	MultilayerPerceptron mlp(weights, intercepts);
+	ASSERT_TRUE(mlp.is_specialized());
+
+	dlib::matrix<double> expected = generic_forward(weights, intercepts,
+			{MlpActivation::RELU, MlpActivation::SOFTMAX}, input);
+	dlib::matrix<double> actual = mlp.predict_proba(input);
+	for (long i = 0; i != expected.nr(); ++i) {
+		for (long j = 0; j != expected.nc(); ++j) {
+			if (std::isnan(expected(i, j))) {
+				EXPECT_TRUE(std::isnan(actual(i, j)));
+			} else {
+				EXPECT_NEAR(expected(i, j), actual(i, j), 1e-12);
+			}
+		}
+	}
+
+	// the buffers of the first call are reused with fewer rows and the linear output
+	dlib::matrix<double> rows = dlib::rowm(input, dlib::range(0, 2));
+	dlib::matrix<double> expected_linear = generic_forward(weights, intercepts,
+			{MlpActivation::RELU, MlpActivation::IDENTITY}, rows);
+	dlib::matrix<double> actual_linear = mlp.predict(rows);
+	for (long i = 0; i != expected_linear.nr(); ++i) {
+		for (long j = 0; j != expected_linear.nc(); ++j) {
+			EXPECT_NEAR(expected_linear(i, j), actual_linear(i, j), 1e-12);
+		}
+	}
+
+	mlp.quantize();
+	EXPECT_FALSE(mlp.is_specialized());
+	EXPECT_TRUE(mlp.is_quantized());
+
+	// the double weights are gone, quantizing again changes nothing
+	dlib::matrix<double> quantized = mlp.predict_proba(input);
+	mlp.quantize();
+	dlib::matrix<double> quantized_again = mlp.predict_proba(input);
+	for (long i = 0; i != quantized.nr(); ++i) {
+		for (long j = 0; j != quantized.nc(); ++j) {
+			EXPECT_TRUE(quantized(i, j) == quantized_again(i, j) || std::isnan(quantized(i, j)));
+		}
+	}
+}
+
+TEST(MultilayerPerceptronTest, deeper_network_with_custom_activations) {
+	std::mt19937 generator(11);
+	std::vector<dlib::matrix<double>> weights({random_matrix(3, 8, generator),
+											   random_matrix(8, 6, generator),
+											   random_matrix(6, 2, generator)});
+	std::vector<dlib::matrix<double>> intercepts({random_matrix(8, 1, generator),
+												  random_matrix(6, 1, generator),
+												  random_matrix(2, 1, generator)});
+	std::vector<MlpActivation> activations({MlpActivation::RELU, MlpActivation::IDENTITY, MlpActivation::IDENTITY});
+	dlib::matrix<double> input = random_matrix(9, 3, generator);
+
+	MultilayerPerceptron mlp(weights, intercepts);
+	EXPECT_EQ(mlp.layers(), 3);
+	EXPECT_FALSE(mlp.is_specialized());
+	EXPECT_THROW(mlp.set_activations({MlpActivation::RELU}), std::logic_error);
+	mlp.set_activations(activations);
+
+	dlib::matrix<double> expected = generic_forward(weights, intercepts, activations, input);
+	dlib::matrix<double> actual = mlp.predict(input);
+	for (long i = 0; i != expected.nr(); ++i) {
+		for (long j = 0; j != expected.nc(); ++j) {
+			EXPECT_DOUBLE_EQ(expected(i, j), actual(i, j));
+		}
+	}
+}
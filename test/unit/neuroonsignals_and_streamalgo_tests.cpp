@@ -128,6 +128,61 @@ TEST_F(NeuroonSignalsAndStreamAlgoTests, NeuroonSignalsPatFrameConsume) {
   }
 
 }
+TEST_F(NeuroonSignalsAndStreamAlgoTests, NeuroonSignalsDecimatedEeg) {
+
+  NeuroonSignals ns;
+  EXPECT_THROW(ns.decimated_eeg_signal(2), std::logic_error);
+  ns.add_decimated_eeg(2);
+
+  const int N = 20;
+  for(std::size_t i=0;i<N;i++){
+    EegFrame ef;
+    ef.timestamp = i * EegFrame::DefaultEmissionInterval_ms;
+    for(std::size_t j=0; j< EegFrame::Length; j++){
+      ef.signal[j] = 5;
+    }
+    ns.consume(std::make_shared<EegFrame>(ef));
+  }
+
+  EXPECT_EQ(N * EegFrame::Length / 2, ns.total_decimated_eeg_samples(2));
+  EXPECT_EQ(N * EegFrame::Length / 2, ns.decimated_eeg_signal(2).size());
+  // the filter has the unit gain for a constant signal
+  EXPECT_NEAR(5, ns.decimated_eeg_signal(2).back(), 1e-9);
+
+  ns.clear_data();
+  EXPECT_EQ(0, ns.total_decimated_eeg_samples(2));
+  EXPECT_TRUE(ns.decimated_eeg_signal(2).empty());
+}
+
+TEST_F(NeuroonSignalsAndStreamAlgoTests, NeuroonSignalsHighPassedAccelerometer) {
+
+  NeuroonSignals ns;
+
+  // gravity along z and a step along x after 10 s
+  const int N = 1000;
+  for(int i = 0; i < N; i++){
+    PatFrame ef;
+    ef.timestamp = i * PatFrame::DefaultEmissionInterval_ms;
+    ef.ir_led = 0;
+    ef.red_led = 0;
+    ef.accel_axes.x = i < 250 ? 0 : 100;
+    ef.accel_axes.y = 0;
+    ef.accel_axes.z = 1000;
+    ef.temperature[0] = 0;
+    ef.temperature[1] = 0;
+    ns.consume(std::make_shared<PatFrame>(ef));
+  }
+
+  const std::vector<Double3d> & high_passed = ns.accel_axes_high_passed_signal();
+  ASSERT_EQ(ns.accel_axes_signal().size(), high_passed.size());
+  EXPECT_GT(std::abs(high_passed[250].x), 50);
+  EXPECT_NEAR(0, high_passed.back().x, 1);
+  EXPECT_NEAR(0, high_passed.back().z, 1);
+
+  ns.clear_data();
+  EXPECT_TRUE(ns.accel_axes_high_passed_signal().empty());
+}
+
 // TEST_F(NeuroonSignalsAndStreamAlgoTests, TrivialSinkTest) {
 
 //   std::vector<int> v = {};
@@ -14,3 +14,20 @@ TEST(StagingClassifierTest, create_the_classifier_test) {
 	//std::cout << stages;
 }
 
+
+TEST(StagingClassifierTest, smoothed_staging_test) {
+	OfflineStagingClassifier* clf = OfflineStagingClassifier::get_instance();
+
+	const int NUMBER_OF_FEATURES = 7;
+	const int ROWS = 100;
+	dlib::matrix<double> dummy_features(ROWS, NUMBER_OF_FEATURES);
+	dlib::set_all_elements(dummy_features, 0);
+
+	dlib::matrix<int> stages = clf->predict_smoothed(dummy_features);
+	EXPECT_EQ(stages.nr(), ROWS);
+	EXPECT_EQ(stages.nc(), 1);
+
+	dlib::matrix<double> posteriors = clf->predict_posteriors(dummy_features);
+	EXPECT_EQ(posteriors.nr(), ROWS);
+	EXPECT_NEAR(dlib::sum(dlib::rowm(posteriors, 0)), 1, 1e-9);
+}
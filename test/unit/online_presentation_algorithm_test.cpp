@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "OnlinePresentationAlgorithm.h"
+#include "NeuroonSignalStreamApi.h"
+
+namespace {
+
+// every step of the signal brings 80 ms of the EEG and of the IR
+const int STEP_MS = 80;
+const int EEG_PER_STEP = 10;
+const int DECIMATED_EEG_PER_STEP = 5;
+const int IR_PER_STEP = 2;
+
+struct result_sink : public OnlinePresentationAlgorithm::sink_t {
+	std::vector<ncBrainWaveLevels> brain_waves;
+	std::vector<double> pulse;
+	double heart_rate = 0;
+	int calls = 0;
+
+	void setDataSourceDelegate(SinkSetDelegateKey, std::weak_ptr<IDataSourceDelegate>) override {}
+
+	// the result points to the buffers of the algorithm, so it's copied
+	void consume(std::shared_ptr<OnlinePresentationResult> result) override {
+		++calls;
+		brain_waves.assign(result->brain_waves, result->brain_waves + result->bw_size);
+		pulse.assign(result->pulse_data, result->pulse_data + result->pd_size);
+		heart_rate = result->heart_rate;
+	}
+};
+
+struct mock_signals : public INeuroonSignals {
+	int m_step = 0;
+	std::vector<double> m_eeg;
+	std::vector<double> m_decimated_eeg;
+	std::vector<double> m_ir;
+	std::mt19937 m_generator{5};
+
+	void next_step() {
+		++m_step;
+		std::normal_distribution<double> noise(0, 50);
+		for (int i = 0; i != EEG_PER_STEP; ++i) {
+			m_eeg.push_back(noise(m_generator));
+		}
+		for (int i = 0; i != DECIMATED_EEG_PER_STEP; ++i) {
+			m_decimated_eeg.push_back(noise(m_generator));
+		}
+		for (int i = 0; i != IR_PER_STEP; ++i) {
+			double t = (m_step * IR_PER_STEP + i) / 25.;
+			m_ir.push_back(1000 * std::sin(2 * M_PI * 1.2 * t) + noise(m_generator));
+		}
+	}
+
+	const std::vector<double> &eeg_signal() const override { return m_eeg; }
+	const std::vector<double> &ir_led_signal() const override { return m_ir; }
+	const std::vector<double> &red_led_signal() const override { throw std::logic_error("not implemented"); }
+	const std::vector<Double3d> &accel_axes_signal() const override { throw std::logic_error("not implemented"); }
+	const std::vector<double> &temperature_signal() const override { throw std::logic_error("not implemented"); }
+
+	ullong last_timestamp(SignalOrigin) const override { return m_step * STEP_MS; }
+
+	std::size_t total_signal_samples(SignalOrigin so) const override {
+		return so == SignalOrigin::EEG ? m_eeg.size() : m_ir.size();
+	}
+
+	const std::vector<double> &decimated_eeg_signal(int factor) const override { return m_decimated_eeg; }
+	std::size_t total_decimated_eeg_samples(int factor) const override { return m_decimated_eeg.size(); }
+};
+
+// the levels are NaN until the smoothing window fills
+void expect_same_level(double expected, double actual) {
+	if (std::isnan(expected)) {
+		EXPECT_TRUE(std::isnan(actual));
+	} else {
+		EXPECT_EQ(expected, actual);
+	}
+}
+
+}
+
+TEST(OnlinePresentationAlgorithmTest, updates_are_coalesced_to_the_max_rate) {
+	const int STEPS = 251;
+	const double RATE = 5;
+
+	result_sink every_update;
+	result_sink limited;
+	OnlinePresentationAlgorithm unlimited_algorithm({&every_update});
+	OnlinePresentationAlgorithm limited_algorithm({&limited});
+	unlimited_algorithm.set_max_results_rate(0);
+	limited_algorithm.set_max_results_rate(RATE);
+	unlimited_algorithm.activate();
+	limited_algorithm.activate();
+
+	mock_signals signals;
+	int last_limited_calls = 0;
+	ullong last_call_timestamp = 0;
+	for (int step = 0; step != STEPS; ++step) {
+		signals.next_step();
+		unlimited_algorithm.process_input(signals);
+		limited_algorithm.process_input(signals);
+
+		// a call at most every 200 ms, each one with all the updates so far
+		if (limited.calls != last_limited_calls) {
+			if (last_limited_calls != 0) {
+				EXPECT_GE(signals.last_timestamp(SignalOrigin::EEG), last_call_timestamp + 1000 / RATE);
+			}
+			last_limited_calls = limited.calls;
+			last_call_timestamp = signals.last_timestamp(SignalOrigin::EEG);
+			EXPECT_EQ(limited.brain_waves.size(), every_update.brain_waves.size());
+			EXPECT_EQ(limited.pulse, every_update.pulse);
+		}
+	}
+
+	// 20 s of the signal, the updates of 3 steps are merged into one call
+	EXPECT_EQ(every_update.calls, STEPS);
+	EXPECT_EQ(limited.calls, (STEPS + 2) / 3);
+
+	// the last updates are passed at the end, so nothing is lost
+	unlimited_algorithm.end_streaming(signals);
+	limited_algorithm.end_streaming(signals);
+	EXPECT_EQ(every_update.calls, STEPS);
+	EXPECT_EQ(limited.calls, (STEPS + 2) / 3 + 1);
+
+	ASSERT_GT(every_update.brain_waves.size(), 0u);
+	ASSERT_EQ(limited.brain_waves.size(), every_update.brain_waves.size());
+	for (std::size_t i = 0; i != limited.brain_waves.size(); ++i) {
+		expect_same_level(every_update.brain_waves[i].delta, limited.brain_waves[i].delta);
+		expect_same_level(every_update.brain_waves[i].beta, limited.brain_waves[i].beta);
+	}
+	EXPECT_EQ(limited.pulse, every_update.pulse);
+	EXPECT_EQ(limited.heart_rate, every_update.heart_rate);
+}
+
+TEST(OnlinePresentationAlgorithmTest, nothing_is_passed_when_inactive) {
+	result_sink sink;
+	OnlinePresentationAlgorithm algorithm({&sink});
+	mock_signals signals;
+	for (int step = 0; step != 10; ++step) {
+		signals.next_step();
+		algorithm.process_input(signals);
+	}
+	algorithm.end_streaming(signals);
+	EXPECT_EQ(sink.calls, 0);
+}
+
+TEST(OnlinePresentationAlgorithmTest, api_accepts_only_valid_rates) {
+	ncNeuroonSignalProcessingState* state = ncInitializeNeuroonAlgCore(
+			[](const ncStagingElement*, int) {},
+			[](const ncSignalQuality*, unsigned int) {},
+			[](const ncBrainWaveLevels*, int, double, const double*, int) {});
+	ASSERT_TRUE(state != nullptr);
+
+	EXPECT_TRUE(ncSetPresentationMaxRate(state, 0));
+	EXPECT_TRUE(ncSetPresentationMaxRate(state, 12.5));
+	EXPECT_FALSE(ncSetPresentationMaxRate(state, -1));
+	EXPECT_FALSE(ncSetPresentationMaxRate(state, NAN));
+
+	ncDestroyNeuroonAlgCore(state);
+}
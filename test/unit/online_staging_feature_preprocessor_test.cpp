@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include <dlib/matrix.h>
+#include <cmath>
+#include <random>
+
+#include "OnlineStagingFeaturePreprocessor.h"
+#include "EegBandFeatures.h"
+#include "Spectrogram.h"
+
+namespace {
+
+const int EEG_WINDOW = 10 * 1024;
+const int IR_WINDOW = 2048;
+const double EEG_FS = 125;
+const double IR_FS = 25;
+
+// the column of the IR feature, right after the EEG ones
+const long IR_COLUMN = EegBandFeatures::NUMBER_OF_FEATURES;
+
+Spectrogram noise_spectrogram(int samples, double fs, std::mt19937& generator) {
+	std::normal_distribution<double> noise(0, 100);
+	dlib::matrix<double> signal(samples, 1);
+	for (int i = 0; i != samples; ++i) {
+		signal(i, 0) = noise(generator);
+	}
+	return Spectrogram(signal, fs, samples);
+}
+
+}
+
+TEST(OnlineStagingFeaturePreprocessorTest, short_ir_windows_are_left_out) {
+	std::mt19937 generator(11);
+	OnlineStagingFeaturePreprocessor warmed_up(true);
+	OnlineStagingFeaturePreprocessor full_only(true);
+
+	// the warm-up windows of the IR are NaN, while the EEG features are defined
+	for (int window = 128; window < IR_WINDOW; window *= 2) {
+		dlib::matrix<double> features = warmed_up.transform(
+				noise_spectrogram(window * 5, EEG_FS, generator),
+				noise_spectrogram(window, IR_FS, generator), 60).features;
+		EXPECT_TRUE(std::isnan(features(0, IR_COLUMN))) << "window " << window;
+		EXPECT_TRUE(std::isfinite(features(0, 0))) << "window " << window;
+	}
+
+	// and they don't change the IR statistics of the full windows
+	double actual = NAN;
+	for (int step = 0; step != 5; ++step) {
+		Spectrogram eeg = noise_spectrogram(EEG_WINDOW, EEG_FS, generator);
+		Spectrogram ir = noise_spectrogram(IR_WINDOW, IR_FS, generator);
+		double expected = full_only.transform(eeg, ir, 600).features(0, IR_COLUMN);
+		actual = warmed_up.transform(eeg, ir, 600).features(0, IR_COLUMN);
+		if (std::isnan(expected)) {
+			EXPECT_TRUE(std::isnan(actual)) << "step " << step;
+		} else {
+			EXPECT_DOUBLE_EQ(expected, actual) << "step " << step;
+		}
+	}
+	EXPECT_TRUE(std::isfinite(actual));
+}
@@ -2,7 +2,9 @@
 #include <vector>
 #include <stdexcept>
 #include "OnLineViterbiSearch.h"
+#include <cmath>
 #include <cstdlib>
+#include <random>
 
 void print_sequence(const std::vector<int> seq) {
 	for (auto e : seq) {
@@ -11,6 +13,105 @@ void print_sequence(const std::vector<int> seq) {
 	std::cout << std::endl;
 }
 
+namespace {
+
+/*
+ * The plain Viterbi algorithm over the whole sequence of emissions.
+ */
+std::vector<int> full_viterbi(const std::vector<std::vector<double>>& emissions, const dlib::matrix<double>& start_p,
+							  const dlib::matrix<double>& transitions) {
+	const size_t n_states = start_p.nr();
+	std::vector<std::vector<double>> log_probs(emissions.size(), std::vector<double>(n_states));
+	std::vector<std::vector<int>> previous(emissions.size(), std::vector<int>(n_states, -1));
+	for (size_t state = 0; state != n_states; ++state) {
+		log_probs[0][state] = std::log(emissions[0][state]) + std::log(start_p(state, 0));
+	}
+	for (size_t t = 1; t != emissions.size(); ++t) {
+		for (size_t next = 0; next != n_states; ++next) {
+			double best = -std::numeric_limits<double>::infinity();
+			for (size_t state = 0; state != n_states; ++state) {
+				double log_prob = log_probs[t - 1][state] + std::log(transitions(state, next));
+				if (log_prob > best) {
+					best = log_prob;
+					previous[t][next] = state;
+				}
+			}
+			log_probs[t][next] = best + std::log(emissions[t][next]);
+		}
+	}
+
+	std::vector<int> result(emissions.size());
+	int state = std::max_element(log_probs.back().begin(), log_probs.back().end()) - log_probs.back().begin();
+	for (size_t t = emissions.size(); t-- > 0; ) {
+		result[t] = state;
+		state = previous[t][state];
+	}
+	return result;
+}
+
+}
+
+TEST(OnLineViterbiSearchTest, equals_full_viterbi_and_reports_changed_suffix) {
+	const int N_STATES = 4;
+	std::vector<int> states({0, 1, 2, 3});
+	dlib::matrix<double> start_p(N_STATES, 1);
+	dlib::set_all_elements(start_p, 0.25);
+	dlib::matrix<double> final_p = start_p;
+	dlib::matrix<double> transitions(N_STATES, N_STATES);
+	dlib::set_all_elements(transitions, 0.1 / 3);
+	for (int i = 0; i != N_STATES; ++i) {
+		transitions(i, i) = 0.9;
+	}
+
+	std::mt19937 generator(3);
+	std::uniform_real_distribution<double> uniform(0.05, 1);
+	OnLineViterbiSearch viterbi(states, start_p, final_p, transitions);
+
+	std::vector<std::vector<double>> emissions;
+	std::vector<int> previous;
+	for (int t = 0; t != 1000; ++t) {
+		dlib::matrix<double> emission(N_STATES, 1);
+		for (int i = 0; i != N_STATES; ++i) {
+			emission(i, 0) = uniform(generator);
+		}
+		emission((t / 40) % N_STATES, 0) += 0.5;
+		emissions.push_back(std::vector<double>(emission.begin(), emission.end()));
+
+		viterbi.step(emission);
+		const std::vector<int>& sequence = viterbi.sequence();
+		ASSERT_EQ(sequence, full_viterbi(emissions, start_p, transitions));
+
+		ASSERT_LE(viterbi.first_changed(), previous.size());
+		EXPECT_TRUE(std::equal(sequence.begin(), sequence.begin() + viterbi.first_changed(), previous.begin()));
+		EXPECT_LE(viterbi.committed(), sequence.size());
+		previous = sequence;
+	}
+
+	// the paths converge long before the end of the sequence
+	EXPECT_GT(viterbi.committed(), 900);
+}
+
+TEST(OnLineViterbiSearchTest, tail_is_limited_by_the_lag) {
+	std::vector<int> states({0, 1});
+	dlib::matrix<double> start_p(2, 1);
+	dlib::set_all_elements(start_p, 0.5);
+	dlib::matrix<double> transitions = dlib::identity_matrix<double>(2);
+
+	// the states never change and the emissions don't distinguish them,
+	// so the paths never converge
+	const int MAX_LAG = 5;
+	OnLineViterbiSearch viterbi(states, start_p, start_p, transitions, 1, MAX_LAG);
+	dlib::matrix<double> emission(2, 1);
+	dlib::set_all_elements(emission, 0.5);
+	for (int t = 0; t != 20; ++t) {
+		viterbi.step(emission);
+		EXPECT_EQ(viterbi.sequence().size(), t + 1);
+		EXPECT_GE(viterbi.committed() + MAX_LAG, viterbi.sequence().size());
+	}
+
+	EXPECT_THROW(OnLineViterbiSearch(states, start_p, start_p, transitions, 1, 0), std::logic_error);
+}
+
 TEST(OnLineViterbiSearchTest, basic_test1) {
 	std::vector<int> states({0, 1, 2, 3});
 	dlib::matrix<double> start_p(states.size(), 1);
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "PerformanceCounters.h"
+
+TEST(PerformanceCountersTest, buckets_cover_the_times_with_bounded_error) {
+	// the small times are exact
+	for (unsigned long long ns = 0; ns != 2 * PerformanceCounters::SUB_BUCKETS; ++ns) {
+		EXPECT_EQ(PerformanceCounters::bucket(ns), static_cast<int>(ns));
+		EXPECT_EQ(PerformanceCounters::bucket_upper_bound(ns), ns);
+	}
+
+	int previous = 0;
+	for (unsigned long long ns = 1; ns < (1ull << 40); ns = ns * 9 / 8 + 1) {
+		int bucket = PerformanceCounters::bucket(ns);
+		ASSERT_GE(bucket, previous);
+		ASSERT_LT(bucket, PerformanceCounters::BUCKETS);
+		previous = bucket;
+
+		if (ns < (1ull << PerformanceCounters::MAX_EXPONENT)) {
+			unsigned long long upper = PerformanceCounters::bucket_upper_bound(bucket);
+			EXPECT_GE(upper, ns);
+			EXPECT_LE(upper - ns, ns / PerformanceCounters::SUB_BUCKETS);
+			EXPECT_EQ(PerformanceCounters::bucket(upper), bucket);
+			EXPECT_EQ(PerformanceCounters::bucket(upper + 1), bucket + 1);
+		}
+	}
+	EXPECT_EQ(PerformanceCounters::bucket(~0ull), PerformanceCounters::BUCKETS - 1);
+}
+
+TEST(PerformanceCountersTest, counts_and_percentiles) {
+	PerformanceCounters::reset();
+	for (unsigned long long ms = 1; ms <= 100; ++ms) {
+		PerformanceCounters::record(NC_PERF_MLP, ms * 1000000);
+	}
+	PerformanceCounters::record(NC_PERF_VITERBI, 5000);
+
+	std::vector<PerformanceCounters::StageStats> stats = PerformanceCounters::stats();
+	ASSERT_EQ(stats.size(), NC_PERF_STAGES_COUNT);
+	EXPECT_EQ(stats[NC_PERF_SPECTROGRAM].calls, 0);
+	EXPECT_EQ(stats[NC_PERF_VITERBI].calls, 1);
+
+	ncPerformanceStats mlp = PerformanceCounters::summary(NC_PERF_MLP, stats[NC_PERF_MLP]);
+	EXPECT_EQ(mlp.stage, NC_PERF_MLP);
+	EXPECT_EQ(mlp.calls, 100);
+	EXPECT_DOUBLE_EQ(mlp.total_ms, 5050);
+	EXPECT_DOUBLE_EQ(mlp.max_ms, 100);
+	EXPECT_GE(mlp.p50_ms, 50);
+	EXPECT_LE(mlp.p50_ms, 50 * 1.125);
+	EXPECT_GE(mlp.p90_ms, 90);
+	EXPECT_LE(mlp.p90_ms, 90 * 1.125);
+	EXPECT_GE(mlp.p99_ms, 99);
+	EXPECT_LE(mlp.p99_ms, 100);
+
+	PerformanceCounters::reset();
+	stats = PerformanceCounters::stats();
+	EXPECT_EQ(stats[NC_PERF_MLP].calls, 0);
+	EXPECT_EQ(PerformanceCounters::summary(NC_PERF_MLP, stats[NC_PERF_MLP]).p50_ms, 0);
+}
+
+TEST(PerformanceCountersTest, sums_the_threads) {
+	PerformanceCounters::reset();
+	const int THREADS = 4;
+	const int CALLS = 1000;
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t != THREADS; ++t) {
+		threads.emplace_back([]() {
+			for (int i = 0; i != CALLS; ++i) {
+				ScopedPerformanceTimer timer(NC_PERF_FEATURES);
+			}
+		});
+	}
+	// reading while the threads are recording
+	for (int i = 0; i != 10; ++i) {
+		EXPECT_LE(PerformanceCounters::stats()[NC_PERF_FEATURES].calls, THREADS * CALLS);
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	// the counters of the finished threads are kept
+	EXPECT_EQ(PerformanceCounters::stats()[NC_PERF_FEATURES].calls, THREADS * CALLS);
+
+	// the reset drops the counters of the finished threads too
+	std::thread late([]() {
+		PerformanceCounters::record(NC_PERF_SINKS, 10);
+	});
+	late.join();
+	PerformanceCounters::reset();
+	PerformanceCounters::record(NC_PERF_SINKS, 20);
+	std::vector<PerformanceCounters::StageStats> stats = PerformanceCounters::stats();
+	EXPECT_EQ(stats[NC_PERF_FEATURES].calls, 0);
+	EXPECT_EQ(stats[NC_PERF_SINKS].calls, 1);
+	EXPECT_EQ(stats[NC_PERF_SINKS].max_ns, 20);
+}
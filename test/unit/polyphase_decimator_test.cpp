@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "PolyphaseDecimator.h"
+
+namespace {
+
+/*
+ * The impulse response of the whole filter, recovered from the outputs
+ * for the impulses at each of the phases
+ */
+std::vector<double> impulse_response(int factor, int taps_per_phase) {
+	const int taps = factor * taps_per_phase;
+	std::vector<double> h(taps);
+	for (int k = 0; k != factor; ++k) {
+		PolyphaseDecimator decimator(factor, taps_per_phase);
+		std::vector<double> input(2 * taps, 0.);
+		input[k] = 1;
+		std::vector<double> output;
+		decimator.process(input.data(), input.size(), output);
+
+		// output m is computed at the input sample m * factor + factor - 1
+		for (std::size_t m = 0; m != output.size(); ++m) {
+			int i = m * factor + factor - 1 - k;
+			if (i >= 0 && i < taps) {
+				h[i] = output[m];
+			}
+		}
+	}
+	return h;
+}
+
+double sine_amplitude(int factor, double frequency, double fs) {
+	PolyphaseDecimator decimator(factor);
+	std::vector<double> input(static_cast<int>(20 * fs));
+	for (std::size_t i = 0; i != input.size(); ++i) {
+		input[i] = std::sin(2 * M_PI * frequency * i / fs);
+	}
+	std::vector<double> output;
+	decimator.process(input.data(), input.size(), output);
+
+	double sum_of_squares = 0;
+	std::size_t half = output.size() / 2;
+	for (std::size_t i = half; i != output.size(); ++i) {
+		sum_of_squares += output[i] * output[i];
+	}
+	return std::sqrt(2 * sum_of_squares / (output.size() - half));
+}
+
+}
+
+TEST(PolyphaseDecimatorTest, same_as_filtering_and_downsampling) {
+	const int FACTOR = 3;
+	const int TAPS_PER_PHASE = 5;
+	std::vector<double> h = impulse_response(FACTOR, TAPS_PER_PHASE);
+
+	// linear phase and the unit gain at 0 Hz
+	double sum = 0;
+	for (std::size_t i = 0; i != h.size(); ++i) {
+		EXPECT_NEAR(h[i], h[h.size() - 1 - i], 1e-12);
+		sum += h[i];
+	}
+	EXPECT_NEAR(sum, 1, 1e-12);
+
+	std::mt19937 generator(5);
+	std::normal_distribution<double> noise(0, 1);
+	std::vector<double> input(1000);
+	for (double& x : input) {
+		x = noise(generator);
+	}
+
+	// fed in uneven chunks
+	PolyphaseDecimator decimator(FACTOR, TAPS_PER_PHASE);
+	std::vector<double> output;
+	for (std::size_t begin = 0; begin < input.size(); begin += 7) {
+		decimator.process(input.data() + begin, std::min<std::size_t>(7, input.size() - begin), output);
+	}
+	ASSERT_EQ(output.size(), input.size() / FACTOR);
+
+	for (std::size_t m = 0; m != output.size(); ++m) {
+		int n = m * FACTOR + FACTOR - 1;
+		double expected = 0;
+		for (int i = 0; i != static_cast<int>(h.size()) && i <= n; ++i) {
+			expected += h[i] * input[n - i];
+		}
+		ASSERT_NEAR(output[m], expected, 1e-12) << "output " << m;
+	}
+}
+
+TEST(PolyphaseDecimatorTest, passes_the_low_and_stops_the_aliased_frequencies) {
+	const double FS = 125;
+	const int FACTOR = 2;
+
+	EXPECT_NEAR(sine_amplitude(FACTOR, 5, FS), 1, 0.01);
+	EXPECT_NEAR(sine_amplitude(FACTOR, 20, FS), 1, 0.02);
+
+	// would alias to 17.5 Hz
+	EXPECT_LT(sine_amplitude(FACTOR, 45, FS), 0.01);
+
+	// flat up to 28 Hz, nothing aliased from right above the 31.25 Hz Nyquist frequency
+	EXPECT_NEAR(sine_amplitude(FACTOR, 28, FS), 1, 0.01);
+	EXPECT_LT(sine_amplitude(FACTOR, 31.5, FS), 0.005);
+	EXPECT_LT(sine_amplitude(FACTOR, 33, FS), 0.005);
+}
+
+TEST(PolyphaseDecimatorTest, reset_and_invalid_parameters) {
+	PolyphaseDecimator decimator(2);
+	std::vector<double> input({1, 2, 3, 4, 5});
+	std::vector<double> first;
+	decimator.process(input.data(), input.size(), first);
+
+	decimator.reset();
+	std::vector<double> second;
+	decimator.process(input.data(), input.size(), second);
+	EXPECT_EQ(first, second);
+
+	EXPECT_THROW(PolyphaseDecimator(0), std::logic_error);
+	EXPECT_THROW(PolyphaseDecimator(2, 16, 1.5), std::logic_error);
+}
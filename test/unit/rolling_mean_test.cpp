@@ -21,3 +21,20 @@ TEST(RollingMeanTest, basic_case) {
 	EXPECT_EQ(one * 4, rm.value());
 
 }
+
+TEST(RollingMeanTest, partial_window) {
+	const int COLS = 10;
+	dlib::matrix<double> one = dlib::ones_matrix<double>(1, 10);
+
+	RollingMean rm(3, COLS, true);
+	EXPECT_FALSE(dlib::is_finite(rm.value()));
+
+	rm.feed(1 * one);
+	EXPECT_EQ(one * 1, rm.value());
+	rm.feed(2 * one);
+	EXPECT_EQ(one * 1.5, rm.value());
+	rm.feed(3 * one);
+	EXPECT_EQ(one * 2, rm.value());
+	rm.feed(4 * one);
+	EXPECT_EQ(one * 3, rm.value());
+}
@@ -1,8 +1,11 @@
 #include <gtest/gtest.h>
 #include "dlib_utils.h"
+#include "fast_math.h"
 #include <iostream>
 #include <algorithm>
 #include <numeric>
+#include <random>
+#include <cmath>
 //TODO: write tests for all functions in singal_utils header
 
 
@@ -56,3 +59,89 @@ TEST(SignalUtilsTest, basic_range_to_dlib_matrix) {
 	}
 
 }
+
+TEST(SignalUtilsTest, finite_rows_mask_agrees_with_nonnan_rows) {
+	dlib::matrix<double> input(6, 2);
+	input = 1, 2,
+			NAN, 3,
+			4, 5,
+			6, INFINITY,
+			7, 8,
+			NAN, NAN;
+
+	dlib::matrix<unsigned char> mask = finite_rows_mask(input);
+	dlib::matrix<int> rows = nonnan_rows(input);
+
+	ASSERT_EQ(count_selected(mask), rows.nr());
+	EXPECT_EQ(rows(0, 0), 0);
+	EXPECT_EQ(rows(1, 0), 2);
+	EXPECT_EQ(rows(2, 0), 4);
+	EXPECT_DOUBLE_EQ(nan_ratio(input), 0.5);
+}
+
+TEST(SignalUtilsTest, compact_and_expand_rows) {
+	dlib::matrix<double> input(5, 1);
+	input = 1, NAN, 3, NAN, 5;
+
+	dlib::matrix<unsigned char> mask = finite_rows_mask(input);
+	dlib::matrix<double> compacted = compact_rows(input, mask);
+	ASSERT_EQ(compacted.nr(), 3);
+	EXPECT_DOUBLE_EQ(compacted(0, 0), 1);
+	EXPECT_DOUBLE_EQ(compacted(1, 0), 3);
+	EXPECT_DOUBLE_EQ(compacted(2, 0), 5);
+
+	dlib::matrix<double> expanded = expand_rows(compacted, mask, -1);
+	ASSERT_EQ(expanded.nr(), input.nr());
+	EXPECT_DOUBLE_EQ(expanded(0, 0), 1);
+	EXPECT_DOUBLE_EQ(expanded(1, 0), -1);
+	EXPECT_DOUBLE_EQ(expanded(2, 0), 3);
+	EXPECT_DOUBLE_EQ(expanded(3, 0), -1);
+	EXPECT_DOUBLE_EQ(expanded(4, 0), 5);
+}
+
+TEST(SignalUtilsTest, greater_than_mask_sets_selected_rows) {
+	dlib::matrix<double> filter(4, 1);
+	filter = 1, 10, NAN, 20;
+	dlib::matrix<double> data = dlib::ones_matrix<double>(4, 3);
+
+	dlib::matrix<unsigned char> mask = greater_than_mask(filter, 5);
+	EXPECT_EQ(count_selected(mask), rows_greater_than(filter, 5).nr());
+	set_selected_rows(data, mask, NAN);
+
+	for (int j = 0; j != data.nc(); ++j) {
+		EXPECT_DOUBLE_EQ(data(0, j), 1);
+		EXPECT_TRUE(std::isnan(data(1, j)));
+		EXPECT_DOUBLE_EQ(data(2, j), 1);
+		EXPECT_TRUE(std::isnan(data(3, j)));
+	}
+}
+
+TEST(SignalUtilsTest, fast_log_accuracy) {
+	std::vector<double> values({1e-300, 1e-20, 0.001, 0.5, 0.70710678, 0.9999, 1, 1.0001,
+								1.41421356, 1.5, 2, 3, 123.456, 1e20, 1e300});
+	for (double v : values) {
+		EXPECT_NEAR(fast_log(v), std::log(v), 1e-9) << v;
+	}
+}
+
+TEST(SignalUtilsTest, row_entropies_equal_entropy) {
+	std::mt19937 generator(3);
+	std::uniform_real_distribution<double> uniform(0.001, 1000);
+
+	dlib::matrix<double> data(50, 16);
+	for (int i = 0; i != data.nr(); ++i) {
+		for (int j = 0; j != data.nc(); ++j) {
+			data(i, j) = uniform(generator);
+		}
+	}
+	data(1, 3) = NAN;
+
+	dlib::matrix<double> entropies = row_entropies(data);
+	ASSERT_EQ(entropies.nr(), data.nr());
+	EXPECT_TRUE(std::isnan(entropies(1, 0)));
+	for (int i = 0; i != data.nr(); ++i) {
+		if (i != 1) {
+			EXPECT_NEAR(entropies(i, 0), entropy(dlib::rowm(data, i)), 1e-8);
+		}
+	}
+}
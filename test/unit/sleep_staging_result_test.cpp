@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "OnlineStagingAlgorithm.h"
+
+TEST(SleepStagingResultTest, deltas_rebuild_the_whole_staging) {
+	std::vector<int> stages({0, 1, 2});
+	std::vector<int> quality({0, 1, 2, 3, 4});
+	std::vector<ncBrainWaveLevels> brain_waves(5);
+	std::vector<ullong> timestamps({10, 20, 30, 40, 50});
+	std::vector<double> heart_rates({0, 60, 61, 62, 63});
+	std::vector<ncMovementDescription> movements({{0, 0, 0}, {0.01, 0, 0}, {0.2, 1, 1}, {0, 0, 0}, {0.07, 0, 1}});
+
+	std::vector<ncStagingElement> staging;
+	SleepStagingResult(stages, quality, brain_waves, timestamps, heart_rates, movements).apply_to(staging);
+	ASSERT_EQ(staging.size(), 3);
+
+	// the last stage revised, two appended
+	stages = {0, 1, 3, 3, 3};
+	SleepStagingResult delta(stages, quality, brain_waves, timestamps, heart_rates, movements, 2, 1);
+	EXPECT_EQ(delta.m_stages.size(), 3);
+	EXPECT_EQ(delta.m_first_index, 2);
+	EXPECT_EQ(delta.m_total_size, 5);
+	EXPECT_EQ(delta.m_committed, 1);
+
+	delta.apply_to(staging);
+	ASSERT_EQ(staging.size(), stages.size());
+	for (size_t i = 0; i != stages.size(); ++i) {
+		EXPECT_EQ(staging[i].stage, stages[i]);
+		EXPECT_EQ(staging[i].timestamp, timestamps[i]);
+		EXPECT_EQ(staging[i].signal_quality, quality[i]);
+		EXPECT_EQ(staging[i].heart_rate, heart_rates[i]);
+		EXPECT_EQ(staging[i].movement.activity, movements[i].activity);
+		EXPECT_EQ(staging[i].movement.posture_changes, movements[i].posture_changes);
+		EXPECT_EQ(staging[i].movement.gross_movement, movements[i].gross_movement);
+	}
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+#include "OnlineStagingAlgorithm.h"
+#include "Snapshot.h"
+#include "StagingSnapshot.h"
+
+TEST(SnapshotTest, empty_until_published) {
+  Snapshot<int> snapshot;
+  EXPECT_EQ(snapshot.latest(), nullptr);
+
+  snapshot.publish(std::make_shared<const int>(5));
+  EXPECT_EQ(*snapshot.latest(), 5);
+
+  snapshot.clear();
+  EXPECT_EQ(snapshot.latest(), nullptr);
+}
+
+TEST(SnapshotTest, readers_see_consistent_values) {
+  Snapshot<std::vector<int>> snapshot;
+  std::atomic<bool> done(false);
+
+  // every published vector is filled with its size
+  std::thread writer([&]() {
+    for (int i = 1; i != 2000; ++i) {
+      snapshot.publish(std::make_shared<const std::vector<int>>(i, i));
+    }
+    done = true;
+  });
+
+  std::vector<std::thread> readers;
+  std::atomic<int> inconsistent(0);
+  for (int r = 0; r != 3; ++r) {
+    readers.emplace_back([&]() {
+      while (!done) {
+        std::shared_ptr<const std::vector<int>> value = snapshot.latest();
+        if (!value) {
+          continue;
+        }
+        for (int element : *value) {
+          if (element != static_cast<int>(value->size())) {
+            ++inconsistent;
+          }
+        }
+      }
+    });
+  }
+
+  writer.join();
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(inconsistent, 0);
+  EXPECT_EQ(snapshot.latest()->size(), 1999);
+}
+
+TEST(StagingSnapshotTest, deltas_share_the_committed_chunks) {
+  std::mt19937 generator(3);
+  std::vector<ncStagingElement> expected;
+  std::shared_ptr<const StagingSnapshot> snapshot;
+
+  // every step appends an element and revises the last few, which aren't
+  // committed yet, as the online staging does; the staging is reset once
+  const std::size_t REVISED = 5;
+  int timestamp = 0;
+  for (int step = 0; step != 1500; ++step) {
+    if (step == 1000) {
+      expected.clear();
+    }
+    SleepStagingResult delta;
+    delta.m_total_size = expected.size() + 1;
+    delta.m_first_index =
+        expected.size() > REVISED ? expected.size() - REVISED : 0;
+    delta.m_committed = delta.m_first_index;
+    for (std::size_t i = delta.m_first_index; i != delta.m_total_size; ++i) {
+      ncStagingElement element = ncStagingElement();
+      element.stage = static_cast<ncSleepStage>(generator() % 4);
+      element.timestamp = ++timestamp;
+      delta.m_stages.push_back(element);
+    }
+    delta.apply_to(expected);
+
+    std::shared_ptr<const StagingSnapshot> previous = snapshot;
+    snapshot = StagingSnapshot::apply(previous.get(), delta);
+
+    ASSERT_EQ(snapshot->size(), expected.size());
+    EXPECT_EQ(snapshot->committed, delta.m_committed);
+    EXPECT_LT(snapshot->tail.size(), StagingSnapshot::CHUNK_SIZE + REVISED + 1);
+    for (std::size_t i = 0; i != expected.size(); ++i) {
+      ASSERT_EQ(snapshot->at(i).timestamp, expected[i].timestamp) << "step " << step;
+      ASSERT_EQ(snapshot->at(i).stage, expected[i].stage) << "step " << step;
+    }
+    if (previous && step != 1000) {
+      for (std::size_t c = 0; c != previous->chunks.size(); ++c) {
+        EXPECT_EQ(previous->chunks[c], snapshot->chunks[c]);
+      }
+    }
+  }
+  EXPECT_EQ(snapshot->chunks.size(), (500 - 1 - REVISED) / StagingSnapshot::CHUNK_SIZE);
+
+  std::vector<ncStagingElement> buffer(expected.size() + 10);
+  EXPECT_EQ(snapshot->copy_to(buffer.data(), buffer.size()), expected.size());
+  EXPECT_EQ(snapshot->copy_to(buffer.data(), 300), 300);
+  for (std::size_t i = 0; i != 300; ++i) {
+    EXPECT_EQ(buffer[i].timestamp, expected[i].timestamp);
+  }
+}
@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include <dlib/matrix.h>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "MlpClassifier.h"
+#include "ModelRegistry.h"
+#include "StagingModel.h"
+#include "StagingModelBuilder.h"
+#include "StagingPreprocessor.h"
+#include "dlib_utils.h"
+
+namespace {
+
+dlib::matrix<double> sequence(long rows, long cols, double start) {
+	dlib::matrix<double> result(rows, cols);
+	for (long i = 0; i != rows; ++i) {
+		for (long j = 0; j != cols; ++j) {
+			result(i, j) = start + 0.1 * (i * cols + j) - 1;
+		}
+	}
+	return result;
+}
+
+}
+
+TEST(StagingModelTest, mapped_file_equals_the_source) {
+	dlib::matrix<double> w1 = sequence(3, 5, 0.5);
+	dlib::matrix<double> i1 = sequence(5, 1, -0.2);
+	dlib::matrix<int> classes(1, 3);
+	classes(0, 0) = -4;
+	classes(0, 1) = -1;
+	classes(0, 2) = 0;
+
+	const std::string filename = "staging_model_test.bin";
+	StagingModelBuilder().add("w1", w1).add("i1", i1).add("classes", classes).write(filename);
+	std::shared_ptr<const StagingModel> model = StagingModel::load(filename);
+
+	ASSERT_TRUE(model->has("w1"));
+	EXPECT_FALSE(model->has("w2"));
+	EXPECT_EQ(model->layers(), 1);
+
+	const StagingModel::Array& weights = model->get("w1");
+	ASSERT_EQ(weights.rows, 3);
+	ASSERT_EQ(weights.cols, 5);
+	for (long i = 0; i != 15; ++i) {
+		EXPECT_EQ(weights.doubles()[i], w1(i / 5, i % 5));
+	}
+	EXPECT_EQ(model->get("classes").ints()[0], -4);
+	EXPECT_EQ(model->get("classes").ints()[2], 0);
+	EXPECT_THROW(model->get("classes").doubles(), std::logic_error);
+	EXPECT_THROW(model->get("w3"), std::logic_error);
+
+	std::remove(filename.c_str());
+}
+
+TEST(StagingModelTest, rejects_invalid_data) {
+	std::vector<char> buffer = StagingModelBuilder().add("w1", sequence(2, 2, 0)).serialize();
+
+	std::vector<char> wrong_magic = buffer;
+	wrong_magic[0] = 'X';
+	EXPECT_THROW(StagingModel::from_buffer(wrong_magic), std::logic_error);
+
+	std::vector<char> wrong_version = buffer;
+	wrong_version[8] = 99;
+	EXPECT_THROW(StagingModel::from_buffer(wrong_version), std::logic_error);
+
+	std::vector<char> truncated(buffer.begin(), buffer.end() - 16);
+	EXPECT_THROW(StagingModel::from_buffer(truncated), std::logic_error);
+}
+
+TEST(StagingModelTest, mlp_from_model_equals_mlp_from_matrices) {
+	std::vector<dlib::matrix<double>> weights({sequence(4, 6, 0.3), sequence(6, 3, -0.7)});
+	std::vector<dlib::matrix<double>> intercepts({sequence(6, 1, 0.1), sequence(3, 1, 0.2)});
+	std::shared_ptr<const StagingModel> model = StagingModelBuilder()
+			.add("w1", weights[0]).add("i1", intercepts[0])
+			.add("w2", weights[1]).add("i2", intercepts[1]).build();
+
+	MlpClassifier from_matrices(weights, intercepts);
+	MlpClassifier from_model(model);
+
+	dlib::matrix<double> input = sequence(10, 4, 0.9);
+	dlib::matrix<double> expected = from_matrices.predict_proba(input);
+	dlib::matrix<double> actual = from_model.predict_proba(input);
+	for (long i = 0; i != expected.nr(); ++i) {
+		for (long j = 0; j != expected.nc(); ++j) {
+			EXPECT_EQ(expected(i, j), actual(i, j));
+		}
+	}
+}
+
+TEST(StagingModelTest, registry_shares_the_online_model) {
+	std::shared_ptr<const StagingModel> first = ModelRegistry::instance().online_model();
+	std::shared_ptr<const StagingModel> second = ModelRegistry::instance().online_model();
+	EXPECT_EQ(first.get(), second.get());
+
+	EXPECT_EQ(first->layers(), 2);
+	EXPECT_EQ(first->get("w1").rows, first->feature_config(StagingModel::FEATURE_CONFIG_NUMBER_OF_FEATURES));
+	EXPECT_EQ(first->get("classes").cols, 4);
+	EXPECT_EQ(first->get("transitions").rows, 4);
+}
+
+TEST(StagingModelTest, checks_the_feature_config) {
+	const double config[StagingModel::FEATURE_CONFIG_SIZE] = {3, 20, 10 * 1024, 2048};
+	std::shared_ptr<const StagingModel> model = StagingModelBuilder()
+			.add("w1", sequence(3, 2, 0)).add("i1", sequence(2, 1, 0))
+			.add("feature_config", config, 1, StagingModel::FEATURE_CONFIG_SIZE).build();
+	EXPECT_NO_THROW(model->check_feature_config(config));
+
+	double other_window[StagingModel::FEATURE_CONFIG_SIZE] = {3, 20, 8 * 1024, 2048};
+	EXPECT_THROW(model->check_feature_config(other_window), std::logic_error);
+
+	std::shared_ptr<const StagingModel> without_config = StagingModelBuilder()
+			.add("w1", sequence(3, 2, 0)).add("i1", sequence(2, 1, 0)).build();
+	EXPECT_THROW(without_config->check_feature_config(config), std::logic_error);
+}
+
+TEST(StagingModelTest, csv_model_has_only_the_trained_feature_config) {
+	char directory_template[] = "/tmp/staging_model_testXXXXXX";
+	ASSERT_TRUE(mkdtemp(directory_template) != nullptr);
+	const std::string directory(directory_template);
+	const std::string w1 = directory + "/w1.csv";
+	const std::string i1 = directory + "/i1.csv";
+	const std::string feature_config = directory + "/feature_config.csv";
+
+	dump_matrix<double>(sequence(StagingPreprocessor::NUMBER_OF_FEATURES, 2, 0), w1);
+	dump_matrix<double>(sequence(2, 1, 0), i1);
+
+	// not checked without the configuration saved with the model
+	std::shared_ptr<const StagingModel> without_config = ModelRegistry::csv_offline_model(directory).build();
+	EXPECT_EQ(without_config->layers(), 1);
+	EXPECT_FALSE(without_config->has("feature_config"));
+
+	dlib::matrix<double> trained(1, StagingModel::FEATURE_CONFIG_SIZE);
+	for (int i = 0; i != StagingModel::FEATURE_CONFIG_SIZE; ++i) {
+		trained(0, i) = ModelRegistry::OFFLINE_FEATURE_CONFIG[i];
+	}
+	dump_matrix<double>(trained, feature_config);
+	std::shared_ptr<const StagingModel> model = ModelRegistry::csv_offline_model(directory).build();
+	EXPECT_NO_THROW(model->check_feature_config(ModelRegistry::OFFLINE_FEATURE_CONFIG));
+
+	// a model trained with another rolling window
+	trained(0, StagingModel::FEATURE_CONFIG_ROLLING_WINDOW) = 10;
+	dump_matrix<double>(trained, feature_config);
+	std::shared_ptr<const StagingModel> other = ModelRegistry::csv_offline_model(directory).build();
+	EXPECT_THROW(other->check_feature_config(ModelRegistry::OFFLINE_FEATURE_CONFIG), std::logic_error);
+
+	std::remove(w1.c_str());
+	std::remove(i1.c_str());
+	std::remove(feature_config.c_str());
+	rmdir(directory.c_str());
+}
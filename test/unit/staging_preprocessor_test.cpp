@@ -4,6 +4,10 @@
 #include <iostream>
 #include <dlib/matrix.h>
 #include <exception>
+#include <cmath>
+#include <map>
+#include <random>
+#include <string>
 
 struct StagingPreprocessorTest: public ::testing::Test {
 	virtual void SetUp() {
@@ -44,3 +48,61 @@ TEST_F(StagingPreprocessorTest, throws_when_not_aligned_test) {
 	EXPECT_THROW (features = pre.transform(eeg_signal, ir_signal), std::logic_error);
 	//std::cout << features << std::endl;
 }
+
+TEST_F(StagingPreprocessorTest, parallel_transform_equals_serial_test) {
+	int eeg_length = 1000 * 1000;
+	int ir_length = eeg_length / 5;
+	std::mt19937 generator(7);
+	std::normal_distribution<double> noise(0, 1);
+
+	dlib::matrix<double> eeg_signal(eeg_length, 1);
+	for (int i = 0; i != eeg_length; ++i) {
+		eeg_signal(i, 0) = 100 * noise(generator) + 50 * std::sin(i * 0.5);
+	}
+
+	dlib::matrix<double> ir_signal(ir_length, 1);
+	for (int i = 0; i != ir_length; ++i) {
+		ir_signal(i, 0) = noise(generator) + 5 * std::sin(i * 0.25);
+	}
+
+	StagingPreprocessor serial;
+	StagingPreprocessor parallel(4);
+	dlib::matrix<double> expected = serial.transform(eeg_signal, ir_signal);
+	dlib::matrix<double> actual = parallel.transform(eeg_signal, ir_signal);
+
+	ASSERT_EQ(expected.nr(), actual.nr());
+	ASSERT_EQ(expected.nc(), actual.nc());
+	for (int i = 0; i != expected.nr(); ++i) {
+		for (int j = 0; j != expected.nc(); ++j) {
+			if (std::isnan(expected(i, j))) {
+				EXPECT_TRUE(std::isnan(actual(i, j)));
+			} else {
+				EXPECT_EQ(expected(i, j), actual(i, j));
+			}
+		}
+	}
+
+	std::map<std::string, double> times = parallel.get_stage_times();
+	EXPECT_EQ(times.count("total"), 1);
+	EXPECT_EQ(times.count("eeg_spectrogram"), 1);
+	EXPECT_EQ(times.count("ir_features"), 1);
+	EXPECT_EQ(times.count("theta"), 1);
+}
+
+TEST_F(StagingPreprocessorTest, waits_for_the_tasks_when_throwing_test) {
+	int ir_length = 200 * 1000;
+	dlib::matrix<double> ir_signal(ir_length, 1);
+	dlib::set_all_elements(ir_signal, 1);
+
+	// not a column, so the EEG spectrogram throws while the IR branch is running
+	dlib::matrix<double> eeg_signal(5 * ir_length, 2);
+	dlib::set_all_elements(eeg_signal, 0);
+
+	StagingPreprocessor pre(2);
+	EXPECT_THROW(pre.transform(eeg_signal, ir_signal), std::logic_error);
+
+	// the IR branch has finished before the exception left transform
+	std::map<std::string, double> times = pre.get_stage_times();
+	EXPECT_EQ(times.count("ir_features"), 1);
+	EXPECT_EQ(times.count("total"), 0);
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <dlib/matrix.h>
+#include <cmath>
+#include <random>
+
+#include "StreamingEegQuality.h"
+#include "EegSignalQuality.h"
+#include "Features.h"
+#include "Spectrogram.h"
+
+namespace {
+
+const int FS = 125;
+
+}
+
+TEST(StreamingEegQualityTest, calibrated_against_eeg_signal_quality) {
+	const int EEG_WINDOW = 10 * 1024;
+
+	// white noise of the amplitudes for all the grades of EegSignalQuality
+	for (double amplitude : {15., 40., 80., 150., 300., 700., 2000., 6000.}) {
+		std::mt19937 generator(static_cast<int>(amplitude));
+		std::normal_distribution<double> noise(0, amplitude);
+
+		StreamingEegQuality streaming(FS);
+		dlib::matrix<double> signal(EEG_WINDOW, 1);
+		for (int i = 0; i != EEG_WINDOW; ++i) {
+			signal(i, 0) = noise(generator);
+			streaming.consume(signal(i, 0));
+		}
+
+		Spectrogram spectrogram(signal, FS, EEG_WINDOW);
+		double power = std::log(Features::sum_in_band(spectrogram, 10, 14)(0, 0));
+		EXPECT_NEAR(streaming.band_power(), power, 0.3) << "amplitude " << amplitude;
+
+		int expected = EegSignalQuality().predict(spectrogram);
+		EXPECT_LE(std::abs(streaming.quality() - expected), 1) << "amplitude " << amplitude;
+	}
+}
+
+TEST(StreamingEegQualityTest, no_signal_when_flat_saturated_or_missing) {
+	std::mt19937 generator(1);
+	std::normal_distribution<double> noise(0, 30);
+
+	StreamingEegQuality quality(FS);
+	EXPECT_EQ(quality.quality(), 0);
+	for (int i = 0; i != 2 * FS; ++i) {
+		quality.consume(noise(generator));
+	}
+	EXPECT_EQ(quality.quality(), 4);
+
+	// the electrode loses the contact
+	for (int i = 0; i != FS / 2; ++i) {
+		quality.consume(120);
+	}
+	EXPECT_EQ(quality.quality(), 0);
+
+	quality.reset();
+	for (int i = 0; i != 2 * FS; ++i) {
+		quality.consume(i % 10 == 0 ? 32767 : noise(generator));
+	}
+	EXPECT_EQ(quality.quality(), 0);
+
+	quality.reset();
+	for (int i = 0; i != 2 * FS; ++i) {
+		quality.consume(i % 10 == 0 ? NAN : noise(generator));
+	}
+	EXPECT_EQ(quality.quality(), 0);
+}
+
+TEST(StreamingEegQualityTest, line_noise_limits_the_quality) {
+	std::mt19937 generator(2);
+	std::normal_distribution<double> noise(0, 30);
+
+	StreamingEegQuality quality(FS);
+	for (int i = 0; i != 3 * FS; ++i) {
+		quality.consume(noise(generator) + 200 * std::sin(2 * M_PI * 50 * i / FS));
+	}
+	EXPECT_EQ(quality.quality(), 2);
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include "StreamingHeartRate.h"
+
+namespace {
+
+const double FS = 25;
+
+/*
+ * A pulse-like IR signal: a large DC component, a slow drift,
+ * the pulse with its harmonic and some noise
+ */
+class PulseSignal {
+	std::mt19937 m_generator;
+	std::normal_distribution<double> m_noise;
+	double m_phase = 0;
+	int m_index = 0;
+
+public:
+	PulseSignal() : m_generator(7), m_noise(0, 20) {}
+
+	double next(double bpm) {
+		m_phase += 2 * M_PI * bpm / 60 / FS;
+		double t = m_index++ / FS;
+		return 50000 + 300 * std::sin(2 * M_PI * 0.05 * t)
+				+ 200 * std::sin(m_phase) + 60 * std::sin(2 * m_phase + 1)
+				+ m_noise(m_generator);
+	}
+};
+
+}
+
+TEST(StreamingHeartRateTest, tracks_a_constant_heart_rate) {
+	StreamingHeartRate hr(FS);
+	PulseSignal signal;
+	EXPECT_EQ(hr.heart_rate(), 0);
+
+	for (int i = 0; i != 60 * FS; ++i) {
+		hr.consume(signal.next(67));
+	}
+	EXPECT_NEAR(hr.heart_rate(), 67, 1);
+}
+
+TEST(StreamingHeartRateTest, follows_the_changes) {
+	StreamingHeartRate hr(FS);
+	PulseSignal signal;
+
+	for (int i = 0; i != 30 * FS; ++i) {
+		hr.consume(signal.next(55));
+	}
+	EXPECT_NEAR(hr.heart_rate(), 55, 1);
+
+	for (int i = 0; i != 30 * FS; ++i) {
+		hr.consume(signal.next(93));
+	}
+	EXPECT_NEAR(hr.heart_rate(), 93, 1.5);
+}
+
+TEST(StreamingHeartRateTest, reset) {
+	StreamingHeartRate hr(FS);
+	PulseSignal signal;
+
+	for (int i = 0; i != 30 * FS; ++i) {
+		hr.consume(signal.next(80));
+	}
+	EXPECT_NEAR(hr.heart_rate(), 80, 1);
+
+	hr.reset();
+	EXPECT_EQ(hr.heart_rate(), 0);
+	for (int i = 0; i != 2 * FS; ++i) {
+		hr.consume(signal.next(80));
+	}
+	EXPECT_EQ(hr.heart_rate(), 0);
+}
@@ -0,0 +1,81 @@
+/*
+ * mlp_quantizer.cpp
+ *
+ * Quantizes the weights of an MLP model saved as w1.csv, w2.csv, i1.csv, i2.csv
+ * to int8 with per-output-channel scales. Writes w<n>_int8.csv and w<n>_scales.csv,
+ * and copies i<n>.csv (the intercepts are left in double precision), so that
+ * the output directory can be loaded with MlpClassifier::load_quantized.
+ *
+ * usage: mlp_quantizer <model directory> <output directory> [features.csv]
+ *
+ * If a features file is given, the stages predicted by the original and the
+ * quantized models are compared.
+ */
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <dlib/matrix.h>
+#include "dlib_utils.h"
+#include "MlpClassifier.h"
+#include "MlpKernels.h"
+#include "logger.h"
+
+ONCE_PER_APP_INITIALIZE_LOGGER
+
+int main(int argc, char** argv) {
+	configure_logger();
+
+	if (argc < 3) {
+		std::cout << "usage: " << argv[0] << " <model directory> <output directory> [features.csv]" << std::endl;
+		return -1;
+	}
+	std::string model_path(argv[1]);
+	std::string output_path(argv[2]);
+
+	const int LAYERS = 2;
+	std::vector<dlib::matrix<double>> weights;
+	std::vector<dlib::matrix<double>> intercepts;
+
+	for (int layer = 1; layer <= LAYERS; ++layer) {
+		std::string name = std::to_string(layer);
+		dlib::matrix<double> w = load_matrix(model_path + "/w" + name + ".csv");
+		weights.push_back(w);
+		intercepts.push_back(load_matrix(model_path + "/i" + name + ".csv"));
+
+		dlib::matrix<signed char> q(w.nr(), w.nc());
+		dlib::matrix<double> s(w.nc(), 1);
+		mlp_quantize_weights(w.begin(), w.nr(), w.nc(), q.begin(), s.begin());
+
+		double max_error = 0;
+		for (long k = 0; k != w.nr(); ++k) {
+			for (long j = 0; j != w.nc(); ++j) {
+				max_error = std::max(max_error, std::abs(w(k, j) - q(k, j) * s(j, 0)));
+			}
+		}
+		std::cout << "layer " << layer << ": " << w.nr() << "x" << w.nc()
+				  << ", max weight error: " << max_error << std::endl;
+
+		dump_matrix<int>(dlib::matrix_cast<int>(q), output_path + "/w" + name + "_int8.csv");
+		dump_matrix<double>(s, output_path + "/w" + name + "_scales.csv");
+		dump_matrix<double>(intercepts.back(), output_path + "/i" + name + ".csv");
+	}
+
+	if (argc > 3) {
+		dlib::matrix<double> features = load_matrix(argv[3]);
+		MlpClassifier original(weights, intercepts);
+		// as loaded by the library, i.e. with the scales as written
+		std::unique_ptr<MlpClassifier> quantized = MlpClassifier::load_quantized(output_path);
+
+		dlib::matrix<int> expected = original.predict(features);
+		dlib::matrix<int> actual = quantized->predict(features);
+		long agreeing = 0;
+		for (long i = 0; i != expected.nr(); ++i) {
+			agreeing += expected(i, 0) == actual(i, 0);
+		}
+		std::cout << "stage agreement: " << agreeing << " / " << expected.nr()
+				  << " (" << 100. * agreeing / expected.nr() << "%)" << std::endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,63 @@
+/*
+ * model_converter.cpp
+ *
+ * Converts the staging models to the binary model format (see StagingModel.h).
+ *
+ * usage:
+ *   model_converter online <output.bin>                 - the model compiled into the library
+ *   model_converter offline <csv directory> <output.bin> - w<n>.csv/i<n>.csv files
+ *   model_converter show <model.bin>                     - lists the sections of a model
+ */
+#include <iostream>
+#include <string>
+#include "ModelRegistry.h"
+#include "StagingModel.h"
+#include "logger.h"
+
+ONCE_PER_APP_INITIALIZE_LOGGER
+
+namespace {
+
+int usage(const char* program) {
+	std::cout << "usage: " << program << " online <output.bin>" << std::endl
+			  << "       " << program << " offline <csv directory> <output.bin>" << std::endl
+			  << "       " << program << " show <model.bin>" << std::endl;
+	return -1;
+}
+
+void show(const StagingModel &model) {
+	const char* SECTIONS[] = {"w1", "i1", "w2", "i2", "w3", "i3", "transitions", "classes", "feature_config"};
+	for (const char* name : SECTIONS) {
+		if (model.has(name)) {
+			const StagingModel::Array& array = model.get(name);
+			std::cout << name << ": " << array.rows << "x" << array.cols
+					  << (array.type == StagingModel::ArrayType::DOUBLE ? " double" : " int32") << std::endl;
+		}
+	}
+}
+
+}
+
+int main(int argc, char** argv) {
+	configure_logger();
+
+	if (argc < 3) {
+		return usage(argv[0]);
+	}
+	std::string command(argv[1]);
+
+	if (command == "online") {
+		StagingModelBuilder builder = ModelRegistry::builtin_online_model();
+		builder.write(argv[2]);
+		show(*StagingModel::load(argv[2]));
+	} else if (command == "offline" && argc > 3) {
+		StagingModelBuilder builder = ModelRegistry::csv_offline_model(argv[2]);
+		builder.write(argv[3]);
+		show(*StagingModel::load(argv[3]));
+	} else if (command == "show") {
+		show(*StagingModel::load(argv[2]));
+	} else {
+		return usage(argv[0]);
+	}
+	return 0;
+}
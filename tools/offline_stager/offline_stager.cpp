@@ -4,6 +4,8 @@
 #include "dlib_utils.h"
 #include "OfflineStagingClassifier.h"
 #include "StagingPreprocessor.h"
+#include "ThreadPool.h"
+#include "ExecutionTime.h"
 #include "logger.h"
 
 ONCE_PER_APP_INITIALIZE_LOGGER
@@ -20,15 +22,30 @@ int main(int argc, char** argv) {
 	dlib::matrix<double> ir = load_matrix(ir_filename);
 	ir = dlib::colm(ir, 1);
 
-	StagingPreprocessor pre;
+	StagingPreprocessor pre(ThreadPool::hardware_threads());
 	const Spectrogram eeg_spectrum = pre.get_eeg_spectrogram(eeg);
 	const Spectrogram ir_spectrum = pre.get_ir_spectrogram(ir);
-	dlib::matrix<double> features = pre.transform(eeg, ir);
+	dlib::matrix<double> features = pre.transform(eeg_spectrum, ir_spectrum);
+
+	for (const auto &stage : pre.get_stage_times()) {
+		std::cout << "stage " << stage.first << ": " << stage.second << " ms" << std::endl;
+	}
 
 	OfflineStagingClassifier* clf = OfflineStagingClassifier::get_instance();
+	ExecutionTimer classification_timer;
 	dlib::matrix<int> stages = clf->predict(features);
+	double classification_ms = classification_timer.elapsed_ms();
+	std::cout << "classification: " << features.nr() << " epochs in " << classification_ms << " ms ("
+			  << features.nr() / (classification_ms / 1000) << " epochs/s)" << std::endl;
+
+	ExecutionTimer smoothing_timer;
+	dlib::matrix<int> smoothed_stages = clf->predict_smoothed(features);
+	dlib::matrix<double> posteriors = clf->predict_posteriors(features);
+	std::cout << "smoothing: " << smoothing_timer.elapsed_ms() << " ms" << std::endl;
 
 	dump_matrix<int>(stages, output_path + "/" + "staging.csv");
+	dump_matrix<int>(smoothed_stages, output_path + "/" + "staging_smoothed.csv");
+	dump_matrix<double>(posteriors, output_path + "/" + "posteriors.csv");
 	dump_matrix<double>(eeg_spectrum.data(), output_path + "/" + "eeg.csv");
 	dump_matrix<double>(ir_spectrum.data(), output_path + "/" + "ir.csv");
 	dump_matrix<double>(features, output_path + "/" + "features.csv");